@@ -0,0 +1,79 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <bier/analysis/analysis_manager.h>
+
+namespace bier {
+
+void AnalysisManager::OnPassStarted(const Module* module) {
+    versions_before_pass_.clear();
+    for (const auto& [signature, function] : module->GetDefinedFunctions()) {
+        if (ContainerHas(function_results_, function.get())) {
+            versions_before_pass_[function.get()] = function->GetVersion();
+        }
+    }
+}
+
+void AnalysisManager::OnPassFinished(const Module* module, const PreservedAnalyses& preserved) {
+    for (const auto& [signature, function] : module->GetDefinedFunctions()) {
+        auto before = versions_before_pass_.find(function.get());
+        if (before == versions_before_pass_.end() || before->second == function->GetVersion()) {
+            continue;
+        }
+        for (auto& [analysis, entry] : function_results_[function.get()]) {
+            if (entry.version == before->second && preserved.IsPreserved(analysis)) {
+                entry.version = function->GetVersion();
+            }
+        }
+    }
+    versions_before_pass_.clear();
+
+    ++epoch_;
+    if (preserved.AreAllPreserved()) {
+        return;
+    }
+    for (const auto& analysis : known_analyses_) {
+        if (!preserved.IsPreserved(analysis)) {
+            last_clobbered_[analysis] = epoch_;
+        }
+    }
+}
+
+void AnalysisManager::Invalidate(const Function* function) {
+    function_results_.erase(function);
+    versions_before_pass_.erase(function);
+}
+
+void AnalysisManager::Clear() {
+    function_results_.clear();
+    module_results_.clear();
+    known_analyses_.clear();
+    last_clobbered_.clear();
+    versions_before_pass_.clear();
+}
+
+AnalysisManager::Entry& AnalysisManager::FindEntry(const Function* function,
+                                                   std::type_index analysis) {
+    std::lock_guard lock(mutex_);
+    known_analyses_.insert(analysis);
+    return function_results_[function][analysis];
+}
+
+bool AnalysisManager::IsClobbered(std::type_index analysis, const Entry& entry) const {
+    auto clobbered = last_clobbered_.find(analysis);
+    return clobbered != last_clobbered_.end() && clobbered->second > entry.epoch;
+}
+
+}  // namespace bier
@@ -0,0 +1,161 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+
+#include <bier/core/module.h>
+#include <atomic>
+#include <mutex>
+#include <type_traits>
+#include <typeindex>
+
+namespace bier {
+
+// Analyses a pass keeps valid in the functions it changes
+class PreservedAnalyses {
+public:
+    static PreservedAnalyses All() {
+        PreservedAnalyses preserved;
+        preserved.all_ = true;
+        return preserved;
+    }
+    static PreservedAnalyses None() {
+        return PreservedAnalyses();
+    }
+
+    template <typename TAnalysis>
+    PreservedAnalyses& Preserve() {
+        preserved_.insert(std::type_index(typeid(TAnalysis)));
+        return *this;
+    }
+
+    bool AreAllPreserved() const {
+        return all_;
+    }
+    bool IsPreserved(std::type_index analysis) const {
+        return all_ || ContainerHas(preserved_, analysis);
+    }
+    template <typename TAnalysis>
+    bool IsPreserved() const {
+        return IsPreserved(std::type_index(typeid(TAnalysis)));
+    }
+
+private:
+    bool all_ = false;
+    StdHashSet<std::type_index> preserved_;
+};
+
+// Caches analysis results per function and per module, keyed by analysis type. A function
+// analysis is constructed from const Function* and, if it depends on other analyses, this
+// manager. A module analysis is constructed from const Module*.
+//
+// Invalidation is lazy. A function result stays valid while the function version is unchanged.
+// When a pass changing the function finishes, the results it preserves are moved to the new
+// version, provided they were valid when the pass started. Nothing moves results past edits
+// made outside of passes, so those always invalidate. Module results survive passes preserving
+// them.
+//
+// Results of different functions may be requested from different threads, as function passes
+// do. Results of one function must not be requested concurrently.
+class AnalysisManager {
+public:
+    template <typename TAnalysis>
+    std::shared_ptr<const TAnalysis> GetResult(const Function* function) {
+        Entry& entry = FindEntry(function, std::type_index(typeid(TAnalysis)));
+        if (!IsValid(entry, function->GetVersion())) {
+            if constexpr (std::is_constructible_v<TAnalysis, const Function*, AnalysisManager*>) {
+                entry.result = std::make_shared<const TAnalysis>(function, this);
+            } else {
+                entry.result = std::make_shared<const TAnalysis>(function);
+            }
+            entry.version = function->GetVersion();
+            computed_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return std::static_pointer_cast<const TAnalysis>(entry.result);
+    }
+
+    // nullptr unless a valid result is cached
+    template <typename TAnalysis>
+    std::shared_ptr<const TAnalysis> GetCachedResult(const Function* function) {
+        std::lock_guard lock(mutex_);
+        auto results = function_results_.find(function);
+        if (results == function_results_.end()) {
+            return nullptr;
+        }
+        auto entry = results->second.find(std::type_index(typeid(TAnalysis)));
+        if (entry == results->second.end() || !IsValid(entry->second, function->GetVersion())) {
+            return nullptr;
+        }
+        return std::static_pointer_cast<const TAnalysis>(entry->second.result);
+    }
+
+    template <typename TAnalysis>
+    std::shared_ptr<const TAnalysis> GetModuleResult(const Module* module) {
+        auto& entry = module_results_[module][std::type_index(typeid(TAnalysis))];
+        if (entry.result == nullptr || IsClobbered(std::type_index(typeid(TAnalysis)), entry)) {
+            entry.result = std::make_shared<const TAnalysis>(module);
+            known_analyses_.insert(std::type_index(typeid(TAnalysis)));
+            computed_.fetch_add(1, std::memory_order_relaxed);
+        }
+        entry.epoch = epoch_;
+        return std::static_pointer_cast<const TAnalysis>(entry.result);
+    }
+
+    // To be called around every pass run over the module with the results cached in this
+    // manager
+    void OnPassStarted(const Module* module);
+    void OnPassFinished(const Module* module, const PreservedAnalyses& preserved);
+
+    // Drops every result of the function, e.g. before it is destroyed
+    void Invalidate(const Function* function);
+    void Clear();
+
+    // Number of analysis results computed so far
+    std::size_t GetComputedCount() const {
+        return computed_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Entry {
+        std::shared_ptr<const void> result;
+        // Function version the result is valid at
+        std::uint64_t version = 0;
+        // Pass epoch of the last validation of a module result
+        std::uint64_t epoch = 0;
+    };
+    using Results = StdHashMap<std::type_index, Entry>;
+
+    StdHashMap<const Function*, Results> function_results_;
+    StdHashMap<const Module*, Results> module_results_;
+    // Versions of the functions with results when the running pass started
+    StdHashMap<const Function*, std::uint64_t> versions_before_pass_;
+    StdHashSet<std::type_index> known_analyses_;
+    // Latest pass epoch not preserving an analysis
+    StdHashMap<std::type_index, std::uint64_t> last_clobbered_;
+    std::uint64_t epoch_ = 0;
+    std::atomic<std::size_t> computed_{0};
+    // Guards the maps, not the entries: only the thread working on a function touches its ones
+    std::mutex mutex_;
+
+    // References to entries stay valid while other functions get results
+    Entry& FindEntry(const Function* function, std::type_index analysis);
+
+    bool IsClobbered(std::type_index analysis, const Entry& entry) const;
+    static bool IsValid(const Entry& entry, std::uint64_t version) {
+        return entry.result != nullptr && entry.version == version;
+    }
+};
+
+}  // namespace bier
@@ -0,0 +1,108 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <bier/analysis/available_expressions.h>
+
+#include <bier/operations/opcodes.h>
+#include <boost/functional/hash.hpp>
+
+namespace bier {
+
+namespace {
+
+bool IsExpression(const Operation* op) {
+    return op->OpCode() < OpCodes::STORE_OP;
+}
+
+struct ExpressionKey {
+    struct Hash {
+        HashType operator()(const ExpressionKey& key) const {
+            HashType hash = 0;
+            boost::hash_combine(hash, key.opcode);
+            boost::hash_combine(hash, key.left);
+            boost::hash_combine(hash, key.right);
+            return hash;
+        }
+    };
+
+    bool operator==(const ExpressionKey& other) const {
+        return opcode == other.opcode && left == other.left && right == other.right;
+    }
+
+    int opcode;
+    const Value* left;
+    const Value* right;
+};
+
+}  // namespace
+
+AvailableExpressionsProblem::AvailableExpressionsProblem(const Function* function)
+    : GenKillProblem(function, 0) {
+    HashMap<ExpressionKey, std::uint32_t> expressions;
+    std::vector<std::vector<std::uint32_t>> users(function->ValueIndexBound());
+    for (const BasicBlock* block : function->GetBlocks()) {
+        for (const Operation* op : block->GetOperations()) {
+            if (!IsExpression(op)) {
+                continue;
+            }
+            const auto* binary = static_cast<const BinaryOperation*>(op);
+            const ExpressionKey key{op->OpCode(), binary->LeftValue(), binary->RightValue()};
+            auto [it, inserted] = expressions.emplace(key, expressions.size());
+            expression_of_.Insert(op, it->second);
+            if (!inserted) {
+                continue;
+            }
+            for (const Value* operand : op->GetArguments()) {
+                if (operand->GetIndex() != kNoDenseIndex) {
+                    users[operand->GetIndex()].push_back(it->second);
+                }
+            }
+        }
+    }
+
+    universe_ = expressions.size();
+    gen_.assign(function->BlockIndexBound(), DenseBitVector(universe_));
+    kill_.assign(function->BlockIndexBound(), DenseBitVector(universe_));
+    for (const BasicBlock* block : function->GetBlocks()) {
+        auto& gen = gen_[block->GetIndex()];
+        auto& kill = kill_[block->GetIndex()];
+        for (const Operation* op : block->GetOperations()) {
+            if (IsExpression(op)) {
+                gen.Set(expression_of_.At(op));
+            }
+            if (auto result = op->GetReturnValue()) {
+                for (auto expression : users[result.value()->GetIndex()]) {
+                    gen.Reset(expression);
+                    kill.Set(expression);
+                }
+            }
+        }
+    }
+}
+
+std::uint32_t AvailableExpressionsProblem::GetExpression(const Operation* op) const {
+    return expression_of_.Has(op) ? expression_of_.At(op) : kNoDenseIndex;
+}
+
+AvailableExpressions::AvailableExpressions(const Function* function)
+    : solver_(function, AvailableExpressionsProblem(function)) {
+}
+
+bool AvailableExpressions::IsAvailable(const Operation* op, const BasicBlock* block) const {
+    const auto expression = solver_.GetProblem().GetExpression(op);
+    return expression != kNoDenseIndex && GetAvailableIn(block).Test(expression);
+}
+
+}  // namespace bier
@@ -0,0 +1,52 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+
+#include <bier/analysis/dataflow.h>
+
+namespace bier {
+
+// Binary expressions computed on every path to block boundaries, STORE excluded. An expression
+// is identified by its operator and operands, redefining an operand kills it.
+class AvailableExpressionsProblem : public GenKillProblem<DataflowDirection::FORWARD, true> {
+public:
+    explicit AvailableExpressionsProblem(const Function* function);
+
+    // kNoDenseIndex for operations that do not compute an expression
+    std::uint32_t GetExpression(const Operation* op) const;
+
+private:
+    DenseOperationMap<std::uint32_t> expression_of_;
+};
+
+class AvailableExpressions {
+public:
+    explicit AvailableExpressions(const Function* function);
+
+    const DenseBitVector& GetAvailableIn(const BasicBlock* block) const {
+        return solver_.GetBlockEntry(block);
+    }
+    const DenseBitVector& GetAvailableOut(const BasicBlock* block) const {
+        return solver_.GetBlockExit(block);
+    }
+    // Whether the expression op computes is available at the start of block
+    bool IsAvailable(const Operation* op, const BasicBlock* block) const;
+
+private:
+    DataflowSolver<AvailableExpressionsProblem> solver_;
+};
+
+}  // namespace bier
@@ -0,0 +1,48 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <bier/analysis/block_order.h>
+
+#include <algorithm>
+
+namespace bier {
+
+std::vector<const BasicBlock*> ReversePostOrder(const Function* function) {
+    std::vector<const BasicBlock*> order;
+    if (function->GetBlocks().Size() == 0) {
+        return order;
+    }
+    DenseBlockSet visited;
+    std::vector<std::pair<const BasicBlock*, std::size_t>> stack;
+    stack.emplace_back(function->GetEntryBlock(), 0);
+    visited.Insert(function->GetEntryBlock());
+    while (!stack.empty()) {
+        auto& [block, next_successor] = stack.back();
+        if (next_successor == block->Successors().size()) {
+            order.push_back(block);
+            stack.pop_back();
+            continue;
+        }
+        const BasicBlock* successor = block->Successors()[next_successor++];
+        if (!visited.Has(successor)) {
+            visited.Insert(successor);
+            stack.emplace_back(successor, 0);
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+}  // namespace bier
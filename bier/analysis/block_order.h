@@ -0,0 +1,26 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+
+#include <bier/core/function.h>
+#include <vector>
+
+namespace bier {
+
+// Blocks reachable from the entry, each one before its successors unless along a back edge
+std::vector<const BasicBlock*> ReversePostOrder(const Function* function);
+
+}  // namespace bier
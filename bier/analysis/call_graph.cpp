@@ -0,0 +1,116 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <bier/analysis/call_graph.h>
+
+#include <bier/operations/call.h>
+#include <bier/utils/casting.h>
+#include <algorithm>
+
+namespace bier {
+
+CallGraph::CallGraph(const Module* module) {
+    std::vector<const Function*> functions;
+    for (const auto& [signature, function] : module->GetDefinedFunctions()) {
+        functions.push_back(function.get());
+        nodes_[function.get()];
+    }
+    for (const Function* function : functions) {
+        auto& callees = nodes_[function].callees;
+        for (const BasicBlock* block : function->GetBlocks()) {
+            for (const Operation* op : block->GetOperations()) {
+                if (op->OpCode() != OpCodes::CALL_OP) {
+                    continue;
+                }
+                const auto* callee =
+                    dyn_cast<Function>(static_cast<const CallOp*>(op)->Callee());
+                if (callee == nullptr || !ContainerHas(nodes_, callee) ||
+                    std::find(callees.begin(), callees.end(), callee) != callees.end()) {
+                    continue;
+                }
+                callees.push_back(callee);
+                nodes_[callee].callers.push_back(function);
+            }
+        }
+    }
+    FindComponents(functions);
+}
+
+bool CallGraph::IsRecursive(const Function* function) const {
+    const Node& node = GetNode(function);
+    if (components_[node.component].size() > 1) {
+        return true;
+    }
+    return std::find(node.callees.begin(), node.callees.end(), function) != node.callees.end();
+}
+
+// Tarjan's algorithm completes components in reverse topological order, callees first
+void CallGraph::FindComponents(const std::vector<const Function*>& functions) {
+    StdHashMap<const Function*, std::size_t> number;
+    StdHashMap<const Function*, std::size_t> low_link;
+    StdHashMap<const Function*, bool> on_stack;
+    std::vector<const Function*> stack;
+    // Function and the index of its next callee to visit
+    std::vector<std::pair<const Function*, std::size_t>> path;
+    std::size_t counter = 0;
+
+    auto enter = [&](const Function* function) {
+        number[function] = low_link[function] = counter++;
+        stack.push_back(function);
+        on_stack[function] = true;
+        path.emplace_back(function, 0);
+    };
+
+    for (const Function* root : functions) {
+        if (ContainerHas(number, root)) {
+            continue;
+        }
+        enter(root);
+        while (!path.empty()) {
+            auto& [function, next] = path.back();
+            const auto& callees = nodes_[function].callees;
+            if (next < callees.size()) {
+                const Function* callee = callees[next++];
+                if (!ContainerHas(number, callee)) {
+                    enter(callee);
+                } else if (on_stack[callee]) {
+                    low_link[function] = std::min(low_link[function], number[callee]);
+                }
+                continue;
+            }
+            const Function* finished = function;
+            path.pop_back();
+            if (!path.empty()) {
+                const Function* parent = path.back().first;
+                low_link[parent] = std::min(low_link[parent], low_link[finished]);
+            }
+            if (low_link[finished] != number[finished]) {
+                continue;
+            }
+            std::vector<const Function*> component;
+            const Function* member = nullptr;
+            do {
+                member = stack.back();
+                stack.pop_back();
+                on_stack[member] = false;
+                nodes_[member].component = components_.size();
+                component.push_back(member);
+            } while (member != finished);
+            components_.push_back(std::move(component));
+        }
+    }
+}
+
+}  // namespace bier
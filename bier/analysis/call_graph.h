@@ -0,0 +1,64 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+
+#include <bier/core/module.h>
+#include <vector>
+
+namespace bier {
+
+// Direct calls between the defined functions of a module. Calls through pointers and calls of
+// external functions add no edges.
+class CallGraph {
+public:
+    explicit CallGraph(const Module* module);
+
+    // Every function is listed once, in the order of the first call
+    const std::vector<const Function*>& GetCallees(const Function* function) const {
+        return GetNode(function).callees;
+    }
+    const std::vector<const Function*>& GetCallers(const Function* function) const {
+        return GetNode(function).callers;
+    }
+    // Strongly connected components, each one after all the components it calls
+    const std::vector<std::vector<const Function*>>& GetBottomUpOrder() const {
+        return components_;
+    }
+    bool InSameComponent(const Function* a, const Function* b) const {
+        return GetNode(a).component == GetNode(b).component;
+    }
+    // Whether the function may call itself, directly or through other functions
+    bool IsRecursive(const Function* function) const;
+
+private:
+    struct Node {
+        std::vector<const Function*> callees;
+        std::vector<const Function*> callers;
+        std::size_t component = 0;
+    };
+
+    StdHashMap<const Function*, Node> nodes_;
+    std::vector<std::vector<const Function*>> components_;
+
+    const Node& GetNode(const Function* function) const {
+        auto it = nodes_.find(function);
+        assert(it != nodes_.end());
+        return it->second;
+    }
+    void FindComponents(const std::vector<const Function*>& functions);
+};
+
+}  // namespace bier
@@ -0,0 +1,131 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <bier/analysis/constant_folding.h>
+
+#include <bier/operations/opcodes.h>
+#include <bier/utils/casting.h>
+
+namespace bier {
+
+namespace {
+
+std::uint64_t Truncate(std::uint64_t value, unsigned int bits) {
+    return bits >= 64 ? value : value & ((1ull << bits) - 1ull);
+}
+
+std::int64_t SignExtend(std::uint64_t value, unsigned int bits) {
+    if (bits >= 64) {
+        return static_cast<std::int64_t>(value);
+    }
+    const std::uint64_t sign = 1ull << (bits - 1);
+    return static_cast<std::int64_t>((Truncate(value, bits) ^ sign) - sign);
+}
+
+}  // namespace
+
+const IntegerConst* ConstantFolder::Fold(const Operation* op) const {
+    auto result = op->GetReturnValue();
+    if (!result.has_value()) {
+        return nullptr;
+    }
+    auto arguments = op->GetArguments();
+    if (op->OpCode() < OpCodes::STORE_OP) {
+        return FoldBinary(op->OpCode(), dyn_cast<IntegerConst>(arguments[0]),
+                          dyn_cast<IntegerConst>(arguments[1]), result.value()->GetType());
+    }
+    if (op->OpCode() == OpCodes::CAST_OP) {
+        return FoldCast(dyn_cast<IntegerConst>(arguments[0]), result.value()->GetType());
+    }
+    return nullptr;
+}
+
+const IntegerConst* ConstantFolder::FoldBinary(int opcode, const IntegerConst* left,
+                                               const IntegerConst* right,
+                                               const Type* result_type) const {
+    const auto* type = dyn_cast<IntTypeBase>(result_type);
+    if (left == nullptr || right == nullptr || type == nullptr ||
+        left->IntType() != right->IntType()) {
+        return nullptr;
+    }
+    const unsigned int bits = left->IntType()->GetNBits();
+    const std::uint64_t a = left->GetValue();
+    const std::uint64_t b = right->GetValue();
+    const std::int64_t signed_a = SignExtend(a, bits);
+    const std::int64_t signed_b = SignExtend(b, bits);
+    const std::int64_t signed_min = SignExtend(1ull << (bits - 1), bits);
+    const bool signed_overflow = signed_a == signed_min && signed_b == -1;
+
+    std::uint64_t value = 0;
+    switch (opcode) {
+        case OpCodes::ADD_OP:
+            value = a + b;
+            break;
+        case OpCodes::SUB_OP:
+            value = a - b;
+            break;
+        case OpCodes::MULT_OP:
+            value = a * b;
+            break;
+        case OpCodes::UDIV_OP:
+        case OpCodes::UREM_OP:
+            if (b == 0) {
+                return nullptr;
+            }
+            value = opcode == OpCodes::UDIV_OP ? a / b : a % b;
+            break;
+        case OpCodes::SDIV_OP:
+        case OpCodes::SREM_OP:
+            if (signed_b == 0 || signed_overflow) {
+                return nullptr;
+            }
+            value = static_cast<std::uint64_t>(opcode == OpCodes::SDIV_OP ? signed_a / signed_b
+                                                                          : signed_a % signed_b);
+            break;
+        case OpCodes::EQ_OP:
+            value = a == b;
+            break;
+        case OpCodes::NE_OP:
+            value = a != b;
+            break;
+        case OpCodes::LE_OP:
+            value = signed_a <= signed_b;
+            break;
+        case OpCodes::LT_OP:
+            value = signed_a < signed_b;
+            break;
+        case OpCodes::GE_OP:
+            value = signed_a >= signed_b;
+            break;
+        case OpCodes::GT_OP:
+            value = signed_a > signed_b;
+            break;
+        default:
+            return nullptr;
+    }
+    return constants_->GetInteger(Truncate(value, type->GetNBits()), type);
+}
+
+const IntegerConst* ConstantFolder::FoldCast(const IntegerConst* value, const Type* type) const {
+    const auto* int_type = dyn_cast<IntTypeBase>(type);
+    if (value == nullptr || int_type == nullptr) {
+        return nullptr;
+    }
+    const std::int64_t extended = SignExtend(value->GetValue(), value->IntType()->GetNBits());
+    return constants_->GetInteger(
+        Truncate(static_cast<std::uint64_t>(extended), int_type->GetNBits()), int_type);
+}
+
+}  // namespace bier
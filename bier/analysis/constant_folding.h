@@ -0,0 +1,44 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+
+#include <bier/core/constant_pool.h>
+#include <bier/core/operation.h>
+
+namespace bier {
+
+// Evaluates operations over integer constants the way the LLVM lowering does: arithmetic wraps
+// around the bit width of the type, comparisons are signed and casts between integer types
+// sign extend or truncate. Results are nullptr for what cannot be evaluated, e.g. operands
+// which are not integer constants, division by zero or the signed overflow of a division.
+class ConstantFolder {
+public:
+    explicit ConstantFolder(ConstantPool* constants) : constants_(constants) {
+        assert(constants_ != nullptr);
+    }
+
+    // Folds a binary operator or a cast, the result has the type of the result of op
+    const IntegerConst* Fold(const Operation* op) const;
+
+    const IntegerConst* FoldBinary(int opcode, const IntegerConst* left,
+                                   const IntegerConst* right, const Type* result_type) const;
+    const IntegerConst* FoldCast(const IntegerConst* value, const Type* type) const;
+
+private:
+    ConstantPool* constants_ = nullptr;
+};
+
+}  // namespace bier
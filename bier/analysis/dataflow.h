@@ -0,0 +1,168 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+
+#include <bier/analysis/block_order.h>
+#include <bier/utils/bit_vector.h>
+#include <algorithm>
+
+namespace bier {
+
+enum class DataflowDirection { FORWARD, BACKWARD };
+
+// Worklist solver of a dataflow problem over the CFG of a function. Blocks are visited in
+// reverse postorder of the analysis direction, the worklist picks the earliest pending one.
+// TProblem provides:
+//   using Domain; static constexpr DataflowDirection kDirection;
+//   Domain Top() const - starting value of block results
+//   void Initialize(const BasicBlock* block, Domain* value) const - value before the meet over
+//       incoming edges: the boundary condition or the identity of Meet
+//   void Meet(Domain* into, const Domain& value) const
+//   bool Transfer(const BasicBlock* block, const Domain& in, Domain* out) const - returns
+//       whether out changed
+template <typename TProblem>
+class DataflowSolver {
+public:
+    using Domain = typename TProblem::Domain;
+    static constexpr bool kForward = TProblem::kDirection == DataflowDirection::FORWARD;
+
+    DataflowSolver(const Function* function, TProblem problem);
+
+    const TProblem& GetProblem() const {
+        return problem_;
+    }
+    // Values at the start and the end of a block in program order
+    const Domain& GetBlockEntry(const BasicBlock* block) const {
+        return kForward ? in_[block->GetIndex()] : out_[block->GetIndex()];
+    }
+    const Domain& GetBlockExit(const BasicBlock* block) const {
+        return kForward ? out_[block->GetIndex()] : in_[block->GetIndex()];
+    }
+    // Number of transfer function applications it took to converge
+    std::size_t GetVisits() const {
+        return visits_;
+    }
+
+private:
+    TProblem problem_;
+    // In and out follow the analysis direction
+    std::vector<Domain> in_;
+    std::vector<Domain> out_;
+    std::size_t visits_ = 0;
+};
+
+// Bitvector problem with out = gen | (in & ~kill), meet is union or intersection. The
+// boundary value is empty and starts at the entry block or at blocks without successors.
+template <DataflowDirection IDirection, bool IIntersect>
+class GenKillProblem {
+public:
+    using Domain = DenseBitVector;
+    static constexpr DataflowDirection kDirection = IDirection;
+
+    GenKillProblem(const Function* function, std::size_t universe)
+        : function_(function),
+          universe_(universe),
+          gen_(function->BlockIndexBound(), DenseBitVector(universe)),
+          kill_(function->BlockIndexBound(), DenseBitVector(universe)) {
+    }
+
+    std::size_t Universe() const {
+        return universe_;
+    }
+
+    Domain Top() const {
+        return DenseBitVector(universe_, IIntersect);
+    }
+    void Initialize(const BasicBlock* block, Domain* value) const {
+        const bool boundary = IDirection == DataflowDirection::FORWARD
+                                  ? block == function_->GetEntryBlock()
+                                  : block->Successors().empty();
+        if (IIntersect && !boundary) {
+            value->SetAll();
+        } else {
+            value->ResetAll();
+        }
+    }
+    void Meet(Domain* into, const Domain& value) const {
+        if (IIntersect) {
+            into->IntersectWith(value);
+        } else {
+            into->UnionWith(value);
+        }
+    }
+    bool Transfer(const BasicBlock* block, const Domain& in, Domain* out) const {
+        return out->AssignTransfer(gen_[block->GetIndex()], in, kill_[block->GetIndex()]);
+    }
+
+protected:
+    const Function* function_;
+    std::size_t universe_;
+    std::vector<DenseBitVector> gen_;
+    std::vector<DenseBitVector> kill_;
+};
+
+template <typename TProblem>
+DataflowSolver<TProblem>::DataflowSolver(const Function* function, TProblem problem)
+    : problem_(std::move(problem)),
+      in_(function->BlockIndexBound(), problem_.Top()),
+      out_(function->BlockIndexBound(), problem_.Top()) {
+    // Unreachable blocks go last, they still get a solution
+    std::vector<const BasicBlock*> order = ReversePostOrder(function);
+    DenseBlockSet ordered;
+    for (const BasicBlock* block : order) {
+        ordered.Insert(block);
+    }
+    for (const BasicBlock* block : function->GetBlocks()) {
+        if (!ordered.Has(block)) {
+            order.push_back(block);
+        }
+    }
+    if (!kForward) {
+        std::reverse(order.begin(), order.end());
+    }
+    std::vector<std::uint32_t> position(function->BlockIndexBound(), kNoDenseIndex);
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        position[order[i]->GetIndex()] = i;
+    }
+
+    DenseBitVector pending(order.size(), true);
+    std::size_t next = 0;
+    while (true) {
+        next = pending.FindNext(next);
+        if (next == DenseBitVector::kNoBit) {
+            next = pending.FindNext(0);
+            if (next == DenseBitVector::kNoBit) {
+                break;
+            }
+        }
+        pending.Reset(next);
+        const BasicBlock* block = order[next];
+        const auto index = block->GetIndex();
+        problem_.Initialize(block, &in_[index]);
+        for (const BasicBlock* incoming : kForward ? block->Predecessors() : block->Successors()) {
+            problem_.Meet(&in_[index], out_[incoming->GetIndex()]);
+        }
+        ++visits_;
+        if (problem_.Transfer(block, in_[index], &out_[index])) {
+            for (const BasicBlock* outgoing :
+                 kForward ? block->Successors() : block->Predecessors()) {
+                pending.Set(position[outgoing->GetIndex()]);
+            }
+        }
+    }
+}
+
+}  // namespace bier
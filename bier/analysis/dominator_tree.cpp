@@ -0,0 +1,346 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <bier/analysis/dominator_tree.h>
+
+namespace bier {
+
+template <bool IsPostDom>
+DominatorTreeBase<IsPostDom>::DominatorTreeBase(const Function* function) : function_(function) {
+    Recalculate();
+}
+
+template <bool IsPostDom>
+void DominatorTreeBase<IsPostDom>::Recalculate() {
+    const std::size_t size = function_->BlockIndexBound() + 1;
+    blocks_.assign(size, nullptr);
+    idom_.assign(size, kNone);
+    level_.assign(size, 0);
+    children_.assign(size, {});
+    po_number_.assign(size, kNone);
+    root_successors_.clear();
+    for (const BasicBlock* block : function_->GetBlocks()) {
+        blocks_[Node(block)] = block;
+        if (IsExit(block)) {
+            root_successors_.push_back(Node(block));
+        }
+    }
+    idom_[kRoot] = kRoot;
+    Recompute(kRoot);
+}
+
+template <bool IsPostDom>
+bool DominatorTreeBase<IsPostDom>::IsReachable(const BasicBlock* block) const {
+    return IsReachableNode(Node(block));
+}
+
+template <bool IsPostDom>
+const BasicBlock* DominatorTreeBase<IsPostDom>::GetIDom(const BasicBlock* block) const {
+    const auto node = Node(block);
+    if (!IsReachableNode(node)) {
+        return nullptr;
+    }
+    return blocks_[idom_[node]];
+}
+
+template <bool IsPostDom>
+std::vector<const BasicBlock*> DominatorTreeBase<IsPostDom>::GetChildren(
+    const BasicBlock* block) const {
+    std::vector<const BasicBlock*> children;
+    const auto node = Node(block);
+    if (IsReachableNode(node)) {
+        for (auto child : children_[node]) {
+            children.push_back(blocks_[child]);
+        }
+    }
+    return children;
+}
+
+template <bool IsPostDom>
+std::vector<const BasicBlock*> DominatorTreeBase<IsPostDom>::GetRoots() const {
+    std::vector<const BasicBlock*> roots;
+    for (auto child : children_[kRoot]) {
+        roots.push_back(blocks_[child]);
+    }
+    return roots;
+}
+
+template <bool IsPostDom>
+bool DominatorTreeBase<IsPostDom>::Dominates(const BasicBlock* a, const BasicBlock* b) const {
+    if (a == b) {
+        return true;
+    }
+    auto node_a = Node(a);
+    auto node_b = Node(b);
+    if (!IsReachableNode(node_a) || !IsReachableNode(node_b)) {
+        return false;
+    }
+    if (!dfs_valid_.load(std::memory_order_acquire) &&
+        slow_queries_.fetch_add(1, std::memory_order_relaxed) >= kSlowQueriesBeforeRenumber) {
+        UpdateDFSNumbers();
+    }
+    if (dfs_valid_.load(std::memory_order_acquire)) {
+        return dfs_in_[node_a] <= dfs_in_[node_b] && dfs_out_[node_b] <= dfs_out_[node_a];
+    }
+    while (level_[node_b] > level_[node_a]) {
+        node_b = idom_[node_b];
+    }
+    return node_a == node_b;
+}
+
+template <bool IsPostDom>
+const BasicBlock* DominatorTreeBase<IsPostDom>::FindNearestCommonDominator(
+    const BasicBlock* a, const BasicBlock* b) const {
+    const auto node_a = Node(a);
+    const auto node_b = Node(b);
+    if (!IsReachableNode(node_a) || !IsReachableNode(node_b)) {
+        return nullptr;
+    }
+    return blocks_[NearestCommonDominator(node_a, node_b)];
+}
+
+template <bool IsPostDom>
+void DominatorTreeBase<IsPostDom>::InsertEdge(const BasicBlock* from, const BasicBlock* to) {
+    if (Node(from) >= idom_.size() || Node(to) >= idom_.size() ||
+        (IsPostDom && from->Successors().size() == 1)) {
+        // New blocks or a former exit
+        Recalculate();
+        return;
+    }
+    const auto u = IsPostDom ? Node(to) : Node(from);
+    const auto v = IsPostDom ? Node(from) : Node(to);
+    if (!IsReachableNode(u)) {
+        return;
+    }
+    if (!IsReachableNode(v)) {
+        // Blocks reachable only now may bypass dominators outside of any single subtree
+        Recalculate();
+        return;
+    }
+    Recompute(NearestCommonDominator(u, v));
+}
+
+template <bool IsPostDom>
+void DominatorTreeBase<IsPostDom>::DeleteEdge(const BasicBlock* from, const BasicBlock* to) {
+    if (IsPostDom && IsExit(from)) {
+        Recalculate();
+        return;
+    }
+    const auto u = IsPostDom ? Node(to) : Node(from);
+    const auto v = IsPostDom ? Node(from) : Node(to);
+    if (!IsReachableNode(u) || !IsReachableNode(v)) {
+        return;
+    }
+    const auto nca = NearestCommonDominator(u, v);
+    if (nca == v) {
+        return;
+    }
+    std::vector<std::uint32_t> subtree;
+    CollectSubtree(v, &subtree);
+    Recompute(nca);
+    if (IsReachableNode(v)) {
+        return;
+    }
+    // The subtree of v is gone, blocks it branched to may lose dominators above nca
+    auto top = nca;
+    for (auto node : subtree) {
+        ForEachSuccessor(node, [&](std::uint32_t successor) {
+            if (IsReachableNode(successor)) {
+                const auto common = NearestCommonDominator(top, successor);
+                top = common == successor ? top : common;
+            }
+        });
+    }
+    if (top != nca) {
+        Recompute(top);
+    }
+}
+
+template <bool IsPostDom>
+bool DominatorTreeBase<IsPostDom>::IsExit(const BasicBlock* block) const {
+    if constexpr (IsPostDom) {
+        return block->Successors().empty();
+    } else {
+        return block == function_->GetEntryBlock();
+    }
+}
+
+template <bool IsPostDom>
+template <typename TCallback>
+void DominatorTreeBase<IsPostDom>::ForEachSuccessor(std::uint32_t node, TCallback callback) const {
+    if (node == kRoot) {
+        for (auto successor : root_successors_) {
+            callback(successor);
+        }
+        return;
+    }
+    const auto* block = blocks_[node];
+    for (const auto* successor : IsPostDom ? block->Predecessors() : block->Successors()) {
+        callback(Node(successor));
+    }
+}
+
+template <bool IsPostDom>
+template <typename TCallback>
+void DominatorTreeBase<IsPostDom>::ForEachPredecessor(std::uint32_t node,
+                                                      TCallback callback) const {
+    const auto* block = blocks_[node];
+    if (IsExit(block)) {
+        callback(kRoot);
+    }
+    for (const auto* predecessor : IsPostDom ? block->Successors() : block->Predecessors()) {
+        callback(Node(predecessor));
+    }
+}
+
+template <bool IsPostDom>
+void DominatorTreeBase<IsPostDom>::Recompute(std::uint32_t root) {
+    // Forget the old subtree: its nodes and the unreachable ones make up the region
+    std::vector<std::uint32_t> stack;
+    CollectSubtree(root, &stack);
+    for (auto node : stack) {
+        children_[node].clear();
+        if (node != root) {
+            idom_[node] = kNone;
+        }
+    }
+    stack.clear();
+
+    // Postorder of the region, the high bit of a stack entry marks a finished node
+    constexpr std::uint32_t kFinished = 1u << 31;
+    std::vector<std::uint32_t> postorder;
+    po_number_[root] = kFinished;
+    stack.push_back(root | kFinished);
+    ForEachSuccessor(root, [&](std::uint32_t successor) { stack.push_back(successor); });
+    while (!stack.empty()) {
+        const auto entry = stack.back();
+        stack.pop_back();
+        if (entry & kFinished) {
+            po_number_[entry & ~kFinished] = postorder.size();
+            postorder.push_back(entry & ~kFinished);
+            continue;
+        }
+        if (po_number_[entry] != kNone || idom_[entry] != kNone) {
+            continue;
+        }
+        po_number_[entry] = kFinished;
+        stack.push_back(entry | kFinished);
+        ForEachSuccessor(entry, [&](std::uint32_t successor) {
+            if (po_number_[successor] == kNone && idom_[successor] == kNone) {
+                stack.push_back(successor);
+            }
+        });
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto it = postorder.rbegin() + 1; it != postorder.rend(); ++it) {
+            const auto node = *it;
+            auto new_idom = kNone;
+            ForEachPredecessor(node, [&](std::uint32_t predecessor) {
+                if (po_number_[predecessor] == kNone || idom_[predecessor] == kNone) {
+                    return;
+                }
+                new_idom = new_idom == kNone ? predecessor : Intersect(predecessor, new_idom);
+            });
+            if (idom_[node] != new_idom) {
+                idom_[node] = new_idom;
+                changed = true;
+            }
+        }
+    }
+
+    for (auto it = postorder.rbegin() + 1; it != postorder.rend(); ++it) {
+        const auto node = *it;
+        level_[node] = level_[idom_[node]] + 1;
+        children_[idom_[node]].push_back(node);
+    }
+    for (auto node : postorder) {
+        po_number_[node] = kNone;
+    }
+    dfs_valid_.store(false, std::memory_order_relaxed);
+    slow_queries_.store(0, std::memory_order_relaxed);
+}
+
+template <bool IsPostDom>
+void DominatorTreeBase<IsPostDom>::CollectSubtree(std::uint32_t root,
+                                                  std::vector<std::uint32_t>* nodes) const {
+    nodes->push_back(root);
+    for (std::size_t i = nodes->size() - 1; i < nodes->size(); ++i) {
+        const auto& children = children_[(*nodes)[i]];
+        nodes->insert(nodes->end(), children.begin(), children.end());
+    }
+}
+
+template <bool IsPostDom>
+std::uint32_t DominatorTreeBase<IsPostDom>::Intersect(std::uint32_t a, std::uint32_t b) const {
+    while (a != b) {
+        while (po_number_[a] < po_number_[b]) {
+            a = idom_[a];
+        }
+        while (po_number_[b] < po_number_[a]) {
+            b = idom_[b];
+        }
+    }
+    return a;
+}
+
+template <bool IsPostDom>
+std::uint32_t DominatorTreeBase<IsPostDom>::NearestCommonDominator(std::uint32_t a,
+                                                                   std::uint32_t b) const {
+    while (level_[a] > level_[b]) {
+        a = idom_[a];
+    }
+    while (level_[b] > level_[a]) {
+        b = idom_[b];
+    }
+    while (a != b) {
+        a = idom_[a];
+        b = idom_[b];
+    }
+    return a;
+}
+
+template <bool IsPostDom>
+void DominatorTreeBase<IsPostDom>::UpdateDFSNumbers() const {
+    std::lock_guard lock(dfs_mutex_);
+    if (dfs_valid_.load(std::memory_order_relaxed)) {
+        // Another query got here first
+        return;
+    }
+    dfs_in_.resize(idom_.size());
+    dfs_out_.resize(idom_.size());
+    std::uint32_t counter = 0;
+    std::vector<std::pair<std::uint32_t, std::size_t>> stack{{kRoot, 0}};
+    dfs_in_[kRoot] = counter++;
+    while (!stack.empty()) {
+        auto& [node, next_child] = stack.back();
+        if (next_child == children_[node].size()) {
+            dfs_out_[node] = counter++;
+            stack.pop_back();
+            continue;
+        }
+        const auto child = children_[node][next_child++];
+        dfs_in_[child] = counter++;
+        stack.emplace_back(child, 0);
+    }
+    dfs_valid_.store(true, std::memory_order_release);
+}
+
+template class DominatorTreeBase<false>;
+template class DominatorTreeBase<true>;
+
+}  // namespace bier
@@ -0,0 +1,110 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+
+#include <bier/core/function.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace bier {
+
+// Immediate dominators of the blocks of a function, computed with the iterative algorithm of
+// Cooper, Harvey and Kennedy. All the trees hang off a virtual root: the entry block is its only
+// child for dominators, every block without successors is a child for post-dominators.
+// Blocks the root does not reach are unreachable and neither dominate nor are dominated.
+// Const queries may run concurrently, e.g. on a tree shared as an analysis result, updates
+// need the tree for themselves.
+template <bool IsPostDom>
+class DominatorTreeBase {
+public:
+    explicit DominatorTreeBase(const Function* function);
+
+    void Recalculate();
+
+    bool IsReachable(const BasicBlock* block) const;
+    // nullptr for children of the virtual root and unreachable blocks
+    const BasicBlock* GetIDom(const BasicBlock* block) const;
+    std::vector<const BasicBlock*> GetChildren(const BasicBlock* block) const;
+    // Children of the virtual root
+    std::vector<const BasicBlock*> GetRoots() const;
+
+    // O(1) with DFS intervals of the tree, which are renumbered lazily after updates. The
+    // renumbering is serialized between concurrent queries.
+    bool Dominates(const BasicBlock* a, const BasicBlock* b) const;
+    bool StrictlyDominates(const BasicBlock* a, const BasicBlock* b) const {
+        return a != b && Dominates(a, b);
+    }
+    // nullptr if only the virtual root dominates both
+    const BasicBlock* FindNearestCommonDominator(const BasicBlock* a, const BasicBlock* b) const;
+
+    // Update the tree after a single edge of the CFG was inserted or deleted. Mostly only the
+    // subtree of the nearest common dominator of the edge ends is recomputed. Erasing blocks
+    // requires Recalculate.
+    void InsertEdge(const BasicBlock* from, const BasicBlock* to);
+    void DeleteEdge(const BasicBlock* from, const BasicBlock* to);
+
+private:
+    static constexpr std::uint32_t kNone = kNoDenseIndex;
+    static constexpr std::uint32_t kRoot = 0;
+    static constexpr std::uint32_t kSlowQueriesBeforeRenumber = 32;
+
+    const Function* function_ = nullptr;
+    // Node of a block is its index + 1, kRoot is virtual
+    std::vector<const BasicBlock*> blocks_;
+    std::vector<std::uint32_t> idom_;
+    std::vector<std::uint32_t> level_;
+    std::vector<std::vector<std::uint32_t>> children_;
+    std::vector<std::uint32_t> root_successors_;
+    // Scratch space of Recompute
+    std::vector<std::uint32_t> po_number_;
+    // Written under dfs_mutex_ and read only once dfs_valid_ is set
+    mutable std::vector<std::uint32_t> dfs_in_;
+    mutable std::vector<std::uint32_t> dfs_out_;
+    mutable std::atomic<bool> dfs_valid_{false};
+    mutable std::atomic<std::uint32_t> slow_queries_{0};
+    mutable std::mutex dfs_mutex_;
+
+    static std::uint32_t Node(const BasicBlock* block) {
+        return block->GetIndex() + 1;
+    }
+    bool IsReachableNode(std::uint32_t node) const {
+        return node < idom_.size() && idom_[node] != kNone;
+    }
+    bool IsExit(const BasicBlock* block) const;
+
+    // Edges of the analysed graph, which is the reversed CFG for post-dominators
+    template <typename TCallback>
+    void ForEachSuccessor(std::uint32_t node, TCallback callback) const;
+    template <typename TCallback>
+    void ForEachPredecessor(std::uint32_t node, TCallback callback) const;
+
+    // Recomputes immediate dominators of the nodes reachable from root among the ones it
+    // dominated and the unreachable ones
+    void Recompute(std::uint32_t root);
+    void CollectSubtree(std::uint32_t root, std::vector<std::uint32_t>* nodes) const;
+    std::uint32_t Intersect(std::uint32_t a, std::uint32_t b) const;
+    std::uint32_t NearestCommonDominator(std::uint32_t a, std::uint32_t b) const;
+    void UpdateDFSNumbers() const;
+};
+
+using DominatorTree = DominatorTreeBase<false>;
+using PostDominatorTree = DominatorTreeBase<true>;
+
+extern template class DominatorTreeBase<false>;
+extern template class DominatorTreeBase<true>;
+
+}  // namespace bier
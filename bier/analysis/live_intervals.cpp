@@ -0,0 +1,133 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <bier/analysis/live_intervals.h>
+
+#include <bier/operations/opcodes.h>
+#include <bier/utils/casting.h>
+#include <algorithm>
+
+namespace bier {
+
+bool LiveInterval::IsLiveAt(std::uint32_t position) const {
+    auto it = std::upper_bound(
+        ranges_.begin(), ranges_.end(), position,
+        [](std::uint32_t position, const PositionRange& range) { return position < range.end; });
+    return it != ranges_.end() && it->start <= position;
+}
+
+bool LiveInterval::Overlaps(const LiveInterval& other) const {
+    auto left = ranges_.begin();
+    auto right = other.ranges_.begin();
+    while (left != ranges_.end() && right != other.ranges_.end()) {
+        if (left->end <= right->start) {
+            ++left;
+        } else if (right->end <= left->start) {
+            ++right;
+        } else {
+            return true;
+        }
+    }
+    return false;
+}
+
+LiveIntervals::LiveIntervals(const Function* function)
+    : liveness_(function),
+      positions_(function->OperationIndexBound(), kNoDenseIndex),
+      block_ranges_(function->BlockIndexBound()),
+      intervals_(function->ValueIndexBound()) {
+    std::uint32_t position = 0;
+    for (const BasicBlock* block : function->GetBlocks()) {
+        block_ranges_[block->GetIndex()].start = position;
+        for (const Operation* op : block->GetOperations()) {
+            positions_[op->GetIndex()] = position++;
+        }
+        block_ranges_[block->GetIndex()].end = position;
+    }
+
+    // Walking backwards appends the ranges of every variable in decreasing order
+    auto add_range = [this](std::uint32_t value, std::uint32_t start, std::uint32_t end) {
+        if (start < end) {
+            intervals_[value].ranges_.push_back({start, end});
+        }
+    };
+    std::vector<std::uint32_t> live_end(function->ValueIndexBound(), kNoDenseIndex);
+    std::vector<std::uint32_t> live;
+    const auto blocks = function->GetBlocks();
+    for (auto block_it = blocks.end(); block_it != blocks.begin();) {
+        const BasicBlock* block = *--block_it;
+        const PositionRange range = GetBlockRange(block);
+        liveness_.GetLiveOut(block).ForEach([&](std::size_t value) {
+            live_end[value] = range.end;
+            live.push_back(value);
+        });
+        const auto operations = block->GetOperations();
+        for (auto it = operations.end(); it != operations.begin();) {
+            const Operation* op = *--it;
+            const std::uint32_t op_position = GetPosition(op);
+            if (auto result = op->GetReturnValue()) {
+                const auto value = result.value()->GetIndex();
+                add_range(value, op_position,
+                          live_end[value] == kNoDenseIndex ? op_position + 1 : live_end[value]);
+                live_end[value] = kNoDenseIndex;
+            }
+            if (op->OpCode() == OpCodes::PHI_OP) {
+                // Incoming values are live out of the predecessors
+                continue;
+            }
+            for (const Value* operand : op->GetArguments()) {
+                if (operand != nullptr && isa<Variable>(operand) &&
+                    live_end[operand->GetIndex()] == kNoDenseIndex) {
+                    live_end[operand->GetIndex()] = op_position + 1;
+                    live.push_back(operand->GetIndex());
+                }
+            }
+        }
+        for (auto value : live) {
+            if (live_end[value] != kNoDenseIndex) {
+                add_range(value, range.start, live_end[value]);
+                live_end[value] = kNoDenseIndex;
+            }
+        }
+        live.clear();
+    }
+
+    std::vector<std::int32_t> pressure_delta(position + 1, 0);
+    for (auto& interval : intervals_) {
+        auto& ranges = interval.ranges_;
+        std::reverse(ranges.begin(), ranges.end());
+        // Ranges of adjacent blocks touch
+        std::size_t merged = 0;
+        for (std::size_t i = 1; i < ranges.size(); ++i) {
+            if (ranges[i].start <= ranges[merged].end) {
+                ranges[merged].end = std::max(ranges[merged].end, ranges[i].end);
+            } else {
+                ranges[++merged] = ranges[i];
+            }
+        }
+        ranges.resize(std::min(ranges.size(), merged + 1));
+        for (const auto& range : ranges) {
+            ++pressure_delta[range.start];
+            --pressure_delta[range.end];
+        }
+    }
+    std::int32_t pressure = 0;
+    for (auto delta : pressure_delta) {
+        pressure += delta;
+        max_pressure_ = std::max<std::uint32_t>(max_pressure_, pressure);
+    }
+}
+
+}  // namespace bier
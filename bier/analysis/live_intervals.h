@@ -0,0 +1,85 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+
+#include <bier/analysis/liveness.h>
+
+namespace bier {
+
+// Half-open range of linear operation positions
+struct PositionRange {
+    std::uint32_t start = 0;
+    std::uint32_t end = 0;
+};
+
+// Sorted disjoint ranges where a variable is live
+class LiveInterval {
+public:
+    const std::vector<PositionRange>& GetRanges() const {
+        return ranges_;
+    }
+    bool IsEmpty() const {
+        return ranges_.empty();
+    }
+    std::uint32_t Start() const {
+        return ranges_.front().start;
+    }
+    std::uint32_t End() const {
+        return ranges_.back().end;
+    }
+
+    bool IsLiveAt(std::uint32_t position) const;
+    bool Overlaps(const LiveInterval& other) const;
+
+private:
+    friend class LiveIntervals;
+
+    std::vector<PositionRange> ranges_;
+};
+
+// Operations numbered linearly in block layout order, with the live intervals of every variable
+// over these positions. A variable is live from its definition to its last use, inclusive.
+// Meant to be obtained through the AnalysisManager, so it is shared until the next edit.
+class LiveIntervals {
+public:
+    explicit LiveIntervals(const Function* function);
+
+    const Liveness& GetLiveness() const {
+        return liveness_;
+    }
+    std::uint32_t GetPosition(const Operation* op) const {
+        return positions_[op->GetIndex()];
+    }
+    const PositionRange& GetBlockRange(const BasicBlock* block) const {
+        return block_ranges_[block->GetIndex()];
+    }
+    const LiveInterval& GetInterval(const Variable* variable) const {
+        return intervals_[variable->GetIndex()];
+    }
+    // The most variables live at one position
+    std::uint32_t GetMaxPressure() const {
+        return max_pressure_;
+    }
+
+private:
+    Liveness liveness_;
+    std::vector<std::uint32_t> positions_;
+    std::vector<PositionRange> block_ranges_;
+    std::vector<LiveInterval> intervals_;
+    std::uint32_t max_pressure_ = 0;
+};
+
+}  // namespace bier
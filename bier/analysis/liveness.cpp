@@ -0,0 +1,63 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <bier/analysis/liveness.h>
+
+#include <bier/operations/phi.h>
+#include <bier/utils/casting.h>
+
+namespace bier {
+
+LivenessProblem::LivenessProblem(const Function* function)
+    : GenKillProblem(function, function->ValueIndexBound()),
+      phi_uses_(function->BlockIndexBound(), DenseBitVector(universe_)) {
+    for (const BasicBlock* block : function->GetBlocks()) {
+        auto& gen = gen_[block->GetIndex()];
+        auto& kill = kill_[block->GetIndex()];
+        const auto operations = block->GetOperations();
+        for (auto it = operations.end(); it != operations.begin();) {
+            const Operation* op = *--it;
+            if (auto result = op->GetReturnValue()) {
+                kill.Set(result.value()->GetIndex());
+                gen.Reset(result.value()->GetIndex());
+            }
+            if (op->OpCode() == OpCodes::PHI_OP) {
+                const auto* phi = static_cast<const PhiOp*>(op);
+                for (std::size_t i = 0; i < phi->IncomingCount(); ++i) {
+                    const Value* value = phi->IncomingValue(i);
+                    if (value != nullptr && isa<Variable>(value)) {
+                        phi_uses_[phi->IncomingBlock(i)->GetIndex()].Set(value->GetIndex());
+                    }
+                }
+                continue;
+            }
+            for (const Value* value : op->GetArguments()) {
+                if (value != nullptr && isa<Variable>(value)) {
+                    gen.Set(value->GetIndex());
+                }
+            }
+        }
+    }
+}
+
+void LivenessProblem::Initialize(const BasicBlock* block, DenseBitVector* value) const {
+    *value = phi_uses_[block->GetIndex()];
+}
+
+Liveness::Liveness(const Function* function)
+    : solver_(function, LivenessProblem(function)) {
+}
+
+}  // namespace bier
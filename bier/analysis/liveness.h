@@ -0,0 +1,55 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+
+#include <bier/analysis/dataflow.h>
+
+namespace bier {
+
+// Variables live at block boundaries, over value indices. Incoming values of phis are live out
+// of the predecessor they come from rather than live into the phi block.
+class LivenessProblem : public GenKillProblem<DataflowDirection::BACKWARD, false> {
+public:
+    explicit LivenessProblem(const Function* function);
+
+    void Initialize(const BasicBlock* block, DenseBitVector* value) const;
+
+private:
+    std::vector<DenseBitVector> phi_uses_;
+};
+
+class Liveness {
+public:
+    explicit Liveness(const Function* function);
+
+    const DenseBitVector& GetLiveIn(const BasicBlock* block) const {
+        return solver_.GetBlockEntry(block);
+    }
+    const DenseBitVector& GetLiveOut(const BasicBlock* block) const {
+        return solver_.GetBlockExit(block);
+    }
+    bool IsLiveIn(const Variable* variable, const BasicBlock* block) const {
+        return GetLiveIn(block).Test(variable->GetIndex());
+    }
+    bool IsLiveOut(const Variable* variable, const BasicBlock* block) const {
+        return GetLiveOut(block).Test(variable->GetIndex());
+    }
+
+private:
+    DataflowSolver<LivenessProblem> solver_;
+};
+
+}  // namespace bier
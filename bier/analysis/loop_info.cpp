@@ -0,0 +1,277 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <bier/analysis/loop_info.h>
+
+#include <bier/analysis/analysis_manager.h>
+#include <bier/analysis/block_order.h>
+#include <bier/core/const_value.h>
+#include <bier/operations/phi.h>
+#include <bier/utils/casting.h>
+#include <algorithm>
+
+namespace bier {
+
+bool Loop::Contains(const BasicBlock* block) const {
+    return Contains(info_->GetLoopFor(block));
+}
+
+bool Loop::Contains(const Loop* loop) const {
+    while (loop != nullptr && loop->depth_ > depth_) {
+        loop = loop->parent_;
+    }
+    return loop == this;
+}
+
+bool Loop::IsInvariant(const Value* value) const {
+    if (!isa<Variable>(value)) {
+        return true;
+    }
+    for (const Use* definition : value->Definitions()) {
+        if (Contains(definition->GetUser()->GetBlock())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Loop::FindStep(const Variable* variable, TripCountCandidate* candidate) const {
+    const Operation* definition = nullptr;
+    for (const Use* use : variable->Definitions()) {
+        if (Contains(use->GetUser()->GetBlock())) {
+            if (definition != nullptr) {
+                return false;
+            }
+            definition = use->GetUser();
+        }
+    }
+    if (definition == nullptr) {
+        return false;
+    }
+    if (definition->OpCode() != OpCodes::PHI_OP) {
+        // Mutable variable stepped in place
+        return MatchStep(definition, variable, candidate);
+    }
+    // SSA form: a phi of the header takes the stepped value along every back edge
+    const auto* phi = static_cast<const PhiOp*>(definition);
+    if (phi->GetBlock() != header_) {
+        return false;
+    }
+    for (std::size_t i = 0; i < phi->IncomingCount(); ++i) {
+        if (!Contains(phi->IncomingBlock(i))) {
+            continue;
+        }
+        const Value* incoming = phi->IncomingValue(i);
+        const Operation* step = incoming == nullptr ? nullptr : incoming->GetDefiningOp();
+        if (step == nullptr || !Contains(step->GetBlock()) ||
+            !MatchStep(step, variable, candidate)) {
+            return false;
+        }
+    }
+    return candidate->step != nullptr;
+}
+
+bool Loop::MatchStep(const Operation* op, const Value* variable,
+                     TripCountCandidate* candidate) const {
+    if (op->OpCode() != OpCodes::ADD_OP && op->OpCode() != OpCodes::SUB_OP) {
+        return false;
+    }
+    const auto* binary = static_cast<const BinaryOperation*>(op);
+    const Value* step = nullptr;
+    if (binary->LeftValue() == variable && isa<IntegerConst>(binary->RightValue())) {
+        step = binary->RightValue();
+    } else if (binary->GetOp() == BinaryOperation::BinOp::ADD &&
+               binary->RightValue() == variable && isa<IntegerConst>(binary->LeftValue())) {
+        step = binary->LeftValue();
+    } else {
+        return false;
+    }
+    if (candidate->step != nullptr &&
+        (candidate->step != step || candidate->step_op != binary->GetOp())) {
+        return false;
+    }
+    candidate->step = step;
+    candidate->step_op = binary->GetOp();
+    return true;
+}
+
+void Loop::FindTripCountCandidates() {
+    for (const BasicBlock* block : exiting_blocks_) {
+        const auto operations = block->GetOperations();
+        if (operations.Size() == 0) {
+            continue;
+        }
+        const Operation* branch = *std::prev(operations.end());
+        if (branch->OpCode() != OpCodes::COND_BRANCH_OP) {
+            continue;
+        }
+        const Operation* compare = branch->GetArguments()[0]->GetDefiningOp();
+        if (compare == nullptr || compare->OpCode() < OpCodes::EQ_OP ||
+            compare->OpCode() > OpCodes::GT_OP || !Contains(compare->GetBlock())) {
+            continue;
+        }
+        for (std::size_t side = 0; side < 2; ++side) {
+            const Value* induction = compare->GetArguments()[side];
+            const Value* bound = compare->GetArguments()[1 - side];
+            TripCountCandidate candidate;
+            if (isa<Variable>(induction) && IsInvariant(bound) &&
+                FindStep(cast<Variable>(induction), &candidate)) {
+                candidate.exiting_block = block;
+                candidate.compare = compare;
+                candidate.induction = cast<Variable>(induction);
+                candidate.bound = bound;
+                trip_count_candidates_.push_back(candidate);
+            }
+        }
+    }
+}
+
+LoopInfo::LoopInfo(const Function* function) {
+    Build(function, DominatorTree(function));
+}
+
+LoopInfo::LoopInfo(const Function* function, AnalysisManager* analyses) {
+    Build(function, *analyses->GetResult<DominatorTree>(function));
+}
+
+LoopInfo::LoopInfo(const Function* function, const DominatorTree& dominators) {
+    Build(function, dominators);
+}
+
+void LoopInfo::Build(const Function* function, const DominatorTree& dominators) {
+    innermost_.assign(function->BlockIndexBound(), nullptr);
+
+    // Headers in postorder of the dominator tree, so inner loops are found first
+    std::vector<const BasicBlock*> headers;
+    std::vector<std::pair<const BasicBlock*, bool>> stack;
+    for (const BasicBlock* root : dominators.GetRoots()) {
+        stack.emplace_back(root, false);
+    }
+    while (!stack.empty()) {
+        auto [block, expanded] = stack.back();
+        stack.pop_back();
+        if (expanded) {
+            headers.push_back(block);
+            continue;
+        }
+        stack.emplace_back(block, true);
+        for (const BasicBlock* child : dominators.GetChildren(block)) {
+            stack.emplace_back(child, false);
+        }
+    }
+
+    std::vector<const BasicBlock*> worklist;
+    for (const BasicBlock* header : headers) {
+        for (const BasicBlock* predecessor : header->Predecessors()) {
+            if (dominators.Dominates(header, predecessor)) {
+                worklist.push_back(predecessor);
+            }
+        }
+        if (worklist.empty()) {
+            continue;
+        }
+        auto loop = std::make_unique<Loop>();
+        loop->info_ = this;
+        loop->header_ = header;
+        // Walk back from the latches, adopting the outermost loops found so far
+        while (!worklist.empty()) {
+            const BasicBlock* block = worklist.back();
+            worklist.pop_back();
+            Loop* sub_loop = innermost_[block->GetIndex()];
+            if (sub_loop == nullptr) {
+                innermost_[block->GetIndex()] = loop.get();
+                if (block == header) {
+                    continue;
+                }
+                for (const BasicBlock* predecessor : block->Predecessors()) {
+                    if (dominators.IsReachable(predecessor)) {
+                        worklist.push_back(predecessor);
+                    }
+                }
+                continue;
+            }
+            while (sub_loop->parent_ != nullptr) {
+                sub_loop = sub_loop->parent_;
+            }
+            if (sub_loop == loop.get()) {
+                continue;
+            }
+            sub_loop->parent_ = loop.get();
+            loop->sub_loops_.push_back(sub_loop);
+            for (const BasicBlock* predecessor : sub_loop->header_->Predecessors()) {
+                if (innermost_[predecessor->GetIndex()] != sub_loop &&
+                    dominators.IsReachable(predecessor)) {
+                    worklist.push_back(predecessor);
+                }
+            }
+        }
+        loops_.push_back(std::move(loop));
+    }
+
+    // Parents are found after their sub-loops
+    for (auto it = loops_.rbegin(); it != loops_.rend(); ++it) {
+        Loop* loop = it->get();
+        if (loop->parent_ == nullptr) {
+            top_level_loops_.push_back(loop);
+        } else {
+            loop->depth_ = loop->parent_->depth_ + 1;
+        }
+    }
+    for (const BasicBlock* block : ReversePostOrder(function)) {
+        for (Loop* loop = innermost_[block->GetIndex()]; loop != nullptr; loop = loop->parent_) {
+            loop->blocks_.push_back(block);
+        }
+    }
+
+    for (auto& loop : loops_) {
+        const BasicBlock* outside = nullptr;
+        bool single_outside = true;
+        for (const BasicBlock* predecessor : loop->header_->Predecessors()) {
+            if (loop->Contains(predecessor)) {
+                loop->latches_.push_back(predecessor);
+            } else if (outside == nullptr || outside == predecessor) {
+                outside = predecessor;
+            } else {
+                single_outside = false;
+            }
+        }
+        if (outside != nullptr && single_outside &&
+            std::all_of(outside->Successors().begin(), outside->Successors().end(),
+                        [&](const BasicBlock* block) { return block == loop->header_; })) {
+            loop->preheader_ = outside;
+        }
+
+        for (const BasicBlock* block : loop->blocks_) {
+            bool exiting = false;
+            for (const BasicBlock* successor : block->Successors()) {
+                if (loop->Contains(successor)) {
+                    continue;
+                }
+                exiting = true;
+                auto& exit_blocks = loop->exit_blocks_;
+                if (std::find(exit_blocks.begin(), exit_blocks.end(), successor) ==
+                    exit_blocks.end()) {
+                    exit_blocks.push_back(successor);
+                }
+            }
+            if (exiting) {
+                loop->exiting_blocks_.push_back(block);
+            }
+        }
+        loop->FindTripCountCandidates();
+    }
+}
+
+}  // namespace bier
@@ -0,0 +1,139 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+
+#include <bier/analysis/dominator_tree.h>
+#include <memory>
+
+namespace bier {
+
+class AnalysisManager;
+class LoopInfo;
+
+// Exit condition comparing a variable stepped by a constant once per iteration against a loop
+// invariant bound
+struct TripCountCandidate {
+    const BasicBlock* exiting_block = nullptr;
+    const Operation* compare = nullptr;
+    const Variable* induction = nullptr;
+    const Value* bound = nullptr;
+    // ADD or SUB
+    BinaryOperation::BinOp step_op = BinaryOperation::BinOp::INVALID;
+    const Value* step = nullptr;
+};
+
+// Natural loop: the header and the blocks reaching its back edges without passing through it
+class Loop {
+public:
+    const BasicBlock* GetHeader() const {
+        return header_;
+    }
+    const Loop* GetParent() const {
+        return parent_;
+    }
+    const std::vector<const Loop*>& GetSubLoops() const {
+        return sub_loops_;
+    }
+    // Outermost loops have depth 1
+    std::uint32_t GetDepth() const {
+        return depth_;
+    }
+    // In reverse postorder, the header goes first. Includes blocks of the sub-loops.
+    const std::vector<const BasicBlock*>& GetBlocks() const {
+        return blocks_;
+    }
+    bool Contains(const BasicBlock* block) const;
+    bool Contains(const Loop* loop) const;
+
+    // The only predecessor of the header out of the loop if it only branches to the header
+    const BasicBlock* GetPreheader() const {
+        return preheader_;
+    }
+    // Blocks branching back to the header
+    const std::vector<const BasicBlock*>& GetLatches() const {
+        return latches_;
+    }
+    // Blocks of the loop with successors out of the loop
+    const std::vector<const BasicBlock*>& GetExitingBlocks() const {
+        return exiting_blocks_;
+    }
+    // Successors of exiting blocks out of the loop, without duplicates
+    const std::vector<const BasicBlock*>& GetExitBlocks() const {
+        return exit_blocks_;
+    }
+    const std::vector<TripCountCandidate>& GetTripCountCandidates() const {
+        return trip_count_candidates_;
+    }
+
+private:
+    friend class LoopInfo;
+
+    const LoopInfo* info_ = nullptr;
+    const BasicBlock* header_ = nullptr;
+    Loop* parent_ = nullptr;
+    std::vector<const Loop*> sub_loops_;
+    std::uint32_t depth_ = 1;
+    std::vector<const BasicBlock*> blocks_;
+    const BasicBlock* preheader_ = nullptr;
+    std::vector<const BasicBlock*> latches_;
+    std::vector<const BasicBlock*> exiting_blocks_;
+    std::vector<const BasicBlock*> exit_blocks_;
+    std::vector<TripCountCandidate> trip_count_candidates_;
+
+    bool IsInvariant(const Value* value) const;
+    // Whether variable is stepped by a constant once per iteration
+    bool FindStep(const Variable* variable, TripCountCandidate* candidate) const;
+    bool MatchStep(const Operation* op, const Value* variable,
+                   TripCountCandidate* candidate) const;
+    void FindTripCountCandidates();
+};
+
+// Loop nesting forest of a function found from the back edges of its dominator tree
+class LoopInfo {
+public:
+    explicit LoopInfo(const Function* function);
+    LoopInfo(const Function* function, const DominatorTree& dominators);
+    // Takes the dominator tree from the manager
+    LoopInfo(const Function* function, AnalysisManager* analyses);
+
+    const std::vector<const Loop*>& GetTopLevelLoops() const {
+        return top_level_loops_;
+    }
+    std::size_t GetLoopCount() const {
+        return loops_.size();
+    }
+    // Innermost loop containing the block, nullptr if there is none
+    const Loop* GetLoopFor(const BasicBlock* block) const {
+        return block->GetIndex() < innermost_.size() ? innermost_[block->GetIndex()] : nullptr;
+    }
+    std::uint32_t GetLoopDepth(const BasicBlock* block) const {
+        const Loop* loop = GetLoopFor(block);
+        return loop == nullptr ? 0 : loop->GetDepth();
+    }
+    bool IsLoopHeader(const BasicBlock* block) const {
+        const Loop* loop = GetLoopFor(block);
+        return loop != nullptr && loop->GetHeader() == block;
+    }
+
+private:
+    std::vector<std::unique_ptr<Loop>> loops_;
+    std::vector<const Loop*> top_level_loops_;
+    std::vector<Loop*> innermost_;
+
+    void Build(const Function* function, const DominatorTree& dominators);
+};
+
+}  // namespace bier
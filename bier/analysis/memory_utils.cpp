@@ -0,0 +1,71 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <bier/analysis/memory_utils.h>
+
+#include <bier/operations/opcodes.h>
+#include <bier/utils/casting.h>
+
+namespace bier {
+
+bool IsAllocation(const Operation* op) {
+    return op->OpCode() == OpCodes::ALLOC_OP || op->OpCode() == OpCodes::ALLOC_LAYOUT_OP;
+}
+
+const Value* LoadAddress(const Operation* load) {
+    return load->GetArguments()[0];
+}
+
+const Value* StoredValue(const Operation* store) {
+    return store->GetArguments()[0];
+}
+
+const Value* StoreAddress(const Operation* store) {
+    return store->GetArguments()[1];
+}
+
+bool IsLocalAllocation(const Variable* pointer) {
+    for (const Use* use : pointer->Uses()) {
+        const Operation* user = use->GetUser();
+        const bool is_load = user->OpCode() == OpCodes::LOAD_OP;
+        const bool is_store_address =
+            user->OpCode() == OpCodes::STORE_OP && StoredValue(user) != pointer;
+        if (!is_load && !is_store_address) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const Variable* GetLocalAllocation(const Operation* op) {
+    if (!IsAllocation(op)) {
+        return nullptr;
+    }
+    auto result = op->GetReturnValue();
+    if (!result.has_value() || result.value()->GetDefiningOp() != op ||
+        !IsLocalAllocation(result.value())) {
+        return nullptr;
+    }
+    return result.value();
+}
+
+bool HasSingleValue(const Value* value) {
+    if (isa<Variable>(value)) {
+        return value->GetDefiningOp() != nullptr;
+    }
+    return value->Definitions().Empty();
+}
+
+}  // namespace bier
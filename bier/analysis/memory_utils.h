@@ -0,0 +1,40 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+
+#include <bier/core/operation.h>
+#include <bier/core/variable.h>
+
+namespace bier {
+
+// Accessors and predicates shared by the passes reasoning about memory operations
+
+bool IsAllocation(const Operation* op);
+
+const Value* LoadAddress(const Operation* load);
+const Value* StoredValue(const Operation* store);
+const Value* StoreAddress(const Operation* store);
+
+// The pointer is only loaded from and stored to, so the memory is private to the function
+bool IsLocalAllocation(const Variable* pointer);
+
+// The pointer op defines if it allocates memory private to the function, nullptr otherwise
+const Variable* GetLocalAllocation(const Operation* op);
+
+// A variable with one definition or a constant, all of its uses observe the same value
+bool HasSingleValue(const Value* value);
+
+}  // namespace bier
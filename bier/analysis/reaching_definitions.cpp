@@ -0,0 +1,65 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <bier/analysis/reaching_definitions.h>
+
+namespace bier {
+
+ReachingDefinitionsProblem::ReachingDefinitionsProblem(const Function* function)
+    : GenKillProblem(function, function->OperationIndexBound()),
+      definitions_(function->ValueIndexBound()) {
+    for (const BasicBlock* block : function->GetBlocks()) {
+        for (const Operation* op : block->GetOperations()) {
+            if (auto result = op->GetReturnValue()) {
+                definitions_[result.value()->GetIndex()].push_back(op);
+            }
+        }
+    }
+    for (const BasicBlock* block : function->GetBlocks()) {
+        auto& gen = gen_[block->GetIndex()];
+        auto& kill = kill_[block->GetIndex()];
+        for (const Operation* op : block->GetOperations()) {
+            if (auto result = op->GetReturnValue()) {
+                for (const Operation* definition : GetDefinitions(result.value())) {
+                    gen.Reset(definition->GetIndex());
+                    kill.Set(definition->GetIndex());
+                }
+                gen.Set(op->GetIndex());
+            }
+        }
+    }
+}
+
+const std::vector<const Operation*>& ReachingDefinitionsProblem::GetDefinitions(
+    const Variable* variable) const {
+    return definitions_[variable->GetIndex()];
+}
+
+ReachingDefinitions::ReachingDefinitions(const Function* function)
+    : solver_(function, ReachingDefinitionsProblem(function)) {
+}
+
+std::vector<const Operation*> ReachingDefinitions::GetReaching(const Variable* variable,
+                                                               const BasicBlock* block) const {
+    std::vector<const Operation*> reaching;
+    for (const Operation* definition : solver_.GetProblem().GetDefinitions(variable)) {
+        if (GetReachingIn(block).Test(definition->GetIndex())) {
+            reaching.push_back(definition);
+        }
+    }
+    return reaching;
+}
+
+}  // namespace bier
@@ -0,0 +1,51 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+
+#include <bier/analysis/dataflow.h>
+
+namespace bier {
+
+// Operations defining a variable that reach block boundaries, over operation indices
+class ReachingDefinitionsProblem : public GenKillProblem<DataflowDirection::FORWARD, false> {
+public:
+    explicit ReachingDefinitionsProblem(const Function* function);
+
+    const std::vector<const Operation*>& GetDefinitions(const Variable* variable) const;
+
+private:
+    std::vector<std::vector<const Operation*>> definitions_;
+};
+
+class ReachingDefinitions {
+public:
+    explicit ReachingDefinitions(const Function* function);
+
+    const DenseBitVector& GetReachingIn(const BasicBlock* block) const {
+        return solver_.GetBlockEntry(block);
+    }
+    const DenseBitVector& GetReachingOut(const BasicBlock* block) const {
+        return solver_.GetBlockExit(block);
+    }
+    // Definitions of variable reaching the start of block
+    std::vector<const Operation*> GetReaching(const Variable* variable,
+                                              const BasicBlock* block) const;
+
+private:
+    DataflowSolver<ReachingDefinitionsProblem> solver_;
+};
+
+}  // namespace bier
@@ -111,8 +111,7 @@ void ModuleBuilder::CreateStoreImpl(const Value* ptr, const Value* value) {
           IRException("store to " + ptr->GetType()->ToString() + " of " +
                              store_type->ToString() + " is not possible",
                       CurrentFunction(), CurrentBlock()));
-    CurrentBlock()->Append(std::make_unique<BinaryOperation>(
-        CurrentFunction(), BinaryOperation::BinOp::STORE, value, ptr, nullptr));
+    AppendOperation<BinaryOperation>(BinaryOperation::BinOp::STORE, value, ptr, nullptr);
 }
 
 const Value* ModuleBuilder::CreateAllocSingleImpl(const Type* alloc_type, const std::string& name,
@@ -127,8 +126,7 @@ const Value* ModuleBuilder::CreateAllocArrayImpl(const Type* alloc_type, const V
     check(module_->Types()->IsInteger(count->GetType()),
           IRException("cannot allocate count of " + count->GetType()->ToString() + " type",
                       CurrentFunction(), CurrentBlock()));
-    CurrentBlock()->Append(std::make_unique<UnaryOperation>(
-        CurrentFunction(), UnaryOperation::UnOp::ALLOC, count, result));
+    AppendOperation<UnaryOperation>(UnaryOperation::UnOp::ALLOC, count, result);
 
     return result;
 }
@@ -142,8 +140,7 @@ const Value* ModuleBuilder::CreateAllocLayoutArrayImpl(const Layout* layout, con
                                         const std::string& name, bool is_mutable) {
     const Variable* result = CurrentFunction()->AllocateVariable(
         Variable::Metadata(name, module_->Types()->GetPtr(), is_mutable));
-    CurrentBlock()->Append(
-        std::make_unique<AllocateLayout>(CurrentFunction(), layout, count, result));
+    AppendOperation<AllocateLayout>(layout, count, result);
     return result;
 }
 
@@ -159,8 +156,7 @@ const Variable* ModuleBuilder::CreateLoadImpl(const Value* ptr, const Type* load
           IRException("load from " + ptr->GetType()->ToString() + " to " +
                              load_type->ToString() + " is not possible",
                       CurrentFunction(), CurrentBlock()));
-    CurrentBlock()->Append(std::make_unique<UnaryOperation>(
-        CurrentFunction(), UnaryOperation::UnOp::LOAD, ptr, result));
+    AppendOperation<UnaryOperation>(UnaryOperation::UnOp::LOAD, ptr, result);
 
     return result;
 }
@@ -172,16 +168,14 @@ void ModuleBuilder::CreateAssignBetweenImpl(const Value* from, const Variable* t
           IRException("cannot assign from type " + from->GetType()->ToString() + " to " +
                              to->GetType()->ToString() + " without explicit cast",
                       CurrentFunction(), CurrentBlock()));
-    current_block_->Append(std::make_unique<UnaryOperation>(
-        CurrentFunction(), UnaryOperation::UnOp::ASSIGN, from, to));
+    AppendOperation<UnaryOperation>(UnaryOperation::UnOp::ASSIGN, from, to);
 }
 
 const Variable* ModuleBuilder::CreateAssignImpl(const Value* from, const std::string& name,
                                          bool is_mutable) {
     const Variable* result =
         CurrentFunction()->AllocateVariable(Variable::Metadata(name, from->GetType(), is_mutable));
-    current_block_->Append(std::make_unique<UnaryOperation>(
-        CurrentFunction(), UnaryOperation::UnOp::ASSIGN, from, result));
+    AppendOperation<UnaryOperation>(UnaryOperation::UnOp::ASSIGN, from, result);
     return result;
 }
 
@@ -193,7 +187,7 @@ std::optional<const Variable*> ModuleBuilder::CreateCallFuncImpl(const Function*
     if (return_type.has_value()) {
         result = CreateVariable(name, return_type.value(), is_mutable);
     }
-    current_block_->Append(std::make_unique<CallOp>(CurrentFunction(), func, result, args));
+    AppendOperation<CallOp>(func, result, args);
     return result;
 }
 
@@ -205,8 +199,7 @@ std::optional<const Variable*> ModuleBuilder::CreateCallFuncSigImpl(const Functi
     if (return_type.has_value()) {
         result = CreateVariable(name, return_type.value(), is_mutable);
     }
-    current_block_->Append(
-        std::make_unique<CallOp>(CurrentFunction(), func_sig->FuncType(), func_sig, result, args));
+    AppendOperation<CallOp>(func_sig->FuncType(), func_sig, result, args);
     return result;
 }
 
@@ -218,8 +211,7 @@ std::optional<const Variable*> ModuleBuilder::CreateCallFuncPtr(const FunctionTy
     if (return_type.has_value()) {
         result = CreateVariable(name, return_type.value(), is_mutable);
     }
-    current_block_->Append(
-        std::make_unique<CallOp>(CurrentFunction(), func_type, func_ptr, result, args));
+    AppendOperation<CallOp>(func_type, func_ptr, result, args);
     return result;
 }
 
@@ -228,11 +220,11 @@ void ModuleBuilder::CreateReturnVoidImpl() {
           IRException(CurrentFunction()->GetName() +
                              " has return type, but void is returned",
                       CurrentFunction(), CurrentBlock()));
-    current_block_->Append(std::make_unique<ReturnVoidOp>(CurrentFunction()));
+    AppendOperation<ReturnVoidOp>();
 }
 
 void ModuleBuilder::CreateReturnValueImpl(const Value* value) {
-    current_block_->Append(std::make_unique<ReturnValueOp>(CurrentFunction(), value));
+    AppendOperation<ReturnValueOp>(value);
 }
 
 const Variable* ModuleBuilder::CreateGEPImpl(const Value* ptr, const Layout* layout, int element_index,
@@ -245,35 +237,32 @@ const Variable* ModuleBuilder::CreateGEPImpl(const Value* ptr, const Layout* lay
                       CurrentFunction(), CurrentBlock()));
     const Variable* result = CreateVariable(
         name, module_->Types()->GetPtrTo(layout->GetEntry(element_index)), is_mutable);
-    auto gep = std::make_unique<GEPOp>(CurrentFunction(), ptr, element_index, result, layout,
-                                       base_offset, element_offset);
-    current_block_->Append(std::move(gep));
+    AppendOperation<GEPOp>(ptr, element_index, result, layout, base_offset, element_offset);
     return result;
 }
 
 const Variable* ModuleBuilder::CastToImpl(const Value* value, const Type* target_type,
                                    const std::string& name, bool is_mutable) {
     const Variable* result = CreateVariable(name, target_type, is_mutable);
-    current_block_->Append(std::make_unique<CastOperation>(CurrentFunction(), value, result));
+    AppendOperation<CastOperation>(value, result);
     return result;
 }
 
 Function* ModuleBuilder::CurrentFunction() {
     assert(current_block_ != nullptr);
-    return module_->GetFunction(current_block_->GetContextFunction()->GetName());
+    return module_->GetFunction(current_block_->GetContextFunction()->GetSignature());
 }
 
-void ModuleBuilder::CreateBranchImpl(const BasicBlock* target) {
-    current_block_->Append(std::make_unique<BranchOperation>(CurrentFunction(), target));
+void ModuleBuilder::CreateBranchImpl(BasicBlock* target) {
+    AppendOperation<BranchOperation>(target);
     current_block_->TerminateBlock();
 }
 
-void ModuleBuilder::CreateConditionBranchImpl(const Value* condtion, const BasicBlock* target_true,
-                                          const BasicBlock* target_false) {
+void ModuleBuilder::CreateConditionBranchImpl(const Value* condtion, BasicBlock* target_true,
+                                          BasicBlock* target_false) {
     check(condtion->GetType() == module_->Types()->GetInt1(),
           IRException("condition should be of type bool", CurrentFunction(), CurrentBlock()));
-    current_block_->Append(std::make_unique<ConditionalBranchOperation>(CurrentFunction(), condtion,
-                                                                        target_true, target_false));
+    AppendOperation<ConditionalBranchOperation>(condtion, target_true, target_false);
     current_block_->TerminateBlock();
 }
 
@@ -292,8 +281,7 @@ template <BinaryOperation::BinOp op>
 const Variable* ModuleBuilder::CreateCmp(const Value* left, const Value* right,
                                       const std::string& name, bool is_mutable) {
     const Variable* result = CreateVariable(name, module_->Types()->GetInt1(), is_mutable);
-    current_block_->Append(
-        std::make_unique<BinaryOperation>(CurrentFunction(), op, left, right, result));
+    AppendOperation<BinaryOperation>(op, left, right, result);
     return result;
 }
 
@@ -305,8 +293,7 @@ const Variable* ModuleBuilder::CreateArithmetic(const Value* left, const Value*
                              right->GetType()->ToString(),
                       CurrentFunction(), CurrentBlock()));
     const Variable* result = CreateVariable(name, left->GetType(), is_mutable);
-    current_block_->Append(
-        std::make_unique<BinaryOperation>(CurrentFunction(), op, left, right, result));
+    AppendOperation<BinaryOperation>(op, left, right, result);
     return result;
 }
 
@@ -218,12 +218,12 @@ public:
     }
 
 
-    void CreateBranch(const BasicBlock* target) {
+    void CreateBranch(BasicBlock* target) {
         return DiagnosticCreate<decltype (&ModuleBuilder::CreateBranchImpl),
                 &ModuleBuilder::CreateBranchImpl>(target);
     }
-    void CreateConditionBranch(const Value* condtion, const BasicBlock* target_true,
-                                   const BasicBlock* target_false) {
+    void CreateConditionBranch(const Value* condtion, BasicBlock* target_true,
+                                   BasicBlock* target_false) {
         return DiagnosticCreate<decltype (&ModuleBuilder::CreateConditionBranchImpl),
                 &ModuleBuilder::CreateConditionBranchImpl>(condtion, target_true, target_false);
     }    
@@ -250,6 +250,13 @@ private:
     template <typename TRegister, const Type* (TRegister::*FGetIntMethod)() const>
     const Value* CreateConstInt(uint64_t value, const TRegister* types);
 
+    template <typename TOperation, typename... Args>
+    void AppendOperation(Args&&... args) {
+        Function* function = CurrentFunction();
+        current_block_->Append(
+            function->MakeOperation<TOperation>(function, std::forward<Args>(args)...));
+    }
+
     template <BinaryOperation::BinOp op>
     const Variable* CreateCmp(const Value* left, const Value* right, const std::string& name,
                            bool is_mutable);
@@ -351,19 +358,15 @@ private:
                         bool is_mutable = false);
 
 
-    void CreateBranchImpl(const BasicBlock* target);
-    void CreateConditionBranchImpl(const Value* condtion, const BasicBlock* target_true,
-                                   const BasicBlock* target_false);
+    void CreateBranchImpl(BasicBlock* target);
+    void CreateConditionBranchImpl(const Value* condtion, BasicBlock* target_true,
+                                   BasicBlock* target_false);
 };
 
 template <typename TRegister, const Type* (TRegister::*FGetIntMethod)() const>
 const Value* ModuleBuilder::CreateConstInt(uint64_t value, const TRegister* types) {
-    assert(current_block_ != nullptr);
-    auto int_value = std::make_unique<IntegerConst>(
-        value, static_cast<const IntTypeBase*>((types->*FGetIntMethod)()));
-    const Value* return_val = int_value.get();
-    current_block_->InsertConst(std::move(int_value));
-    return return_val;
+    return module_->Constants()->GetInteger(
+        value, cast<IntTypeBase>((types->*FGetIntMethod)()));
 }
 
 
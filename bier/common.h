@@ -14,6 +14,8 @@
    limitations under the License.
 */
 #pragma once
+#include <bier/utils/arena.h>
+#include <bier/utils/symbol_table.h>
 #include <cassert>
 #include <memory>
 #include <unordered_map>
@@ -29,10 +31,10 @@ class Value;
 class Type;
 
 using BasicBlockPtr = std::unique_ptr<BasicBlock>;
-using FunctionSigPtr = std::unique_ptr<FunctionSignature>;
-using FunctionPtr = std::unique_ptr<Function>;
+using FunctionSigPtr = ArenaPtr<FunctionSignature>;
+using FunctionPtr = ArenaPtr<Function>;
 using ValuePtr = std::unique_ptr<Value>;
-using OperationPtr = std::unique_ptr<Operation>;
+using OperationPtr = ArenaPtr<Operation>;
 using TypePtr = std::unique_ptr<Type>;
 
 using HashType = std::size_t;
@@ -15,6 +15,8 @@
 */
 #include "basic_block.h"
 #include <bier/core/exceptions.h>
+#include <bier/core/function.h>
+#include <algorithm>
 
 namespace bier {
 
@@ -22,26 +24,75 @@ void BasicBlock::Append(bier::OperationPtr&& operation) {
     check(!branch_terminated_,
           IRException("trying to add operation to block with branch at the end",
                       GetContextFunction(), this));
-    operations_.emplace_back(std::move(operation));
+    operation->block_ = this;
+    LinkSuccessors(operation.get());
+    operations_.PushBack(std::move(operation));
+    context_->MarkModified();
 }
 
-void BasicBlock::InsertAt(BasicBlock::OperationIterator iterator, OperationPtr&& operation) {
-    operations_.insert(iterator, std::move(operation));
+BasicBlock::OperationIterator BasicBlock::InsertAt(BasicBlock::OperationIterator iterator,
+                                                   OperationPtr&& operation) {
+    operation->block_ = this;
+    LinkSuccessors(operation.get());
+    context_->MarkModified();
+    return operations_.Insert(iterator, std::move(operation));
 }
 
-void BasicBlock::DeleteAt(BasicBlock::OperationIterator iterator) {
-    operations_.erase(iterator);
+BasicBlock::OperationIterator BasicBlock::DeleteAt(BasicBlock::OperationIterator iterator) {
+    UnlinkSuccessors(*iterator);
+    context_->MarkModified();
+    return operations_.Erase(iterator);
 }
 
-const ConstValue* BasicBlock::InsertConst(std::unique_ptr<ConstValue>&& value) {
-    assert(value.get() != nullptr);
-    const ConstValue* ptr = value.get();
-    constants_.emplace_back(std::move(value));
-    return ptr;
+OperationPtr BasicBlock::Remove(BasicBlock::OperationIterator iterator) {
+    UnlinkSuccessors(*iterator);
+    OperationPtr operation = operations_.Remove(iterator);
+    operation->block_ = nullptr;
+    context_->MarkModified();
+    return operation;
+}
+
+void BasicBlock::Splice(BasicBlock::OperationIterator iterator, BasicBlock* other,
+                        BasicBlock::OperationIterator first, BasicBlock::OperationIterator last) {
+    assert(other->GetContextFunction() == GetContextFunction());
+    for (auto it = first; it != last; ++it) {
+        other->UnlinkSuccessors(*it);
+        LinkSuccessors(*it);
+        it->block_ = this;
+    }
+    operations_.Splice(iterator, other->operations_, first, last);
+    context_->MarkModified();
 }
 
 const Function* BasicBlock::GetContextFunction() const {
     return context_;
 }
 
+void BasicBlock::AddEdge(BasicBlock* successor) {
+    successors_.push_back(successor);
+    successor->predecessors_.push_back(this);
+}
+
+void BasicBlock::RemoveEdge(BasicBlock* successor) {
+    auto erase_one = [](std::vector<BasicBlock*>& edges, BasicBlock* block) {
+        auto it = std::find(edges.begin(), edges.end(), block);
+        assert(it != edges.end());
+        edges.erase(it);
+    };
+    erase_one(successors_, successor);
+    erase_one(successor->predecessors_, this);
+}
+
+void BasicBlock::LinkSuccessors(const Operation* operation) {
+    for (BasicBlock* successor : operation->GetSuccessors()) {
+        AddEdge(successor);
+    }
+}
+
+void BasicBlock::UnlinkSuccessors(const Operation* operation) {
+    for (BasicBlock* successor : operation->GetSuccessors()) {
+        RemoveEdge(successor);
+    }
+}
+
 }  // namespace bier
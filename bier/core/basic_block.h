@@ -20,26 +20,43 @@
 #include <bier/core/operation.h>
 #include <bier/utils/iterator_range.h>
 #include <bier/utils/intrusive_list.h>
-#include <list>
 #include <vector>
 
 namespace bier {
 
-class BasicBlock : public IntrusiveListNode<BasicBlock>, public FunctionContextMemeber {
+class BasicBlock : public IntrusiveDListNode<BasicBlock>, public FunctionContextMemeber {
 public:
-    template <typename T>
-    using OperationContainer = std::list<T>;
-    using OperationIterator = OperationContainer<OperationPtr>::iterator;
-    using ConstOperationIterator = OperationContainer<OperationPtr>::const_iterator;
+    using OperationContainer = IntrusiveDList<Operation, ArenaDeleter>;
+    using OperationIterator = OperationContainer::iterator;
+    using ConstOperationIterator = OperationContainer::const_iterator;
 
-    explicit BasicBlock(const Function* function, const std::string& label = "")
+    explicit BasicBlock(const Function* function, Symbol label = Symbol())
         : label_(label), context_(function) {
     }
 
     void Append(OperationPtr&& operation);
-    void InsertAt(OperationIterator iterator, OperationPtr&& operation);
-    void DeleteAt(OperationIterator iterator);
-    const ConstValue* InsertConst(std::unique_ptr<ConstValue>&& value);
+    // Inserts operation before iterator
+    OperationIterator InsertAt(OperationIterator iterator, OperationPtr&& operation);
+    // Destroys operation, returns the next one
+    OperationIterator DeleteAt(OperationIterator iterator);
+    // Detaches operation from the block without destroying it
+    OperationPtr Remove(OperationIterator iterator);
+    // Moves operations [first, last) of other block before iterator
+    void Splice(OperationIterator iterator, BasicBlock* other, OperationIterator first,
+                OperationIterator last);
+    void Splice(OperationIterator iterator, BasicBlock* other, OperationIterator operation) {
+        Splice(iterator, other, operation, std::next(operation));
+    }
+
+    OperationIterator GetIterator(Operation* operation) {
+        assert(operation->GetBlock() == this);
+        return operations_.MakeIterator(operation);
+    }
+    ConstOperationIterator GetIterator(const Operation* operation) const {
+        assert(operation->GetBlock() == this);
+        return operations_.MakeIterator(operation);
+    }
+
     void TerminateBlock() {
         branch_terminated_ = true;
     }
@@ -54,15 +71,50 @@ public:
     }
 
     const std::string& GetLabel() const {
+        return label_.Str();
+    }
+    Symbol GetLabelSymbol() const {
         return label_;
     }
 
+    // Dense index within the function
+    std::uint32_t GetIndex() const {
+        return index_;
+    }
+
+    // The last operation, nullptr for an empty block
+    Operation* GetTerminator() {
+        return operations_.back();
+    }
+    const Operation* GetTerminator() const {
+        return operations_.back();
+    }
+
+    // Control flow edges, kept up to date as branches are inserted, removed and retargeted.
+    // An edge is listed once per branch target, so duplicates are possible.
+    const std::vector<BasicBlock*>& Successors() const {
+        return successors_;
+    }
+    const std::vector<BasicBlock*>& Predecessors() const {
+        return predecessors_;
+    }
+
 private:
-    std::vector<std::unique_ptr<ConstValue>> constants_;
-    OperationContainer<OperationPtr> operations_;
-    std::string label_;
+    friend class Operation;
+    friend class Function;
+
+    OperationContainer operations_;
+    std::vector<BasicBlock*> successors_;
+    std::vector<BasicBlock*> predecessors_;
+    Symbol label_;
     const Function* context_ = nullptr;
+    std::uint32_t index_ = kNoDenseIndex;
     bool branch_terminated_ = false;
+
+    void AddEdge(BasicBlock* successor);
+    void RemoveEdge(BasicBlock* successor);
+    void LinkSuccessors(const Operation* operation);
+    void UnlinkSuccessors(const Operation* operation);
 };
 
 }  // namespace bier
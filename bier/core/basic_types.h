@@ -21,19 +21,38 @@ namespace bier {
 
 class VoidType : public Type {
 public:
+    VoidType() : Type(Kind::VOID) {
+    }
+
+    static bool classof(const Type* type) {
+        return type->GetKind() == Kind::VOID;
+    }
+
     // Type interface
     std::string ToString() const override;
 };
 
 class PtrType : public Type {
 public:
+    PtrType() : Type(Kind::PTR) {
+    }
+
+    static bool classof(const Type* type) {
+        return type->GetKind() == Kind::PTR;
+    }
+
     // Type interface
     std::string ToString() const override;
 };
 
 class TypedPtrType : public Type {
 public:
-    explicit TypedPtrType(const Type* underlying) : underlying_(underlying) {
+    explicit TypedPtrType(const Type* underlying)
+        : Type(Kind::TYPED_PTR), underlying_(underlying) {
+    }
+
+    static bool classof(const Type* type) {
+        return type->GetKind() == Kind::TYPED_PTR;
     }
 
     // Type interface
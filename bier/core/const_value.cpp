@@ -18,7 +18,8 @@
 
 namespace bier {
 
-IntegerConst::IntegerConst(uint64_t value, const IntTypeBase* type) : value_(value), type_(type) {
+IntegerConst::IntegerConst(uint64_t value, const IntTypeBase* type)
+    : ConstValue(Kind::INTEGER_CONST), value_(value), type_(type) {
     check(type_->IsValid(value),
           IRException(std::to_string(value) + "is not in range of " + type_->ToString()));
 }
@@ -21,6 +21,13 @@ namespace bier {
 
 class ConstValue : public Value {
 public:
+    explicit ConstValue(Kind kind) : Value(kind) {
+    }
+
+    static bool classof(const Value* value) {
+        return value->GetKind() >= Kind::INTEGER_CONST;
+    }
+
     virtual std::string GetConstValue() const = 0;
 };
 
@@ -28,12 +35,16 @@ class IntegerConst : public ConstValue {
 public:
     IntegerConst(uint64_t value, const IntTypeBase* type);
 
+    static bool classof(const Value* value) {
+        return value->GetKind() == Kind::INTEGER_CONST;
+    }
+
     // Value interface
     const Type* GetType() const override {
         return type_;
     }
-    std::string GetName() const override {
-        return "";
+    const std::string& GetName() const override {
+        return Symbol().Str();
     }
     bool IsMutable() const override {
         return false;
@@ -55,4 +66,35 @@ private:
     const IntTypeBase* type_ = nullptr;
 };
 
+// Arbitrary value of a type, e.g. a variable read before any assignment
+class UndefConst : public ConstValue {
+public:
+    explicit UndefConst(const Type* type) : ConstValue(Kind::UNDEF_CONST), type_(type) {
+        assert(type_ != nullptr);
+    }
+
+    static bool classof(const Value* value) {
+        return value->GetKind() == Kind::UNDEF_CONST;
+    }
+
+    // Value interface
+    const Type* GetType() const override {
+        return type_;
+    }
+    const std::string& GetName() const override {
+        return Symbol().Str();
+    }
+    bool IsMutable() const override {
+        return false;
+    }
+
+    // ConstValue interface
+    std::string GetConstValue() const override {
+        return "undef";
+    }
+
+private:
+    const Type* type_ = nullptr;
+};
+
 }  // namespace bier
@@ -0,0 +1,67 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "constant_pool.h"
+#include <boost/functional/hash.hpp>
+
+namespace bier {
+
+HashType ConstantPool::IntegerKey::Hash::operator()(const IntegerKey& key) const {
+    HashType hash = 0;
+    boost::hash_combine(hash, key.type);
+    boost::hash_combine(hash, key.value);
+    return hash;
+}
+
+const IntegerConst* ConstantPool::GetInteger(uint64_t value, const IntTypeBase* type) {
+    const IntegerKey key{type, value};
+    {
+        std::shared_lock lock(mutex_);
+        auto it = integers_.find(key);
+        if (it != integers_.end()) {
+            return it->second.get();
+        }
+    }
+    std::unique_lock lock(mutex_);
+    auto it = integers_.find(key);
+    if (it != integers_.end()) {
+        return it->second.get();
+    }
+    auto constant = arena_->Make<IntegerConst>(value, type);
+    const IntegerConst* ptr = constant.get();
+    integers_.insert({key, std::move(constant)});
+    return ptr;
+}
+
+const UndefConst* ConstantPool::GetUndef(const Type* type) {
+    {
+        std::shared_lock lock(mutex_);
+        auto it = undefs_.find(type);
+        if (it != undefs_.end()) {
+            return it->second.get();
+        }
+    }
+    std::unique_lock lock(mutex_);
+    auto it = undefs_.find(type);
+    if (it != undefs_.end()) {
+        return it->second.get();
+    }
+    auto constant = arena_->Make<UndefConst>(type);
+    const UndefConst* ptr = constant.get();
+    undefs_.insert({type, std::move(constant)});
+    return ptr;
+}
+
+}  // namespace bier
@@ -0,0 +1,62 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+#include <bier/common.h>
+#include <bier/core/const_value.h>
+#include <shared_mutex>
+
+namespace bier {
+
+// Module-wide storage of constants. Every (type, value) pair is created once, so equal
+// constants are the same object and can be compared by pointer. Safe to use from several
+// threads.
+class ConstantPool {
+public:
+    explicit ConstantPool(Arena* arena) : arena_(arena) {
+        assert(arena_ != nullptr);
+    }
+    ConstantPool(const ConstantPool&) = delete;
+    ConstantPool& operator=(const ConstantPool&) = delete;
+
+    const IntegerConst* GetInteger(uint64_t value, const IntTypeBase* type);
+    const UndefConst* GetUndef(const Type* type);
+
+    std::size_t Size() const {
+        std::shared_lock lock(mutex_);
+        return integers_.size() + undefs_.size();
+    }
+
+private:
+    struct IntegerKey {
+        struct Hash {
+            HashType operator()(const IntegerKey& key) const;
+        };
+
+        const IntTypeBase* type = nullptr;
+        uint64_t value = 0;
+
+        bool operator==(const IntegerKey& other) const {
+            return type == other.type && value == other.value;
+        }
+    };
+
+    mutable std::shared_mutex mutex_;
+    Arena* arena_ = nullptr;
+    HashMap<IntegerKey, ArenaPtr<IntegerConst>> integers_;
+    StdHashMap<const Type*, ArenaPtr<UndefConst>> undefs_;
+};
+
+}  // namespace bier
@@ -17,18 +17,24 @@
 #include <bier/core/exceptions.h>
 #include <bier/utils/streaming_utils.h>
 #include <boost/functional/hash.hpp>
+#include <algorithm>
 #include <sstream>
 
 namespace bier {
 
 HashType FunctionType::HashPtr::operator()(const FunctionType* type) const {
     assert(type != nullptr);
+    return FunctionType::Hash(type->return_type_, type->arguments_);
+}
+
+HashType FunctionType::Hash(std::optional<const Type*> return_type,
+                            const std::vector<const Type*>& arguments) {
     HashType hash = 0;
-    boost::hash_combine(hash, type->return_type_.has_value());
-    if (type->return_type_.has_value()) {
-        boost::hash_combine(hash, type->return_type_.value());
+    boost::hash_combine(hash, return_type.has_value());
+    if (return_type.has_value()) {
+        boost::hash_combine(hash, return_type.value());
     }
-    for (const Type* arg : type->arguments_) {
+    for (const Type* arg : arguments) {
         boost::hash_combine(hash, arg);
     }
     return hash;
@@ -36,7 +42,7 @@ HashType FunctionType::HashPtr::operator()(const FunctionType* type) const {
 
 FunctionType::FunctionType(std::optional<const Type*> return_type,
                            const std::vector<const Type*>& arguments)
-    : arguments_(arguments), return_type_(return_type) {
+    : Type(Kind::FUNCTION), arguments_(arguments), return_type_(return_type) {
 }
 
 std::string FunctionType::ToString() const {
@@ -57,14 +63,15 @@ HashType FunctionSignature::HashPtr::operator()(const FunctionSignature* signatu
     assert(signature != nullptr);
     HashType hash = 0;
     boost::hash_combine(hash, signature->FuncType());
-    boost::hash_combine(hash, signature->Name());
+    boost::hash_combine(hash, signature->GetSymbol().Id());
     return hash;
 }
 
-FunctionSignature::FunctionSignature(const std::string& name, const FunctionType* type)
-    : type_(type), name_(name) {
+FunctionSignature::FunctionSignature(Symbol name, const FunctionType* type)
+    : Value(Kind::FUNCTION_SIGNATURE), type_(type), name_(name) {
     for (const Type* arg : type->Arguments()) {
         arguments_.push_back(std::make_unique<ArgumentValue>(arg));
+        arguments_.back()->index_ = arguments_.size() - 1;
     }
 }
 
@@ -76,7 +83,7 @@ const Type* FunctionSignature::GetType() const {
     return FuncType();
 }
 
-std::string FunctionSignature::GetName() const {
+const std::string& FunctionSignature::GetName() const {
     return Name();
 }
 
@@ -88,67 +95,95 @@ const Type* Function::GetType() const {
     return signature_->FuncType();
 }
 
-std::string Function::GetName() const {
+const std::string& Function::GetName() const {
     return signature_->Name();
 }
 
 BasicBlock* Function::CreateBlock(const std::string& label, BasicBlock* insertAfter) {
-    if (insertAfter == nullptr) {
-        insertAfter = last_block_;
-    }
-
-    const std::string block_label = label_names_.Allocate(label, true);
-    auto block = std::make_unique<BasicBlock>(this, block_label);
-
-    if (insertAfter == nullptr) {
+    if (blocks_.empty()) {
         AllocateArgumentVariables();
-        first_block_ = std::move(block);
-        last_block_ = first_block_.get();
-        return last_block_;
-    }
-    insertAfter->InsertNext(std::move(block));
-    if (last_block_ == insertAfter) {
-        last_block_ = last_block_->Next();
     }
-    return insertAfter->Next();
+    const Symbol block_label = label_names_.Allocate(label, true);
+    auto block = std::make_unique<BasicBlock>(this, block_label);
+    block->index_ = next_block_index_++;
+    MarkModified();
+    auto position = insertAfter == nullptr ? blocks_.end()
+                                           : std::next(blocks_.MakeIterator(insertAfter));
+    return *blocks_.Insert(position, std::move(block));
 }
 
 BasicBlock* Function::CreateBlockAtStart(const std::string& label) {
-    const std::string block_label = label_names_.Allocate(label, true);
+    if (blocks_.empty()) {
+        AllocateArgumentVariables();
+    }
+    const Symbol block_label = label_names_.Allocate(label, true);
     auto block = std::make_unique<BasicBlock>(this, block_label);
-    block->Attach(std::move(first_block_));
-    first_block_ = std::move(block);
-
-    return first_block_.get();
-}
-
-OneWayIteratorRange<BasicBlock> Function::GetBlocks() const {
-    return OneWayIteratorRange<BasicBlock>(first_block_.get());
+    block->index_ = next_block_index_++;
+    MarkModified();
+    blocks_.PushFront(std::move(block));
+    return blocks_.front();
+}
+
+void Function::EraseBlock(BasicBlock* block) {
+    assert(block->GetContextFunction() == this);
+    const auto& predecessors = block->Predecessors();
+    check(std::all_of(predecessors.begin(), predecessors.end(),
+                      [block](const BasicBlock* predecessor) { return predecessor == block; }),
+          IRException("erasing block which is still branched to", this, block));
+    while (!block->Successors().empty()) {
+        block->RemoveEdge(block->Successors().back());
+    }
+    blocks_.Erase(blocks_.MakeIterator(block));
+    MarkModified();
 }
 
-OneWayIteratorRange<BasicBlock> Function::GetBlocks() {
-    return OneWayIteratorRange<BasicBlock>(first_block_.get());
+void Function::MoveBlock(BasicBlock* block, BasicBlock* insert_after) {
+    assert(block->GetContextFunction() == this);
+    if (block == insert_after) {
+        return;
+    }
+    auto position = insert_after == nullptr ? blocks_.begin()
+                                            : std::next(blocks_.MakeIterator(insert_after));
+    auto it = blocks_.MakeIterator(block);
+    if (position == it) {
+        return;
+    }
+    blocks_.Splice(position, blocks_, it, std::next(it));
+    MarkModified();
 }
 
 const Variable* Function::AllocateVariable(const Variable::Metadata& metadata) {
     check(!metadata.is_mutable || !metadata.name.empty(),
           IRException("mutable variable should have a name", this));
-    Variable::Metadata data = metadata;
-    const bool create_new = !data.is_mutable;
-    data.name = variable_names_.Allocate(data.name, create_new);
-    if (ContainerHas(variables_, data.name)) {
-        return variables_.at(data.name).get();
+    const bool create_new = !metadata.is_mutable;
+    const Symbol name = variable_names_.Allocate(metadata.name, create_new);
+    auto it = variables_.find(name);
+    if (it != variables_.end()) {
+        return it->second.get();
     }
-    auto var = std::make_unique<Variable>(data);
-    const Variable* varPtr = var.get();
-    variables_.insert({ varPtr->GetName(), std::move(var) });
-    return varPtr;
+    return AddVariable(name, metadata);
 }
 
 void Function::Normalize() {
     ClearLostVariables();
 }
 
+void Function::Renumber() {
+    next_value_index_ = signature_->Arguments().Size();
+    for (auto& [name, variable] : variables_) {
+        variable->index_ = next_value_index_++;
+    }
+    next_operation_index_ = 0;
+    next_block_index_ = 0;
+    for (BasicBlock* block : GetBlocks()) {
+        block->index_ = next_block_index_++;
+        for (Operation* op : block->GetOperations()) {
+            op->index_ = next_operation_index_++;
+        }
+    }
+    MarkModified();
+}
+
 void Function::AllocateArgumentVariables() {
     for (const auto arg : signature_->Arguments()) {
         check(!arg->GetName().empty(), IRException("please, name your argument variables",
@@ -158,43 +193,40 @@ void Function::AllocateArgumentVariables() {
 }
 
 const Variable* Function::AllocateUnique(const Variable::Metadata& metadata) {
-    variable_names_.AllocateUnique(metadata.name);
-    auto var = std::make_unique<Variable>(metadata);
+    const Symbol name = variable_names_.AllocateUnique(metadata.name);
+    return AddVariable(name, metadata);
+}
+
+const Variable* Function::AddVariable(Symbol name, const Variable::Metadata& metadata) {
+    auto var = arena_.Make<Variable>(name, metadata.type, metadata.is_mutable);
+    var->index_ = next_value_index_++;
+    var->function_ = this;
+    // Not referenced by any operation yet
+    var->OnUnreferenced();
+    MarkModified();
     const Variable* varPtr = var.get();
-    variables_.insert({varPtr->GetName(), std::move(var)});
+    variables_.insert({name, std::move(var)});
     return varPtr;
 }
 
 void Function::ClearLostVariables() {
-    StdHashSet<const Value*> values;
-    for (const auto& block : GetBlocks()) {
-        for (const auto& op : block.GetOperations()) {
-            for (const Value* value : op->GetArguments()) {
-                values.insert(value);
-            }
-            if (op->GetReturnValue().has_value()) {
-                values.insert(op->GetReturnValue().value());
-            }
+    // Only variables that lost their last reference since the previous call are checked
+    std::vector<const Variable*> candidates;
+    candidates.swap(lost_variables_);
+    for (const Variable* var : candidates) {
+        var->lost_candidate_ = false;
+        if (var->GetReferenceCount() == 0) {
+            variables_.erase(var->GetSymbol());
+            MarkModified();
         }
     }
-
-    std::vector<std::string> varsToDelete;
-    for (const auto& [name, var] : variables_) {
-        if (!ContainerHas(values, var.get())) {
-            varsToDelete.push_back(name);
-        }
-    }
-
-    for (const auto& name : varsToDelete) {
-        variables_.erase(name);
-    }
 }
 
 const Type* ArgumentValue::GetType() const {
     return data_->type;
 }
 
-std::string ArgumentValue::GetName() const {
+const std::string& ArgumentValue::GetName() const {
     return data_->name;
 }
 
@@ -202,7 +234,7 @@ const Type* FunctionPointer::GetType() const {
     return signature_->GetType();
 }
 
-std::string FunctionPointer::GetName() const {
+const std::string& FunctionPointer::GetName() const {
     return signature_->GetName();
 }
 
@@ -210,4 +242,12 @@ bool FunctionPointer::IsMutable() const {
     return signature_->IsMutable();
 }
 
+std::size_t Function::CountOperations() const {
+    std::size_t count = 0;
+    for (const BasicBlock* block : GetBlocks()) {
+        count += block->GetOperations().Size();
+    }
+    return count;
+}
+
 }  // namespace bier
@@ -16,6 +16,7 @@
 #pragma once
 #include <bier/common.h>
 #include <bier/core/basic_block.h>
+#include <bier/core/constant_pool.h>
 #include <bier/core/type.h>
 #include <bier/core/value.h>
 #include <bier/core/variable.h>
@@ -34,6 +35,9 @@ public:
     struct HashPtr {
         HashType operator()(const FunctionType* type) const;
     };
+    // Same as HashPtr, without constructing the type
+    static HashType Hash(std::optional<const Type*> return_type,
+                         const std::vector<const Type*>& arguments);
     struct PredPtr {
         constexpr bool operator()(const FunctionType* left, const FunctionType* right) const {
             return left->return_type_ == right->return_type_ &&
@@ -44,6 +48,10 @@ public:
     explicit FunctionType(std::optional<const Type*> return_type = std::nullopt,
                           const std::vector<const Type*>& arguments = {});
 
+    static bool classof(const Type* type) {
+        return type->GetKind() == Kind::FUNCTION;
+    }
+
     std::string ToString() const override;
 
     const std::vector<const Type*>& Arguments() const {
@@ -68,12 +76,17 @@ struct ArgumentData {
 
 class ArgumentValue : public Value {
 public:
-    explicit ArgumentValue(const Type* argType) : data_(std::make_unique<ArgumentData>(argType)) {
+    explicit ArgumentValue(const Type* argType)
+        : Value(Kind::ARGUMENT), data_(std::make_unique<ArgumentData>(argType)) {
+    }
+
+    static bool classof(const Value* value) {
+        return value->GetKind() == Kind::ARGUMENT;
     }
 
     // Value interface
     const Type* GetType() const override;
-    std::string GetName() const override;
+    const std::string& GetName() const override;
     bool IsMutable() const override {
         return false;
     }
@@ -100,19 +113,26 @@ public:
         }
     };
 
-    FunctionSignature(const std::string& name, const FunctionType* type);
+    FunctionSignature(Symbol name, const FunctionType* type);
+
+    static bool classof(const Value* value) {
+        return value->GetKind() == Kind::FUNCTION_SIGNATURE;
+    }
 
     std::string ToString() const;
     const FunctionType* FuncType() const {
         return type_;
     }
     const std::string& Name() const {
+        return name_.Str();
+    }
+    Symbol GetSymbol() const {
         return name_;
     }
 
     // Value interface
     const Type* GetType() const override;
-    std::string GetName() const override;
+    const std::string& GetName() const override;
     bool IsMutable() const override;
 
     std::optional<const Type*> ReturnType() const {
@@ -129,18 +149,22 @@ public:
 private:
     std::vector<ArgValuePtr> arguments_;
     const FunctionType* type_;
-    std::string name_;
+    Symbol name_;
 };
 
 class FunctionPointer : public Value {
 public:
     explicit FunctionPointer(const FunctionSignature* function)
-        : signature_(function) {
+        : Value(Kind::FUNCTION_POINTER), signature_(function) {
+    }
+
+    static bool classof(const Value* value) {
+        return value->GetKind() == Kind::FUNCTION_POINTER;
     }
 
     // Value interface
     const Type* GetType() const override;
-    std::string GetName() const override;
+    const std::string& GetName() const override;
     bool IsMutable() const override;
 
     const FunctionSignature* GetFunc() const {
@@ -153,16 +177,24 @@ private:
 
 class Function : public Value {
 public:
-    explicit Function(FunctionSignature* signature)
-        : variable_names_(this),
-          label_names_(this),
-          signature_(signature) {
-        assert(signature != nullptr);
+    // Names and constants are shared with the owning module
+    Function(FunctionSignature* signature, SymbolTable* symbols, ConstantPool* constants)
+        : Value(Kind::FUNCTION),
+          variable_names_(this, symbols),
+          label_names_(this, symbols),
+          signature_(signature),
+          constants_(constants),
+          next_value_index_(signature->Arguments().Size()) {
+        assert(constants != nullptr);
+    }
+
+    static bool classof(const Value* value) {
+        return value->GetKind() == Kind::FUNCTION;
     }
 
     // Value function
     const Type* GetType() const override;
-    std::string GetName() const override;
+    const std::string& GetName() const override;
     bool IsMutable() const override {
         return false;
     }
@@ -174,30 +206,108 @@ public:
         return signature_;
     }
 
+    using BlockContainer = IntrusiveDList<BasicBlock>;
+
     BasicBlock* CreateBlock(const std::string& label = "", BasicBlock* insertAfter = nullptr);
     BasicBlock* CreateBlockAtStart(const std::string& label = "");
-    OneWayIteratorRange<BasicBlock> GetBlocks() const;
-    OneWayIteratorRange<BasicBlock> GetBlocks();
+    // Destroys a block nothing branches to anymore
+    void EraseBlock(BasicBlock* block);
+    // Moves block right after insert_after, to the start if it is nullptr
+    void MoveBlock(BasicBlock* block, BasicBlock* insert_after);
+    auto GetBlocks() const {
+        return IteratorRange(blocks_);
+    }
+    auto GetBlocks() {
+        return MutableIteratorRange<BlockContainer>(blocks_);
+    }
+    const BasicBlock* GetEntryBlock() const {
+        return blocks_.front();
+    }
+    BasicBlock* GetEntryBlock() {
+        return blocks_.front();
+    }
 
     const Variable* AllocateVariable(const Variable::Metadata& metadata);
 
+    ConstantPool* Constants() {
+        return constants_;
+    }
+
+    // All operations of the function should be allocated in its arena
+    template <typename TOperation, typename... Args>
+    ArenaPtr<TOperation> MakeOperation(Args&&... args) {
+        auto operation = arena_.Make<TOperation>(std::forward<Args>(args)...);
+        operation->index_ = next_operation_index_++;
+        return operation;
+    }
+    Arena& GetArena() {
+        return arena_;
+    }
+    const Arena& GetArena() const {
+        return arena_;
+    }
+
     auto GetVariables() const {
         return IteratorRange(variables_);
     }
 
     void Normalize();
 
+    // Upper bounds of dense indices of values (arguments and variables) and operations
+    std::uint32_t ValueIndexBound() const {
+        return next_value_index_;
+    }
+    std::uint32_t OperationIndexBound() const {
+        return next_operation_index_;
+    }
+    std::uint32_t BlockIndexBound() const {
+        return next_block_index_;
+    }
+    // Closes gaps left by deleted variables, operations and blocks. Invalidates dense maps.
+    void Renumber();
+    // Operations in all of the blocks
+    std::size_t CountOperations() const;
+
+    // Bumped by every edit of the function body
+    std::uint64_t GetVersion() const {
+        return version_;
+    }
+    void MarkModified() const {
+        ++version_;
+    }
+
 private:
-    StdHashMap<std::string, VariablePtr> variables_;
+    friend class Variable;
+
+    // Should outlive everything allocated in it, hence declared first
+    Arena arena_;
+    HashMap<Symbol, VariablePtr> variables_;
+    // Candidates for ClearLostVariables, must outlive the blocks
+    std::vector<const Variable*> lost_variables_;
     VariableNameStorage variable_names_;
     VariableNameStorage label_names_;
-    BasicBlockPtr first_block_;
-    BasicBlock* last_block_ = nullptr;
+    BlockContainer blocks_;
     FunctionSignature* signature_ = nullptr;
+    ConstantPool* constants_ = nullptr;
+    std::uint32_t next_value_index_ = 0;
+    std::uint32_t next_operation_index_ = 0;
+    std::uint32_t next_block_index_ = 0;
+    mutable std::uint64_t version_ = 0;
 
     void AllocateArgumentVariables();
     const Variable* AllocateUnique(const Variable::Metadata& metadata);
+    const Variable* AddVariable(Symbol name, const Variable::Metadata& metadata);
     void ClearLostVariables();
 };
 
+// Maps keyed by dense indices of one function
+template <typename T>
+using DenseValueMap = DenseIndexMap<Value, T>;
+using DenseValueSet = DenseIndexSet<Value>;
+template <typename T>
+using DenseOperationMap = DenseIndexMap<Operation, T>;
+template <typename T>
+using DenseBlockMap = DenseIndexMap<BasicBlock, T>;
+using DenseBlockSet = DenseIndexSet<BasicBlock>;
+
 }  // namespace bier
@@ -21,6 +21,13 @@ namespace bier {
 
 class IntTypeBase : public Type {
 public:
+    IntTypeBase() : Type(Kind::INTEGER) {
+    }
+
+    static bool classof(const Type* type) {
+        return type->GetKind() == Kind::INTEGER;
+    }
+
     bool IsValid(int64_t value) const {
         return IsValid(static_cast<uint64_t>(value));
     }
@@ -42,7 +42,7 @@ public:
     int AddArray(const Type* type, int count);
     int Add(const LayoutEntry& entry);
     int Add(const Layout* layout);
-    void SetName(const std::string& name) {
+    void SetName(Symbol name) {
         name_ = name;
     }
 
@@ -51,7 +51,7 @@ public:
         return IteratorRange(entries_);
     }
     const std::string& Name() const {
-        return name_;
+        return name_.Str();
     }
     int GetOffset(int idx, int element_offset) const {
         return offsets_[idx] + element_offset;
@@ -60,7 +60,7 @@ public:
 private:
     std::vector<LayoutEntry> entries_;
     std::vector<int> offsets_;
-    std::string name_;
+    Symbol name_;
 
     int GetNextOffset() const;
 };
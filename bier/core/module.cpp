@@ -18,7 +18,7 @@
 namespace bier {
 
 Module::Module(std::unique_ptr<TypeRegistryInterface>&& typeRegistry)
-    : types_(std::move(typeRegistry)) {
+    : constants_(&arena_), types_(std::move(typeRegistry)) {
 }
 
 const Layout* Module::AddAnnonymousLayout(LayoutPtr&& layout) {
@@ -36,8 +36,9 @@ const Layout* Module::AddAnnonymousLayout(const std::vector<Layout::LayoutEntry>
 
 const Layout* Module::AddNamedLayout(LayoutPtr&& layout, const std::string& name) {
     const Layout* ptr = layout.get();
-    layout->SetName(name);
-    named_layouts_.insert({name, std::move(layout)});
+    const Symbol symbol = symbols_.Intern(name);
+    layout->SetName(symbol);
+    named_layouts_.insert({symbol, std::move(layout)});
     return ptr;
 }
 
@@ -45,9 +46,10 @@ const Layout* Module::AddNamedLayout(const std::vector<Layout::LayoutEntry>& ent
                                      const std::string& name) {
     auto layout = MakeLayout(entries);
     const Layout* ptr = layout.get();
-    layout->SetName(name);
-    check(!ContainerHas(named_layouts_, name), IRException("Named layout with name " + name + " is already defined"));
-    named_layouts_.insert({name, std::move(layout)});
+    const Symbol symbol = symbols_.Intern(name);
+    layout->SetName(symbol);
+    check(!ContainerHas(named_layouts_, symbol), IRException("Named layout with name " + name + " is already defined"));
+    named_layouts_.insert({symbol, std::move(layout)});
     return ptr;
 }
 
@@ -60,49 +62,57 @@ FunctionSignature* Module::AddExternalFunction(const std::string& name,
 
 Function* Module::AddFunction(const std::string& name, const FunctionType* function_type) {
     FunctionSignature* signature = AddSignature(name, function_type);
-    auto function = std::make_unique<Function>(signature);
+    auto function = arena_.Make<Function>(signature, &symbols_, &constants_);
     Function* functionPtr = function.get();
     functions_.insert({signature, std::move(function)});
     return functionPtr;
 }
 
 bool Module::HasFunction(const std::string& name) const {
-    return ContainerHas(function_sigs_, name);
+    return FindByName(function_sigs_, name) != function_sigs_.end();
 }
 
 Function* Module::GetFunction(const std::string& name) {
-    check(ContainerHas(function_sigs_, name), IRException("unknown function " + name));
-    const FunctionSignature* signature = function_sigs_.at(name).get();
-    check(ContainerHas(functions_, signature), IRException("unknown function " + name));
-    return functions_.at(signature).get();
+    auto it = FindByName(function_sigs_, name);
+    check(it != function_sigs_.end(), IRException("unknown function " + name));
+    return GetFunction(it->second.get());
+}
+
+Function* Module::GetFunction(const FunctionSignature* signature) {
+    auto it = functions_.find(signature);
+    check(it != functions_.end(), IRException("unknown function " + signature->Name()));
+    return it->second.get();
 }
 
 const FunctionSignature* Module::GetFunctionSignature(const std::string& name) {
-    check(ContainerHas(function_sigs_, name), IRException("unknown function " + name));
-    return function_sigs_.at(name).get();
+    auto it = FindByName(function_sigs_, name);
+    check(it != function_sigs_.end(), IRException("unknown function " + name));
+    return it->second.get();
 }
 
 StaticData* Module::AddStaticData(const std::string& name, const Layout* layout) {
     check(!name.empty(), IRException("static data should be named"));
-    check(!ContainerHas(static_data_, name), IRException("static with name " + name + " is already defined"));
-    auto data = std::make_unique<StaticData>(types_->DefaultTypes(), layout, name);
+    const Symbol symbol = symbols_.Intern(name);
+    check(!ContainerHas(static_data_, symbol), IRException("static with name " + name + " is already defined"));
+    auto data = arena_.Make<StaticData>(types_->DefaultTypes(), layout, symbol);
     StaticData* ptr = data.get();
-    static_data_.insert({name, std::move(data)});
+    static_data_.insert({symbol, std::move(data)});
     return ptr;
 }
 
 const StaticData* Module::GetStaticData(const std::string& name) const {
-    check(ContainerHas(static_data_, name), IRException("static data " + name
-                                                        + " is not defined"));
-    return static_data_.at(name).get();
+    auto it = FindByName(static_data_, name);
+    check(it != static_data_.end(), IRException("static data " + name + " is not defined"));
+    return it->second.get();
 }
 
 FunctionSignature* Module::AddSignature(const std::string& name, const FunctionType* functionType) {
     check(types_->Has(functionType), IRException("Not registered in module"));
-    check(!ContainerHas(function_sigs_, name),
+    const Symbol symbol = symbols_.Intern(name);
+    check(!ContainerHas(function_sigs_, symbol),
           IRException(name + " already registered in the module"));
-    FunctionSigPtr functionSignature = std::make_unique<FunctionSignature>(name, functionType);
-    return function_sigs_.insert({name, std::move(functionSignature)}).first->second.get();
+    FunctionSigPtr functionSignature = arena_.Make<FunctionSignature>(symbol, functionType);
+    return function_sigs_.insert({symbol, std::move(functionSignature)}).first->second.get();
 }
 
 LayoutPtr Module::MakeLayout(const std::vector<Layout::LayoutEntry>& entries) const {
@@ -114,4 +124,12 @@ LayoutPtr Module::MakeLayout(const std::vector<Layout::LayoutEntry>& entries) co
     return layout;
 }
 
+std::size_t Module::CountOperations() const {
+    std::size_t count = 0;
+    for (const auto& [signature, function] : functions_) {
+        count += function->CountOperations();
+    }
+    return count;
+}
+
 }  // namespace bier
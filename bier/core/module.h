@@ -51,9 +51,9 @@ public:
     const Layout* AddNamedLayout(const std::vector<Layout::LayoutEntry>& entries,
                                  const std::string& name);
     const Layout* GetNamedLayout(const std::string& name) const {
-        check(ContainerHas(named_layouts_, name),
-              IRException("unknown layout \"" + name + "\""));
-        return named_layouts_.at(name).get();
+        auto it = FindByName(named_layouts_, name);
+        check(it != named_layouts_.end(), IRException("unknown layout \"" + name + "\""));
+        return it->second.get();
     }
 
     // Functions
@@ -62,7 +62,9 @@ public:
     Function* AddFunction(const std::string& name, const FunctionType* function_type);
 
     const FunctionSignature* GetFunctionSignature(const std::string& name) const {
-        return function_sigs_.at(name).get();
+        auto it = FindByName(function_sigs_, name);
+        assert(it != function_sigs_.end());
+        return it->second.get();
     }
 
     auto GetDeclaredFunctions() const {
@@ -73,6 +75,9 @@ public:
         return IteratorRange(functions_);
     }
 
+    // Operations in all of the defined functions
+    std::size_t CountOperations() const;
+
     auto GetExternalFunctions() const {
         return IteratorRange(external_functions_);
     }
@@ -81,12 +86,18 @@ public:
         return IteratorRange(anonymous_layouts_);
     }
 
+    // Serialize edits of use lists shared by the functions within a ConcurrentEditScope
+    SharedUseLocks* GetSharedUseLocks() const {
+        return &shared_use_locks_;
+    }
+
     auto GetNamedLayouts() const {
         return IteratorRange(named_layouts_);
     }
 
     bool HasFunction(const std::string& name) const;
     Function* GetFunction(const std::string& name);
+    Function* GetFunction(const FunctionSignature* signature);
     const FunctionSignature* GetFunctionSignature(const std::string& name);
 
     bool IsExternalFunction(const FunctionSignature* signature) const {
@@ -100,14 +111,46 @@ public:
     }
     const StaticData* GetStaticData(const std::string& name) const;
 
+    // Module-level data (signatures, function bodies, static data) is allocated here
+    const Arena& GetArena() const {
+        return arena_;
+    }
+
+    ConstantPool* Constants() {
+        return &constants_;
+    }
+    const ConstantPool& Constants() const {
+        return constants_;
+    }
+
+    // Names of functions, variables, labels, layouts and static data
+    const SymbolTable& Symbols() const {
+        return symbols_;
+    }
+    SymbolTable* Symbols() {
+        return &symbols_;
+    }
+
 private:
+    // Should outlive everything allocated in it, hence declared first
+    Arena arena_;
+    SymbolTable symbols_;
+    ConstantPool constants_;
     std::unique_ptr<TypeRegistryInterface> types_;
     StdHashSet<LayoutPtr> anonymous_layouts_;
-    StdHashMap<std::string, LayoutPtr> named_layouts_;
-    StdHashMap<std::string, FunctionSigPtr> function_sigs_;
+    HashMap<Symbol, LayoutPtr> named_layouts_;
+    HashMap<Symbol, FunctionSigPtr> function_sigs_;
     HashPtrMap<FunctionSignature, FunctionPtr> functions_;
     StdHashSet<const FunctionSignature*> external_functions_;
-    StdHashMap<std::string, StaticDataPtr> static_data_;
+    HashMap<Symbol, StaticDataPtr> static_data_;
+    mutable SharedUseLocks shared_use_locks_;
+
+    // Does not intern unknown names
+    template <typename TMap>
+    typename TMap::const_iterator FindByName(const TMap& map, const std::string& name) const {
+        auto symbol = symbols_.Find(name);
+        return symbol.has_value() ? map.find(symbol.value()) : map.end();
+    }
 
     FunctionSignature* AddSignature(const std::string& name, const FunctionType* functionType);
     LayoutPtr MakeLayout(const std::vector<Layout::LayoutEntry>& entries) const;
@@ -14,18 +14,38 @@
    limitations under the License.
 */
 #include "operation.h"
+#include <bier/core/basic_block.h>
+#include <bier/core/function.h>
 #include <bier/operations/opcodes.h>
 #include <cassert>
 
 namespace bier {
 
+void Operation::SubstituteArguments(const std::vector<const Value*>& args) {
+    assert(args.size() == operands_count_);
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        operands_[i].Set(args[i]);
+    }
+}
+
+void Operation::SetSuccessor(std::size_t index, BasicBlock* block) {
+    assert(index < successors_count_);
+    assert(block != nullptr);
+    if (block_ != nullptr) {
+        block_->RemoveEdge(successors_[index]);
+        block_->AddEdge(block);
+        block_->GetContextFunction()->MarkModified();
+    }
+    successors_[index] = block;
+}
+
 BinaryOperation::BinaryOperation(const Function* context_func, BinaryOperation::BinOp op,
                                  const Value* left, const Value* right, const Variable* return_value)
     : context_function_(context_func),
-      left_value_(left),
-      right_value_(right),
-      return_value_(return_value),
+      arguments_{Use(this, left), Use(this, right)},
+      return_value_(this, return_value, Use::Kind::RESULT),
       op_(op) {
+    SetOperandStorage(arguments_, 2);
     assert(context_func != nullptr);
     assert(left != nullptr);
     assert(right != nullptr);
@@ -37,23 +57,13 @@ const Function* BinaryOperation::GetContextFunction() const {
     return context_function_;
 }
 
-std::vector<const Value*> BinaryOperation::GetArguments() const {
-    return {left_value_, right_value_};
-}
-
-void BinaryOperation::SubstituteArguments(const std::vector<const Value*>& args) {
-    assert(args.size() == 2);
-    left_value_ = args[0];
-    right_value_ = args[1];
-}
-
 std::optional<const Variable*> BinaryOperation::GetReturnValue() const {
-    return return_value_ == nullptr ? std::nullopt : std::make_optional(return_value_);
+    return ResultOf(return_value_);
 }
 
 void BinaryOperation::SubstituteReturnValue(const Variable* return_value) {
     assert(GetReturnValue().has_value());
-    return_value_ = return_value;
+    return_value_.Set(return_value);
 }
 
 int BinaryOperation::OpCode() const {
@@ -68,7 +78,11 @@ int BinaryOperation::OpCode() const {
 
 UnaryOperation::UnaryOperation(const Function* context_func, UnaryOperation::UnOp op,
                                const Value* argument, const Variable* return_value)
-    : context_function_(context_func), argument_(argument), return_value_(return_value), op_(op) {
+    : context_function_(context_func),
+      argument_{Use(this, argument)},
+      return_value_(this, return_value, Use::Kind::RESULT),
+      op_(op) {
+    SetOperandStorage(argument_, 1);
     assert(context_func != nullptr);
     assert(argument != nullptr);
     assert(return_value != nullptr);
@@ -79,21 +93,12 @@ const Function* UnaryOperation::GetContextFunction() const {
     return context_function_;
 }
 
-std::vector<const Value*> UnaryOperation::GetArguments() const {
-    return {argument_};
-}
-
-void UnaryOperation::SubstituteArguments(const std::vector<const Value*>& args) {
-    assert(args.size() == 1);
-    argument_ = args.front();
-}
-
 std::optional<const Variable*> UnaryOperation::GetReturnValue() const {
-    return return_value_;
+    return ResultOf(return_value_);
 }
 
 void UnaryOperation::SubstituteReturnValue(const Variable* return_value) {
-    return_value_ = return_value;
+    return_value_.Set(return_value);
 }
 
 int UnaryOperation::OpCode() const {
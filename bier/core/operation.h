@@ -17,19 +17,104 @@
 
 #include <bier/core/function_context.h>
 #include <bier/core/variable.h>
+#include <bier/utils/intrusive_list.h>
 #include <vector>
 
 namespace bier {
 
-class Operation : public FunctionContextMemeber {
+// Blocks a branch may transfer control to, stored inside the operation
+class SuccessorRange {
 public:
-    virtual std::vector<const Value*> GetArguments() const = 0;
-    virtual void SubstituteArguments(const std::vector<const Value*>& args) = 0;
+    SuccessorRange(BasicBlock* const* successors, std::size_t count)
+        : begin_(successors), end_(successors + count) {
+    }
+
+    BasicBlock* const* begin() const {
+        return begin_;
+    }
+    BasicBlock* const* end() const {
+        return end_;
+    }
+    std::size_t size() const {
+        return end_ - begin_;
+    }
+    bool empty() const {
+        return begin_ == end_;
+    }
+    BasicBlock* operator[](std::size_t index) const {
+        assert(index < size());
+        return begin_[index];
+    }
+
+private:
+    BasicBlock* const* begin_;
+    BasicBlock* const* end_;
+};
+
+class Operation : public FunctionContextMemeber, public IntrusiveDListNode<Operation> {
+public:
+    // Operands are stored inside the operation, walking them does not allocate
+    OperandRange GetArguments() const {
+        return OperandRange(operands_, operands_count_);
+    }
+    void SetOperand(std::size_t index, const Value* value) {
+        assert(index < operands_count_);
+        operands_[index].Set(value);
+    }
+    void SubstituteArguments(const std::vector<const Value*>& args);
+
+    // Empty for everything but branches
+    SuccessorRange GetSuccessors() const {
+        return SuccessorRange(successors_, successors_count_);
+    }
+    // Retargets the branch, edges of the block it is inserted to are updated
+    void SetSuccessor(std::size_t index, BasicBlock* block);
 
     virtual std::optional<const Variable*> GetReturnValue() const = 0;
     virtual void SubstituteReturnValue(const Variable* return_value) = 0;
 
     virtual int OpCode() const = 0;
+
+    // Block the operation is currently inserted to
+    const BasicBlock* GetBlock() const {
+        return block_;
+    }
+    BasicBlock* GetBlock() {
+        return block_;
+    }
+
+    // Dense index within the function that created the operation
+    std::uint32_t GetIndex() const {
+        return index_;
+    }
+
+protected:
+    void SetOperandStorage(Use* operands, std::size_t count) {
+        operands_ = operands;
+        operands_count_ = count;
+    }
+    void SetSuccessorStorage(BasicBlock** successors, std::size_t count) {
+        successors_ = successors;
+        successors_count_ = count;
+    }
+
+    static std::optional<const Variable*> ResultOf(const Use& result) {
+        if (result.Get() == nullptr) {
+            return std::nullopt;
+        }
+        return static_cast<const Variable*>(result.Get());
+    }
+
+private:
+    friend class BasicBlock;
+    friend class Function;
+
+    BasicBlock* block_ = nullptr;
+    std::uint32_t index_ = kNoDenseIndex;
+    Use* operands_ = nullptr;
+    std::size_t operands_count_ = 0;
+    BasicBlock** successors_ = nullptr;
+    std::size_t successors_count_ = 0;
 };
 
 template <int IOpCode>
@@ -70,24 +155,21 @@ public:
     const Function* GetContextFunction() const override;
 
     // Operation interface
-    std::vector<const Value*> GetArguments() const override;
-    void SubstituteArguments(const std::vector<const Value*>& args) override;
     std::optional<const Variable*> GetReturnValue() const override;
     void SubstituteReturnValue(const Variable* return_value) override;
     int OpCode() const override;
 
     const Value* LeftValue() const {
-        return left_value_;
+        return arguments_[0].Get();
     }
     const Value* RightValue() const {
-        return right_value_;
+        return arguments_[1].Get();
     }
 
 private:
     const Function* context_function_ = nullptr;
-    const Value* left_value_ = nullptr;
-    const Value* right_value_ = nullptr;
-    const Variable* return_value_ = nullptr;
+    Use arguments_[2];
+    Use return_value_;
     BinOp op_ = BinOp::INVALID;
 };
 
@@ -106,16 +188,14 @@ public:
     const Function* GetContextFunction() const override;
 
     // Operation interface
-    std::vector<const Value*> GetArguments() const override;
-    void SubstituteArguments(const std::vector<const Value*>& args) override;
     std::optional<const Variable*> GetReturnValue() const override;
     void SubstituteReturnValue(const Variable* return_value) override;
     int OpCode() const override;
 
 private:
     const Function* context_function_ = nullptr;
-    const Value* argument_ = nullptr;
-    const Variable* return_value_ = nullptr;
+    Use argument_[1];
+    Use return_value_;
     UnOp op_ = UnOp::INVALID;
 };
 
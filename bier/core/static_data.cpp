@@ -18,8 +18,9 @@
 
 namespace bier {
 
-StaticData::StaticData(DefaultTypesRegistry* types, const Layout* layout, const std::string& name)
-    : layout_(layout),
+StaticData::StaticData(DefaultTypesRegistry* types, const Layout* layout, Symbol name)
+    : Value(Kind::STATIC_DATA),
+      layout_(layout),
       name_(name),
       ptrType_(types->GetPtr()) {
     values_.resize(layout_->Entries().Size());
@@ -29,8 +30,8 @@ const Type* StaticData::GetType() const {
     return ptrType_;
 }
 
-std::string StaticData::GetName() const {
-    return name_;
+const std::string& StaticData::GetName() const {
+    return name_.Str();
 }
 
 bool StaticData::IsMutable() const {
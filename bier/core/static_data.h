@@ -21,11 +21,15 @@ namespace bier {
 
 class StaticData : public Value {
 public:
-    StaticData(DefaultTypesRegistry* types, const Layout* layout, const std::string& name);
+    StaticData(DefaultTypesRegistry* types, const Layout* layout, Symbol name);
+
+    static bool classof(const Value* value) {
+        return value->GetKind() == Kind::STATIC_DATA;
+    }
 
     // Value interface
     const Type* GetType() const override;
-    std::string GetName() const override;
+    const std::string& GetName() const override;
     bool IsMutable() const override;
 
     const Layout* GetLayout() const {
@@ -37,11 +41,11 @@ public:
 private:
     std::vector<ValuePtr> values_;
     const Layout* layout_ = nullptr;
-    std::string name_;
+    Symbol name_;
     const Type* ptrType_ = nullptr;
 };
 
-using StaticDataPtr = std::unique_ptr<StaticData>;
+using StaticDataPtr = ArenaPtr<StaticData>;
 
 }   // bier
 
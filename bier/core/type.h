@@ -15,14 +15,27 @@
 */
 #pragma once
 #include <bier/common.h>
+#include <bier/utils/casting.h>
 #include <string>
 
 namespace bier {
 
 class Type {
 public:
+    // Discriminator for isa/cast/dyn_cast
+    enum class Kind { VOID, PTR, TYPED_PTR, INTEGER, FUNCTION };
+
+    explicit Type(Kind kind) : kind_(kind) {
+    }
     virtual ~Type() = default;
     virtual std::string ToString() const = 0;
+
+    Kind GetKind() const {
+        return kind_;
+    }
+
+private:
+    const Kind kind_;
 };
 
 }  // namespace bier
@@ -14,41 +14,25 @@
    limitations under the License.
 */
 #include "types_registry.h"
+#include <iterator>
 
 namespace bier {
 
 DefaultTypesRegistry::DefaultTypesRegistry() {
-    all_types_.insert(&i1_);
-    all_types_.insert(&i8_);
-    all_types_.insert(&i16_);
-    all_types_.insert(&i32_);
-    all_types_.insert(&i64_);
-
-    all_types_.insert(&i1_ptr_);
-    all_types_.insert(&i8_ptr_);
-    all_types_.insert(&i16_ptr_);
-    all_types_.insert(&i32_ptr_);
-    all_types_.insert(&i64_ptr_);
-
-    all_types_.insert(&any_ptr_);
-
-    ptr_types_.insert(&i1_ptr_);
-    ptr_types_.insert(&i8_ptr_);
-    ptr_types_.insert(&i16_ptr_);
-    ptr_types_.insert(&i32_ptr_);
-    ptr_types_.insert(&i64_ptr_);
-
-    type_to_ptr_.insert({&i1_, &i1_ptr_});
-    type_to_ptr_.insert({&i8_, &i8_ptr_});
-    type_to_ptr_.insert({&i16_, &i16_ptr_});
-    type_to_ptr_.insert({&i32_, &i32_ptr_});
-    type_to_ptr_.insert({&i64_, &i64_ptr_});
-
-    ptr_types_.insert(&any_ptr_);
+    const Type* integers[] = {&i1_, &i8_, &i16_, &i32_, &i64_};
+    const Type* integer_ptrs[] = {&i1_ptr_, &i8_ptr_, &i16_ptr_, &i32_ptr_, &i64_ptr_};
+    for (std::size_t i = 0; i < std::size(integers); ++i) {
+        Add(&all_types_, integers[i]);
+        Add(&all_types_, integer_ptrs[i]);
+        Add(&ptr_types_, integer_ptrs[i]);
+        type_to_ptr_.Insert(HashOf(integers[i]), integers[i], integer_ptrs[i]);
+    }
+    Add(&all_types_, &any_ptr_);
+    Add(&ptr_types_, &any_ptr_);
 }
 
 bool DefaultTypesRegistry::Has(const Type* type) const {
-    return ContainerHas(all_types_, type);
+    return all_types_.Find(HashOf(type), type) != nullptr;
 }
 
 const DefaultTypesRegistry* DefaultTypesRegistry::DefaultTypes() const {
@@ -61,17 +45,29 @@ DefaultTypesRegistry* DefaultTypesRegistry::DefaultTypes() {
 
 const FunctionType* DefaultTypesRegistry::MakeFunctionType(
     std::optional<const Type*> return_type, const std::vector<const Type*>& arguments) {
-    auto funcType = std::make_unique<FunctionType>(return_type, arguments);
-    const FunctionType* func_type_ptr = funcType.get();
-    if (ContainerHas(function_types_, func_type_ptr)) {
-        return function_types_.at(func_type_ptr).get();
+    const std::size_t hash = FunctionType::Hash(return_type, arguments);
+    auto matches = [&](const FunctionType* type) {
+        return type->ReturnType() == return_type && type->Arguments() == arguments;
+    };
+    if (const FunctionType* type = function_types_.FindIf(hash, matches)) {
+        return type;
+    }
+
+    std::lock_guard lock(insert_mutex_);
+    if (const FunctionType* type = function_types_.FindIf(hash, matches)) {
+        return type;
     }
+    auto owned = std::make_unique<FunctionType>(return_type, arguments);
+    const FunctionType* type = owned.get();
+    custom_types_.push_back(std::move(owned));
+    Add(&all_types_, type);
+    Add(&ptr_types_, type);
+    function_types_.Insert(hash, type, type);
+    return type;
+}
 
-    function_types_.insert({func_type_ptr, std::move(funcType)});
-    all_types_.insert(func_type_ptr);
-    ptr_types_.insert(func_type_ptr);
-    func_types_.insert(func_type_ptr);
-    return func_type_ptr;
+bool DefaultTypesRegistry::IsPtr(const Type* type) const {
+    return ptr_types_.Find(HashOf(type), type) != nullptr;
 }
 
 bool DefaultTypesRegistry::IsPtrCompatibleWith(const Type* ptr_type,
@@ -79,11 +75,11 @@ bool DefaultTypesRegistry::IsPtrCompatibleWith(const Type* ptr_type,
     if (ptr_type == &any_ptr_) {
         return true;
     }
-    if (ContainerHas(func_types_, ptr_type)) {
+    if (isa<FunctionType>(ptr_type)) {
         return ptr_type == underlying_type;
     }
 
-    const auto typed = dynamic_cast<const TypedPtrType*>(ptr_type);
+    const auto typed = dyn_cast<TypedPtrType>(ptr_type);
     if (typed == nullptr) {
         return false;
     }
@@ -91,13 +87,19 @@ bool DefaultTypesRegistry::IsPtrCompatibleWith(const Type* ptr_type,
 }
 
 const Type* DefaultTypesRegistry::GetPtrTo(const Type* type) {
-    if (ContainerHas(type_to_ptr_, type)) {
-        return type_to_ptr_.at(type);
+    if (const Type* ptr = type_to_ptr_.Find(HashOf(type), type)) {
+        return ptr;
+    }
+
+    std::lock_guard lock(insert_mutex_);
+    if (const Type* ptr = type_to_ptr_.Find(HashOf(type), type)) {
+        return ptr;
     }
-    const Type* ptr = custom_ptrs_.emplace(std::make_unique<TypedPtrType>(type)).first->get();
-    ptr_types_.insert(ptr);
-    all_types_.insert(ptr);
-    type_to_ptr_.insert({type, ptr});
+    custom_types_.push_back(std::make_unique<TypedPtrType>(type));
+    const Type* ptr = custom_types_.back().get();
+    Add(&all_types_, ptr);
+    Add(&ptr_types_, ptr);
+    type_to_ptr_.Insert(HashOf(type), type, ptr);
     return ptr;
 }
 
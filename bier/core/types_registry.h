@@ -18,8 +18,9 @@
 #include <bier/core/basic_types.h>
 #include <bier/core/function.h>
 
+#include <bier/utils/concurrent_ptr_map.h>
+#include <mutex>
 #include <vector>
-#include <unordered_map>
 
 namespace bier {
 
@@ -33,6 +34,8 @@ public:
     virtual DefaultTypesRegistry* DefaultTypes() = 0;
 };
 
+// Interns pointer and function types. Safe to use from several threads: lookups of known
+// types do not lock, creating a new type takes a mutex.
 class DefaultTypesRegistry : public TypeRegistryInterface {
 public:
     DefaultTypesRegistry();
@@ -81,12 +84,10 @@ public:
     const FunctionType* MakeFunctionType(std::optional<const Type*> return_type = std::nullopt,
                                          const std::vector<const Type*>& arguments = {});
 
-    bool IsPtr(const Type* type) const {
-        return ContainerHas(ptr_types_, type);
-    }
+    bool IsPtr(const Type* type) const;
     bool IsPtrCompatibleWith(const Type* ptr_type, const Type* underlying_type) const;
     bool IsInteger(const Type* type) const {
-        return dynamic_cast<const IntTypeBase*>(type) != nullptr;
+        return isa<IntTypeBase>(type);
     }
     const Type* GetPtrTo(const Type* type);
 
@@ -105,12 +106,23 @@ private:
 
     PtrType any_ptr_;
 
-    HashPtrMap<FunctionType, std::unique_ptr<FunctionType>> function_types_;
-    StdHashSet<const Type*> func_types_;
-    StdHashSet<const Type*> all_types_;
-    StdHashSet<const Type*> ptr_types_;
-    StdHashMap<const Type*, const Type*> type_to_ptr_;
-    StdHashSet<TypePtr> custom_ptrs_;
+    using TypeMap = ConcurrentPtrMap<const Type*, const Type*>;
+
+    // Sets are kept as maps of types to themselves
+    TypeMap all_types_;
+    TypeMap ptr_types_;
+    TypeMap type_to_ptr_;
+    ConcurrentPtrMap<const FunctionType*, const FunctionType*> function_types_;
+    // Serializes insertions, guards custom_types_
+    std::mutex insert_mutex_;
+    std::vector<TypePtr> custom_types_;
+
+    static std::size_t HashOf(const Type* type) {
+        return reinterpret_cast<std::uintptr_t>(type);
+    }
+    static void Add(TypeMap* types, const Type* type) {
+        types->Insert(HashOf(type), type, type);
+    }
 };
 
 }  // namespace bier
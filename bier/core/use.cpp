@@ -0,0 +1,164 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "use.h"
+#include <bier/core/function.h>
+#include <bier/core/module.h>
+#include <bier/core/variable.h>
+#include <bier/utils/casting.h>
+
+namespace bier {
+
+namespace {
+
+// Locks of the module the thread edits concurrently with others, nullptr outside of a scope
+thread_local SharedUseLocks* current_locks = nullptr;
+
+// Values referred to from many functions
+bool IsModuleLevel(const Value* value) {
+    return value->GetKind() >= Value::Kind::FUNCTION_SIGNATURE;
+}
+
+std::mutex* SharedLockOf(const Value* value) {
+    if (value == nullptr || current_locks == nullptr || !IsModuleLevel(value)) {
+        return nullptr;
+    }
+    return &current_locks->For(value);
+}
+
+std::unique_lock<std::mutex> LockIfShared(const Value* value) {
+    std::mutex* mutex = SharedLockOf(value);
+    return mutex == nullptr ? std::unique_lock<std::mutex>() : std::unique_lock(*mutex);
+}
+
+}  // namespace
+
+std::mutex& SharedUseLocks::For(const Value* value) {
+    const auto address = reinterpret_cast<std::uintptr_t>(value);
+    return mutexes_[(address >> 4) % mutexes_.size()];
+}
+
+ConcurrentEditScope::ConcurrentEditScope(const Module* module) : previous_(current_locks) {
+    current_locks = module->GetSharedUseLocks();
+}
+
+ConcurrentEditScope::~ConcurrentEditScope() {
+    current_locks = previous_;
+}
+
+Use::Use(Operation* user, const Value* value, Kind kind) : user_(user), kind_(kind) {
+    Set(value);
+}
+
+Use::Use(Use&& other) noexcept : user_(other.user_), kind_(other.kind_) {
+    Set(other.value_);
+    other.Set(nullptr);
+}
+
+Use::~Use() {
+    Unlink();
+}
+
+void Use::Set(const Value* value) {
+    if (value == value_) {
+        return;
+    }
+    Unlink();
+    value_ = value;
+    Link();
+    if (user_ != nullptr && user_->GetBlock() != nullptr) {
+        user_->GetBlock()->GetContextFunction()->MarkModified();
+    }
+}
+
+void Use::Link() {
+    if (value_ == nullptr) {
+        return;
+    }
+    auto lock = LockIfShared(value_);
+    LinkLocked();
+}
+
+void Use::Unlink() {
+    if (value_ == nullptr) {
+        return;
+    }
+    auto lock = LockIfShared(value_);
+    UnlinkLocked();
+}
+
+void Use::LinkLocked() {
+    Use*& head = kind_ == Kind::OPERAND ? value_->uses_ : value_->definitions_;
+    next_ = head;
+    if (next_ != nullptr) {
+        next_->prev_ = this;
+    }
+    head = this;
+    ++value_->references_;
+}
+
+void Use::UnlinkLocked() {
+    if (prev_ != nullptr) {
+        prev_->next_ = next_;
+    } else {
+        Use*& head = kind_ == Kind::OPERAND ? value_->uses_ : value_->definitions_;
+        head = next_;
+    }
+    if (next_ != nullptr) {
+        next_->prev_ = prev_;
+    }
+    prev_ = nullptr;
+    next_ = nullptr;
+    if (--value_->references_ == 0) {
+        if (auto variable = dyn_cast<Variable>(value_)) {
+            variable->OnUnreferenced();
+        }
+    }
+}
+
+void Use::ReplaceAllUses(const Value* from, const Value* to) {
+    // Both lists stay locked throughout, std::lock avoids deadlocks with a replacement running
+    // the other way round
+    std::mutex* from_mutex = SharedLockOf(from);
+    std::mutex* to_mutex = SharedLockOf(to);
+    if (to_mutex == from_mutex) {
+        to_mutex = nullptr;
+    }
+    std::unique_lock<std::mutex> from_lock;
+    std::unique_lock<std::mutex> to_lock;
+    if (from_mutex != nullptr && to_mutex != nullptr) {
+        std::lock(*from_mutex, *to_mutex);
+        from_lock = std::unique_lock(*from_mutex, std::adopt_lock);
+        to_lock = std::unique_lock(*to_mutex, std::adopt_lock);
+    } else if (from_mutex != nullptr) {
+        from_lock = std::unique_lock(*from_mutex);
+    } else if (to_mutex != nullptr) {
+        to_lock = std::unique_lock(*to_mutex);
+    }
+
+    while (from->uses_ != nullptr) {
+        Use* use = from->uses_;
+        use->UnlinkLocked();
+        use->value_ = to;
+        if (to != nullptr) {
+            use->LinkLocked();
+        }
+        if (use->user_ != nullptr && use->user_->GetBlock() != nullptr) {
+            use->user_->GetBlock()->GetContextFunction()->MarkModified();
+        }
+    }
+}
+
+}  // namespace bier
@@ -0,0 +1,257 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <mutex>
+
+namespace bier {
+
+class Module;
+class Operation;
+class Value;
+
+// Slot of an operation referring to a value, either as an operand or as a result.
+// Slots are linked into lists kept by the value, so users and definitions of a value are
+// known without scanning the function.
+class Use {
+public:
+    enum class Kind { OPERAND, RESULT };
+
+    explicit Use(Operation* user, const Value* value = nullptr, Kind kind = Kind::OPERAND);
+    Use(Use&& other) noexcept;
+    Use(const Use&) = delete;
+    Use& operator=(const Use&) = delete;
+    ~Use();
+
+    const Value* Get() const {
+        return value_;
+    }
+    void Set(const Value* value);
+
+    Operation* GetUser() const {
+        return user_;
+    }
+    Kind GetKind() const {
+        return kind_;
+    }
+    // Next slot referring to the same value
+    Use* Next() const {
+        return next_;
+    }
+
+private:
+    friend class Value;
+
+    const Value* value_ = nullptr;
+    Operation* user_ = nullptr;
+    Use* prev_ = nullptr;
+    Use* next_ = nullptr;
+    Kind kind_ = Kind::OPERAND;
+
+    void Link();
+    void Unlink();
+    // With the lock of the use list of the value held, if it needs one
+    void LinkLocked();
+    void UnlinkLocked();
+
+    static void ReplaceAllUses(const Value* from, const Value* to);
+};
+
+// Use lists of module-level values (constants, signatures, static data) are shared between the
+// functions of a module. Each module has its own set of locks striped over these lists.
+class SharedUseLocks {
+public:
+    std::mutex& For(const Value* value);
+
+private:
+    std::array<std::mutex, 64> mutexes_;
+};
+
+// While a scope is alive on a thread, the thread may edit functions of the module other threads
+// are editing too. Its changes of the use lists of module-level values are then serialized with
+// theirs by the locks of the module, threads working on other modules never wait for them.
+class ConcurrentEditScope {
+public:
+    explicit ConcurrentEditScope(const Module* module);
+    ConcurrentEditScope(const ConcurrentEditScope&) = delete;
+    ConcurrentEditScope& operator=(const ConcurrentEditScope&) = delete;
+    ~ConcurrentEditScope();
+
+private:
+    SharedUseLocks* previous_;
+};
+
+class UseIterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Use*;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Use**;
+    using reference = Use*;
+
+    explicit UseIterator(Use* use = nullptr) : use_(use) {
+    }
+
+    Use* operator*() const {
+        return use_;
+    }
+    Use* operator->() const {
+        return use_;
+    }
+    UseIterator& operator++() {
+        use_ = use_->Next();
+        return *this;
+    }
+    UseIterator operator++(int) {
+        UseIterator copy = *this;
+        ++(*this);
+        return copy;
+    }
+    bool operator==(const UseIterator& other) const {
+        return use_ == other.use_;
+    }
+    bool operator!=(const UseIterator& other) const {
+        return use_ != other.use_;
+    }
+
+private:
+    Use* use_ = nullptr;
+};
+
+class UseRange {
+public:
+    using iterator = UseIterator;
+
+    explicit UseRange(Use* first) : first_(first) {
+    }
+
+    iterator begin() const {
+        return UseIterator(first_);
+    }
+    iterator end() const {
+        return UseIterator();
+    }
+    bool Empty() const {
+        return first_ == nullptr;
+    }
+
+private:
+    Use* first_ = nullptr;
+};
+
+// Iterates values referred to by a contiguous array of operand slots
+class OperandIterator {
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = const Value*;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Value**;
+    using reference = const Value*;
+
+    explicit OperandIterator(const Use* use = nullptr) : use_(use) {
+    }
+
+    const Value* operator*() const {
+        return use_->Get();
+    }
+    const Value* operator[](difference_type index) const {
+        return use_[index].Get();
+    }
+    OperandIterator& operator++() {
+        ++use_;
+        return *this;
+    }
+    OperandIterator operator++(int) {
+        return OperandIterator(use_++);
+    }
+    OperandIterator& operator--() {
+        --use_;
+        return *this;
+    }
+    OperandIterator operator--(int) {
+        return OperandIterator(use_--);
+    }
+    OperandIterator& operator+=(difference_type offset) {
+        use_ += offset;
+        return *this;
+    }
+    OperandIterator operator+(difference_type offset) const {
+        return OperandIterator(use_ + offset);
+    }
+    OperandIterator operator-(difference_type offset) const {
+        return OperandIterator(use_ - offset);
+    }
+    difference_type operator-(const OperandIterator& other) const {
+        return use_ - other.use_;
+    }
+    bool operator==(const OperandIterator& other) const {
+        return use_ == other.use_;
+    }
+    bool operator!=(const OperandIterator& other) const {
+        return use_ != other.use_;
+    }
+    bool operator<(const OperandIterator& other) const {
+        return use_ < other.use_;
+    }
+
+    const Use* GetUse() const {
+        return use_;
+    }
+
+private:
+    const Use* use_ = nullptr;
+};
+
+// Non-owning view of the operands of an operation
+class OperandRange {
+public:
+    using iterator = OperandIterator;
+    using const_iterator = OperandIterator;
+    using value_type = const Value*;
+
+    OperandRange(const Use* operands, std::size_t count) : operands_(operands), count_(count) {
+    }
+
+    iterator begin() const {
+        return OperandIterator(operands_);
+    }
+    iterator end() const {
+        return OperandIterator(operands_ + count_);
+    }
+    std::size_t size() const {
+        return count_;
+    }
+    bool empty() const {
+        return count_ == 0;
+    }
+    const Value* operator[](std::size_t index) const {
+        return operands_[index].Get();
+    }
+    const Value* front() const {
+        return operands_[0].Get();
+    }
+    const Value* back() const {
+        return operands_[count_ - 1].Get();
+    }
+
+private:
+    const Use* operands_ = nullptr;
+    std::size_t count_ = 0;
+};
+
+}  // namespace bier
@@ -0,0 +1,47 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "value.h"
+#include <cassert>
+
+namespace bier {
+
+Value::~Value() {
+    // Slots may outlive the value during teardown, they should not touch it afterwards
+    for (Use* head : {uses_, definitions_}) {
+        while (head != nullptr) {
+            Use* next = head->next_;
+            head->value_ = nullptr;
+            head->prev_ = nullptr;
+            head->next_ = nullptr;
+            head = next;
+        }
+    }
+}
+
+Operation* Value::GetDefiningOp() const {
+    if (definitions_ == nullptr || definitions_->Next() != nullptr) {
+        return nullptr;
+    }
+    return definitions_->GetUser();
+}
+
+void Value::ReplaceAllUsesWith(const Value* value) const {
+    assert(value != this);
+    assert(value == nullptr || value->GetType() == GetType());
+    Use::ReplaceAllUses(this, value);
+}
+
+}  // namespace bier
@@ -15,15 +15,74 @@
 */
 #pragma once
 #include <bier/core/type.h>
+#include <bier/core/use.h>
+#include <bier/utils/dense_map.h>
 
 namespace bier {
 
 class Value {
 public:
-    virtual ~Value() = default;
+    // Discriminator for isa/cast/dyn_cast, constants go last
+    enum class Kind {
+        VARIABLE,
+        ARGUMENT,
+        FUNCTION_SIGNATURE,
+        FUNCTION_POINTER,
+        FUNCTION,
+        STATIC_DATA,
+        INTEGER_CONST,
+        UNDEF_CONST
+    };
+
+    explicit Value(Kind kind) : kind_(kind) {
+    }
+    Value(const Value&) = delete;
+    Value& operator=(const Value&) = delete;
+    virtual ~Value();
+
     virtual const Type* GetType() const = 0;
-    virtual std::string GetName() const = 0;
+    virtual const std::string& GetName() const = 0;
     virtual bool IsMutable() const = 0;
+
+    Kind GetKind() const {
+        return kind_;
+    }
+    // Dense index of a variable or an argument within its function, kNoDenseIndex otherwise
+    std::uint32_t GetIndex() const {
+        return index_;
+    }
+
+    bool HasUses() const {
+        return uses_ != nullptr;
+    }
+    // Number of operand and result slots referring to the value
+    std::uint32_t GetReferenceCount() const {
+        return references_;
+    }
+    // Operand slots referring to the value
+    UseRange Uses() const {
+        return UseRange(uses_);
+    }
+    // Result slots assigning the value
+    UseRange Definitions() const {
+        return UseRange(definitions_);
+    }
+    // Operation producing the value, nullptr if there is none or more than one
+    Operation* GetDefiningOp() const;
+
+    // Makes every operand referring to this value refer to the given one
+    void ReplaceAllUsesWith(const Value* value) const;
+
+private:
+    friend class Use;
+    friend class Function;
+    friend class FunctionSignature;
+
+    const Kind kind_;
+    std::uint32_t index_ = kNoDenseIndex;
+    mutable Use* uses_ = nullptr;
+    mutable Use* definitions_ = nullptr;
+    mutable std::uint32_t references_ = 0;
 };
 
 }  // namespace bier
@@ -14,6 +14,7 @@
    limitations under the License.
 */
 #include "variable.h"
+#include <bier/core/function.h>
 
 namespace bier {
 
@@ -24,4 +25,11 @@ Variable::Metadata::Metadata(const std::string& _name, const Type* _type, bool _
     assert(type != nullptr);
 }
 
+void Variable::OnUnreferenced() const {
+    if (function_ != nullptr && !lost_candidate_) {
+        lost_candidate_ = true;
+        function_->lost_variables_.push_back(this);
+    }
+}
+
 }  // namespace bier
@@ -19,9 +19,10 @@
 
 namespace bier {
 
+class Function;
 class Variable;
 
-using VariablePtr = std::unique_ptr<Variable>;
+using VariablePtr = ArenaPtr<Variable>;
 
 class Variable : public Value {
 public:
@@ -34,26 +35,47 @@ public:
                  bool _is_mutable = false);
     };
 
-    explicit Variable(const Metadata& metadata) : data_(metadata) {
+    Variable(Symbol name, const Type* type, bool is_mutable = false)
+        : Value(Kind::VARIABLE), name_(name), type_(type), is_mutable_(is_mutable) {
+        assert(type_ != nullptr);
+    }
+
+    static bool classof(const Value* value) {
+        return value->GetKind() == Kind::VARIABLE;
     }
 
     // Value interface
     const Type* GetType() const override {
-        return data_.type;
+        return type_;
     }
-    std::string GetName() const override {
-        return data_.name;
+    const std::string& GetName() const override {
+        return name_.Str();
     }
     bool IsMutable() const override {
-        return data_.is_mutable;
+        return is_mutable_;
+    }
+
+    Symbol GetSymbol() const {
+        return name_;
     }
 
     void MakeImmutable() {
-        data_.is_mutable = false;
+        is_mutable_ = false;
     }
 
 private:
-    Metadata data_;
+    friend class Use;
+    friend class Function;
+
+    Symbol name_;
+    const Type* type_ = nullptr;
+    bool is_mutable_ = false;
+    Function* function_ = nullptr;
+    // Already queued for Function::Normalize
+    mutable bool lost_candidate_ = false;
+
+    // Queues the variable for removal once its last use or definition is gone
+    void OnUnreferenced() const;
 };
 
 }  // namespace bier
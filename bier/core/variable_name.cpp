@@ -18,25 +18,28 @@
 
 namespace bier {
 
-std::string VariableNameStorage::Allocate(const std::string& name, bool createNew) {
+Symbol VariableNameStorage::Allocate(const std::string& name, bool createNew) {
     if (name.empty()) {
-        return std::to_string(anonymous_counter_++);
+        return symbols_->Intern(std::to_string(anonymous_counter_++));
     }
-    if (ContainerHas(name_to_id, name)) {
+    const Symbol symbol = symbols_->Intern(name);
+    auto it = name_to_id.find(symbol);
+    if (it != name_to_id.end()) {
         if (createNew) {
-            return name + std::to_string(name_to_id.at(name)++);
+            return symbols_->Intern(name + std::to_string(it->second++));
         }
-        return name;
+        return symbol;
     }
-    name_to_id.insert({name, 0});
-    return name;
+    name_to_id.insert({symbol, 0});
+    return symbol;
 }
 
-std::string VariableNameStorage::AllocateUnique(const std::string& name) {
-    check(!ContainerHas(name_to_id, name),
+Symbol VariableNameStorage::AllocateUnique(const std::string& name) {
+    const Symbol symbol = symbols_->Intern(name);
+    check(!ContainerHas(name_to_id, symbol),
           IRException("Failed to allocate unique variable " + name, context_));
-    name_to_id.insert({name, 0});
-    return name;
+    name_to_id.insert({symbol, 0});
+    return symbol;
 }
 
 const Function* VariableNameStorage::GetContextFunction() const {
@@ -21,18 +21,20 @@ namespace bier {
 
 class VariableNameStorage : public FunctionContextMemeber {
 public:
-    explicit VariableNameStorage(const Function* function) : context_(function) {
+    VariableNameStorage(const Function* function, SymbolTable* symbols)
+        : context_(function), symbols_(symbols) {
     }
 
-    std::string Allocate(const std::string& name, bool createNew);
-    std::string AllocateUnique(const std::string& name);
+    Symbol Allocate(const std::string& name, bool createNew);
+    Symbol AllocateUnique(const std::string& name);
 
     // FunctionContextMemeber interface
     const Function* GetContextFunction() const override;
 
 private:
-    StdHashMap<std::string, int> name_to_id;
+    HashMap<Symbol, int> name_to_id;
     const Function* context_ = nullptr;
+    SymbolTable* symbols_ = nullptr;
     int anonymous_counter_ = 0;
 
 };
@@ -14,52 +14,41 @@
    limitations under the License.
 */
 #include "dag_context.h"
-#include <bier/core/function.h>
 #include <bier/operations/opcodes.h>
 
 namespace bier {
 
 void DagContext::Build(const BasicBlock* block) {
     block_ = block;
-    op_to_iterator_.clear();
-    const Function* funciton = block->GetContextFunction();
-    for (const auto& block : funciton->GetBlocks()) {
-        for (const auto& op : block.GetOperations()) {
-            auto return_value = op->GetReturnValue();
-            if (return_value.has_value()) {
-                value_to_op_.insert({return_value.value(), op.get()});
-            }
-        }
-    }
-
+    op_to_iterator_.Clear();
+    op_dependent_.Clear();
     auto range = block->GetOperations();
     for (auto it = range.begin(); it != range.end(); ++it) {
-        const Operation* op = it->get();
-        op_to_iterator_.insert({op, it});
+        const Operation* op = *it;
+        op_to_iterator_.Insert(op, it);
     }
     for (const auto& op : range) {
-        auto args = op->GetArguments();
-        for (const Value* arg : args) {
+        for (const Value* arg : op->GetArguments()) {
             auto dependency = GetOp(arg);
-            AddDependencies(op.get(), dependency);
+            AddDependencies(op, dependency);
         }
     }
 }
 
 BasicBlock::ConstOperationIterator DagContext::Get(const Operation* op) const {
-    assert(ContainerHas(op_to_iterator_, op));
-    return op_to_iterator_.at(op);
+    assert(op_to_iterator_.Has(op));
+    return op_to_iterator_.At(op);
 }
 
 const DagContext::DependentOps& DagContext::GetDependent(const Operation* op) const {
-    if (!ContainerHas(op_dependent_, op)) {
+    if (!op_dependent_.Has(op)) {
         return empty_;
     }
-    return op_dependent_.at(op);
+    return op_dependent_.At(op);
 }
 
 bool DagContext::Has(const Operation* op) const {
-    return ContainerHas(op_to_iterator_, op);
+    return op_to_iterator_.Has(op);
 }
 
 DagContextPtr DagContext::Make(const BasicBlock* block) {
@@ -74,17 +63,18 @@ void DagContext::AddDependencies(const Operation* op,
         return;
     }
     const Operation* dependency_op = dependency.value();
-    if (ContainerHas(op_to_iterator_, dependency_op)) {
+    if (op_to_iterator_.Has(dependency_op)) {
         auto& dependents = op_dependent_[op];
-        dependents.emplace_back(op_to_iterator_.at(dependency_op));
+        dependents.emplace_back(op_to_iterator_.At(dependency_op));
     }
 }
 
 std::optional<const Operation*> DagContext::GetOp(const Value* value) const {
-    if (!ContainerHas(value_to_op_, value)) {
+    const Operation* op = value->GetDefiningOp();
+    if (op == nullptr) {
         return std::nullopt;
     }
-    return value_to_op_.at(value);
+    return op;
 }
 
 }   // bier
@@ -15,7 +15,7 @@
 */
 #pragma once
 
-#include <bier/core/basic_block.h>
+#include <bier/core/function.h>
 
 namespace bier {
 
@@ -39,9 +39,8 @@ public:
     static DagContextPtr Make(const BasicBlock* block);
 
 private:
-    StdHashMap<const Operation*, BasicBlock::ConstOperationIterator> op_to_iterator_;
-    StdHashMap<const Operation*, DependentOps> op_dependent_;
-    StdHashMap<const Value*, const Operation*> value_to_op_;
+    DenseOperationMap<BasicBlock::ConstOperationIterator> op_to_iterator_;
+    DenseOperationMap<DependentOps> op_dependent_;
     const BasicBlock* block_ = nullptr;
     DependentOps empty_;
 
@@ -103,10 +103,11 @@ std::string DagDotSerializer::GetNodeName(int index) const {
 void ModuleDagsDotSerializer::Serialize(const Module* module) {
     DagDotSerializer serializer{stream_};
     for (const auto& function : module->GetDefinedFunctions()) {
-        for (auto& block : function.second->GetBlocks()) {
+        for (const BasicBlock* block : function.second->GetBlocks()) {
             OpDagBuilder builder;
-            builder.Build(&block);
-            serializer.Serialize(&builder.Graph(), function.first->Name() + "." + block.GetLabel());
+            builder.Build(block);
+            serializer.Serialize(&builder.Graph(),
+                                 function.first->Name() + "." + block->GetLabel());
         }
     }
 }
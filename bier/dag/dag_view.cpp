@@ -47,9 +47,8 @@ std::vector<DagView> DagView::Links() const {
         return links;
     }
 
-    const Operation* op = asOp()->get();
-    std::vector<const Value*> arguments = op->GetArguments();
-    for (const auto arg : arguments) {
+    const Operation* op = *asOp();
+    for (const Value* arg : op->GetArguments()) {
         auto arg_op = context_->GetOp(arg);
         if (arg_op.has_value() && context_->Has(arg_op.value())
                 && arg_op.value()->OpCode() != OpCodes::Op::ALLOC_OP) {
@@ -77,23 +76,23 @@ DagNodeType DagView::GetType() const {
         return op.value()->OpCode() == OpCodes::Op::ALLOC_OP ? DagNodeType::ALLOCA
                                                                          : DagNodeType::EXTERNAL_OPERATION;
     }
-    if (dynamic_cast<const ArgumentValue*>(value) != nullptr) {
+    if (isa<ArgumentValue>(value)) {
         return DagNodeType::ARG;
     }
-    if (dynamic_cast<const ConstValue*>(value) != nullptr) {
+    if (isa<ConstValue>(value)) {
         return DagNodeType::CONST;
     }
-    if (dynamic_cast<const FunctionSignature*>(value) != nullptr) {
+    if (isa<FunctionSignature>(value)) {
         return DagNodeType::SIGNATURE;
     }
-    if (dynamic_cast<const StaticData*>(value) != nullptr) {
+    if (isa<StaticData>(value)) {
         return DagNodeType::STATIC_DATA;
     }
     assert(false);
 }
 
 const Operation* DagView::AsOp() const {
-    return asOp()->get();
+    return *asOp();
 }
 
 DagView DagView::Root(const BasicBlock* block) {
@@ -106,7 +105,7 @@ bool DagView::operator==(const DagView& other) const {
         return false;
     }
     if (content_.index() == kOpIndex) {
-        return asOp()->get() == other.asOp()->get();
+        return *asOp() == *other.asOp();
     }
     return AsVal() == other.AsVal();
 }
@@ -135,7 +134,7 @@ HashType DagView::Hash::operator()(const DagView& dag) const {
     HashType hash = 0;
     boost::hash_combine(hash, dag.context_.get());
     if (dag.content_.index() == kOpIndex) {
-        boost::hash_combine(hash, dag.asOp()->get());
+        boost::hash_combine(hash, *dag.asOp());
     } else {
         boost::hash_combine(hash, dag.AsVal());
     }
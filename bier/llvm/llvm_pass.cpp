@@ -101,23 +101,24 @@ llvm::Function* BuildLLVMIRPass::CreateFunction(const Function* func) {
     auto it = func->GetSignature()->Arguments().begin();
     for (auto& arg : llvm_func->args()) {
         assert(it != func->GetSignature()->Arguments().end());
-        llvm_values_.insert({*it, &arg});
+        llvm_values_.Insert(*it, &arg);
         arg.setName((*it)->GetName());
         ++it;
     }
-    for (const auto& block : func->GetBlocks()) {
-        llvm_blocks_.insert({&block, llvm::BasicBlock::Create(llvm_->getContext(),
-                                                              block.GetLabel(), llvm_func)});
+    for (const BasicBlock* block : func->GetBlocks()) {
+        llvm_blocks_.insert({block, llvm::BasicBlock::Create(llvm_->getContext(),
+                                                             block->GetLabel(), llvm_func)});
     }
-    for (const auto& block : func->GetBlocks()) {
-        current_block_ = &block;
-        llvm::BasicBlock* llvm_block = llvm_blocks_.at(&block);
+    for (const BasicBlock* block : func->GetBlocks()) {
+        current_block_ = block;
+        llvm::BasicBlock* llvm_block = llvm_blocks_.at(block);
         builder_.SetInsertPoint(llvm_block);
-        for (const auto& op : block.GetOperations()) {
-            TranslateOperation(op.get());
+        for (const auto& op : block->GetOperations()) {
+            TranslateOperation(op);
         }
     }
-    llvm_values_.clear();
+    FillPhis();
+    llvm_values_.Clear();
     return llvm_func;
 }
 
@@ -177,21 +178,21 @@ void BuildLLVMIRPass::TranslateOperation(const Operation* op) {
             llvm::Value* llvm_return = builder_.CreateAlloca(
                 ConvertBasicType(underlying), LlvmValue(op->GetArguments().front()),
                 op->GetReturnValue().value()->GetName());
-            llvm_values_.insert({return_val, llvm_return});
+            llvm_values_.Insert(return_val, llvm_return);
         } break;
         case OpCodes::Op::LOAD_OP: {
             const Value* return_val = op->GetReturnValue().value();
             llvm::Value* src_val = PtrCast(op->GetArguments().front(), Types()->GetPtrTo(return_val->GetType()));
             llvm::Value* llvm_return = builder_.CreateLoad(src_val);
-            llvm_values_.insert({return_val, llvm_return});
+            llvm_values_.Insert(return_val, llvm_return);
         } break;
         case OpCodes::Op::ASSIGN_OP: {
             const Value* return_val = op->GetReturnValue().value();
-            llvm_values_.insert({return_val, LlvmValue(op->GetArguments().front())});
+            llvm_values_.Insert(return_val, LlvmValue(op->GetArguments().front()));
         } break;
         case OpCodes::Op::CONST_OP: {
-            llvm_values_.insert(
-                {op->GetReturnValue().value(), LlvmValue(op->GetArguments().front())});
+            llvm_values_.Insert(op->GetReturnValue().value(),
+                                LlvmValue(op->GetArguments().front()));
         } break;
         case OpCodes::Op::RETVOID_OP:
             builder_.CreateRetVoid();
@@ -208,21 +209,24 @@ void BuildLLVMIRPass::TranslateOperation(const Operation* op) {
         case OpCodes::Op::COND_BRANCH_OP: {
             auto operation = static_cast<const ConditionalBranchOperation*>(op);
             builder_.CreateCondBr(LlvmValue(operation->GetArguments().front()),
-                                  llvm_blocks_.at(operation->DestinationBlocks()[0]),
-                                  llvm_blocks_.at(operation->DestinationBlocks()[1]));
+                                  llvm_blocks_.at(operation->GetSuccessors()[0]),
+                                  llvm_blocks_.at(operation->GetSuccessors()[1]));
         } break;
         case OpCodes::Op::BRANCH_OP: {
             auto operation = static_cast<const BranchOperation*>(op);
-            builder_.CreateBr(llvm_blocks_.at(operation->DestinationBlocks().front()));
+            builder_.CreateBr(llvm_blocks_.at(operation->GetSuccessors()[0]));
         } break;
         case OpCodes::Op::CAST_OP: {
             TranslateCast(op);
         } break;
+        case OpCodes::Op::PHI_OP: {
+            TranslatePhi(op);
+        } break;
         case OpCodes::Op::ALLOC_LAYOUT_OP: {
             auto operation = static_cast<const AllocateLayout*>(op);
             const Value* count = operation->GetArguments().front();
-            llvm_values_.insert({op->GetReturnValue().value(),
-                                builder_.CreateAlloca(LlvmLayout(operation->GetLayout()), LlvmValue(count))});
+            llvm_values_.Insert(op->GetReturnValue().value(),
+                                builder_.CreateAlloca(LlvmLayout(operation->GetLayout()), LlvmValue(count)));
         } break;
         default:
             throw IRException("not supported opcode: " + std::to_string(op->OpCode()));
@@ -236,7 +240,7 @@ void BuildLLVMIRPass::CreateStaticData(const StaticData* data) {
     llvm::GlobalVariable* variable = llvm_->getGlobalVariable(data->GetName());
     std::vector<llvm::Constant*> values;
     for (int i = 0; i < data->GetLayout()->Entries().Size(); ++i) {
-        const std::string& func_name = dynamic_cast<const bier::FunctionPointer*>(data->GetEntry(i))->GetFunc()->Name();
+        const std::string& func_name = cast<FunctionPointer>(data->GetEntry(i))->GetFunc()->Name();
         values.emplace_back(llvm::ConstantExpr::getCast(llvm::Instruction::CastOps::BitCast, llvm_->getFunction(func_name),
                                     builder_.getInt8PtrTy()));
     }
@@ -268,7 +272,7 @@ void BuildLLVMIRPass::TranslateGEP(const Operation* op) {
         struct_type, src_ptr,
         offsets,
         operation->GetReturnValue().value()->GetName());
-    llvm_values_.insert({op->GetReturnValue().value(), return_val});
+    llvm_values_.Insert(op->GetReturnValue().value(), return_val);
 }
 
 void BuildLLVMIRPass::TranslateCast(const Operation* op) {
@@ -287,13 +291,13 @@ void BuildLLVMIRPass::TranslateCast(const Operation* op) {
         return_value = builder_.CreateIntCast(LlvmValue(src),
                                                 ConvertBasicType(target_type), true,
                                                 op->GetReturnValue().value()->GetName());
-        llvm_values_.insert({target, return_value});
+        llvm_values_.Insert(target, return_value);
         return;
     }
     return_value = builder_.CreateCast(cast_op, LlvmValue(src),
                                                        ConvertBasicType(target_type),
                                                        op->GetReturnValue().value()->GetName());
-    llvm_values_.insert({target, return_value});
+    llvm_values_.Insert(target, return_value);
 }
 
 void BuildLLVMIRPass::TranslateCall(const Operation* op) {
@@ -310,8 +314,8 @@ void BuildLLVMIRPass::TranslateCall(const Operation* op) {
     const std::string return_name =
         op->GetReturnValue().has_value() ? op->GetReturnValue().value()->GetName() : "";
     llvm::Value* llvm_ret = nullptr;
-    auto callee_func_sig = dynamic_cast<const FunctionSignature*>(callee);
-    auto callee_func = dynamic_cast<const Function*>(callee);
+    auto callee_func_sig = dyn_cast<FunctionSignature>(callee);
+    auto callee_func = dyn_cast<Function>(callee);
     if (callee_func_sig != nullptr) {
         llvm_ret = builder_.CreateCall(llvm_->getFunction(callee_func_sig->GetName()), args,
                                        return_name);
@@ -327,27 +331,50 @@ void BuildLLVMIRPass::TranslateCall(const Operation* op) {
     }
 
     if (op->GetReturnValue().has_value()) {
-        llvm_values_.insert({op->GetReturnValue().value(), llvm_ret});
+        llvm_values_.Insert(op->GetReturnValue().value(), llvm_ret);
+    }
+}
+
+void BuildLLVMIRPass::TranslatePhi(const Operation* op) {
+    auto operation = static_cast<const PhiOp*>(op);
+    const Variable* return_val = op->GetReturnValue().value();
+    llvm::PHINode* phi = builder_.CreatePHI(ConvertBasicType(return_val->GetType()),
+                                            operation->IncomingCount(), return_val->GetName());
+    llvm_values_.Insert(return_val, phi);
+    llvm_phis_.emplace_back(operation, phi);
+}
+
+void BuildLLVMIRPass::FillPhis() {
+    for (const auto& [operation, phi] : llvm_phis_) {
+        current_block_ = operation->GetBlock();
+        for (std::size_t i = 0; i < operation->IncomingCount(); ++i) {
+            phi->addIncoming(LlvmValue(operation->IncomingValue(i)),
+                             llvm_blocks_.at(operation->IncomingBlock(i)));
+        }
     }
+    llvm_phis_.clear();
 }
 
 llvm::Value* BuildLLVMIRPass::LlvmValue(const Value* value) {
-    auto int_val = dynamic_cast<const IntegerConst*>(value);
+    auto int_val = dyn_cast<IntegerConst>(value);
     if (int_val != nullptr) {
         return builder_.getIntN(int_val->IntType()->GetNBits(), int_val->GetValue());
     }
-    auto static_data_val = dynamic_cast<const StaticData*>(value);
+    if (auto undef_val = dyn_cast<UndefConst>(value)) {
+        return llvm::UndefValue::get(ConvertBasicType(undef_val->GetType()));
+    }
+    auto static_data_val = dyn_cast<StaticData>(value);
     if (static_data_val != nullptr) {
         auto global = llvm_->getGlobalVariable(static_data_val->GetName());
         assert(global != nullptr);
         return builder_.CreateCast(llvm::Instruction::CastOps::BitCast, global,
                                            builder_.getInt8PtrTy());
     }
-    check(ContainerHas(llvm_values_, value), IRException("LLVM-pass failure, not found variable " + value->GetName(),
+    check(llvm_values_.Has(value), IRException("LLVM-pass failure, not found variable " + value->GetName(),
                                                          IRContext{
                                                              current_func_, current_block_,
                                                              std::nullopt}));
-    return llvm_values_.at(value);
+    return llvm_values_.At(value);
 }
 
 llvm::StructType* BuildLLVMIRPass::LlvmLayout(const Layout* value) {
@@ -387,7 +414,7 @@ void BuildLLVMIRPass::TranslateBinOpSimple(const Operation* op, FBuildOp buildOp
     llvm::Value* return_val =
         (builder_.*buildOp)(LlvmValue(operation->LeftValue()), LlvmValue(operation->RightValue()),
                             operation->GetReturnValue().value()->GetName());
-    llvm_values_.insert({operation->GetReturnValue().value(), return_val});
+    llvm_values_.Insert(operation->GetReturnValue().value(), return_val);
 }
 
 template <typename FBuildOp>
@@ -396,7 +423,7 @@ void BuildLLVMIRPass::TranslateBinOpArithmetic(const Operation* op, FBuildOp bui
     llvm::Value* return_val =
         (builder_.*buildOp)(LlvmValue(operation->LeftValue()), LlvmValue(operation->RightValue()),
                             operation->GetReturnValue().value()->GetName(), false, false);
-    llvm_values_.insert({operation->GetReturnValue().value(), return_val});
+    llvm_values_.Insert(operation->GetReturnValue().value(), return_val);
 }
 
 template <typename FBuildOp>
@@ -405,7 +432,7 @@ void BuildLLVMIRPass::TranslateBinOpRoundArithmetic(const Operation* op, FBuildO
     llvm::Value* return_val =
         (builder_.*buildOp)(LlvmValue(operation->LeftValue()), LlvmValue(operation->RightValue()),
                             operation->GetReturnValue().value()->GetName(), false);
-    llvm_values_.insert({operation->GetReturnValue().value(), return_val});
+    llvm_values_.Insert(operation->GetReturnValue().value(), return_val);
 }
 
 }  // namespace bier
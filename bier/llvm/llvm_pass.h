@@ -19,6 +19,8 @@
 
 namespace bier {
 
+class PhiOp;
+
 class BuildLLVMIRPass : public ModulePass {
 public:
     BuildLLVMIRPass(llvm::LLVMContext* context, llvm::Module* module);
@@ -30,9 +32,11 @@ private:
     llvm::Module* llvm_ = nullptr;
     bier::Module* bier_module_ = nullptr;
     llvm::IRBuilder<> builder_;
-    StdHashMap<const Value*, llvm::Value*> llvm_values_;
+    DenseValueMap<llvm::Value*> llvm_values_;
     StdHashMap<const BasicBlock*, llvm::BasicBlock*> llvm_blocks_;
     StdHashMap<const Layout*, llvm::StructType*> llvm_layouts_;
+    // Incoming values may be defined later in the function, filled after all blocks
+    std::vector<std::pair<const PhiOp*, llvm::PHINode*>> llvm_phis_;
     const bier::Function* current_func_ = nullptr;
     const bier::BasicBlock* current_block_ = nullptr;
 
@@ -54,6 +58,8 @@ private:
     void TranslateGEP(const Operation* op);
     void TranslateCast(const Operation* op);
     void TranslateCall(const Operation* op);
+    void TranslatePhi(const Operation* op);
+    void FillPhis();
     llvm::Value* LlvmValue(const Value* value);
     llvm::StructType* LlvmLayout(const Layout* value);
 
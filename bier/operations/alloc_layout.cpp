@@ -19,24 +19,19 @@ namespace bier {
 
 AllocateLayout::AllocateLayout(const Function* context, const Layout* layout, const Value* count,
                                const Variable* result)
-    : context_(context), layout_(layout), count_(count), result_ptr_(result) {
-}
-
-std::vector<const Value*> AllocateLayout::GetArguments() const {
-    return {count_};
-}
-
-void AllocateLayout::SubstituteArguments(const std::vector<const Value*>& args) {
-    assert(args.size() == 1);
-    count_ = args[0];
+    : context_(context),
+      layout_(layout),
+      count_{Use(this, count)},
+      result_ptr_(this, result, Use::Kind::RESULT) {
+    SetOperandStorage(count_, 1);
 }
 
 std::optional<const Variable*> AllocateLayout::GetReturnValue() const {
-    return result_ptr_;
+    return ResultOf(result_ptr_);
 }
 
 void AllocateLayout::SubstituteReturnValue(const Variable* return_value) {
-    result_ptr_ = return_value;
+    result_ptr_.Set(return_value);
 }
 
 }  // namespace bier
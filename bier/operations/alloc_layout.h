@@ -12,8 +12,6 @@ public:
                    const Variable* result);
 
     // Интерфейс Operation
-    std::vector<const Value*> GetArguments() const override;
-    void SubstituteArguments(const std::vector<const Value*>& args) override;
     std::optional<const Variable*> GetReturnValue() const override;
     void SubstituteReturnValue(const Variable* return_value) override;
 
@@ -29,8 +27,8 @@ public:
 private:
     const Function* context_ = nullptr;
     const Layout* layout_ = nullptr;
-    const Value* count_ = nullptr;
-    const Variable* result_ptr_ = nullptr;
+    Use count_[1];
+    Use result_ptr_;
 };
 
 }  // namespace bier
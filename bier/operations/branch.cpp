@@ -20,55 +20,34 @@
 
 namespace bier {
 
-BranchOperation::BranchOperation(const Function* context, const BasicBlock* target)
-    : context_(context), target_(target) {
-    check(context_ == target_->GetContextFunction(),
+BranchOperation::BranchOperation(const Function* context, BasicBlock* target)
+    : context_(context), target_{target} {
+    SetSuccessorStorage(target_, 1);
+    check(context_ == target->GetContextFunction(),
           IRException("branch to block outside the function", context_));
-    assert(!target_->GetLabel().empty());
-}
-
-std::vector<const Value*> BranchOperation::GetArguments() const {
-    return {};
+    assert(!target->GetLabel().empty());
 }
 
 std::optional<const Variable*> BranchOperation::GetReturnValue() const {
     return std::nullopt;
 }
 
-std::vector<const BasicBlock*> BranchOperation::DestinationBlocks() const {
-    return {target_};
-}
-
 ConditionalBranchOperation::ConditionalBranchOperation(const Function* context,
                                                        const Value* condition,
-                                                       const BasicBlock* target_true,
-                                                       const BasicBlock* target_false)
-    : context_(context),
-      target_true_(target_true),
-      target_false_(target_false),
-      condition_(condition) {
-    check(context_ == target_true_->GetContextFunction() &&
-              context_ == target_false_->GetContextFunction(),
+                                                       BasicBlock* target_true,
+                                                       BasicBlock* target_false)
+    : context_(context), targets_{target_true, target_false}, condition_{Use(this, condition)} {
+    SetOperandStorage(condition_, 1);
+    SetSuccessorStorage(targets_, 2);
+    check(context_ == target_true->GetContextFunction() &&
+              context_ == target_false->GetContextFunction(),
           IRException("branch to block outside the function", context_));
-    assert(!target_true_->GetLabel().empty());
-    assert(!target_false_->GetLabel().empty());
-}
-
-std::vector<const Value*> ConditionalBranchOperation::GetArguments() const {
-    return {condition_};
-}
-
-void ConditionalBranchOperation::SubstituteArguments(const std::vector<const Value*>& args) {
-    assert(args.size() == 1);
-    condition_ = args[0];
+    assert(!target_true->GetLabel().empty());
+    assert(!target_false->GetLabel().empty());
 }
 
 std::optional<const Variable*> ConditionalBranchOperation::GetReturnValue() const {
     return std::nullopt;
 }
 
-std::vector<const BasicBlock*> ConditionalBranchOperation::DestinationBlocks() const {
-    return {target_true_, target_false_};
-}
-
 }  // namespace bier
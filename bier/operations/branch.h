@@ -20,20 +20,11 @@
 
 namespace bier {
 
-class Branch {
+class BranchOperation : public BaseOperation<OpCodes::Op::BRANCH_OP> {
 public:
-    virtual ~Branch() = default;
-    virtual std::vector<const BasicBlock*> DestinationBlocks() const = 0;
-};
-
-class BranchOperation : public BaseOperation<OpCodes::Op::BRANCH_OP>, public Branch {
-public:
-    BranchOperation(const Function* context, const BasicBlock* target);
+    BranchOperation(const Function* context, BasicBlock* target);
 
     // Интерфейс Operation
-    std::vector<const Value*> GetArguments() const override;
-    void SubstituteArguments(const std::vector<const Value*>&) override {
-    }
     std::optional<const Variable*> GetReturnValue() const override;
     void SubstituteReturnValue(const Variable*) override {
     }
@@ -43,23 +34,17 @@ public:
         return context_;
     }
 
-    // Интерфейс Branch
-    std::vector<const BasicBlock*> DestinationBlocks() const override;
-
 private:
     const Function* context_ = nullptr;
-    const BasicBlock* target_ = nullptr;
+    BasicBlock* target_[1];
 };
 
-class ConditionalBranchOperation : public BaseOperation<OpCodes::Op::COND_BRANCH_OP>,
-                                   public Branch {
+class ConditionalBranchOperation : public BaseOperation<OpCodes::Op::COND_BRANCH_OP> {
 public:
     ConditionalBranchOperation(const Function* context, const Value* condition,
-                               const BasicBlock* target_true, const BasicBlock* target_false);
+                               BasicBlock* target_true, BasicBlock* target_false);
 
     // Интерфейс operation
-    std::vector<const Value*> GetArguments() const override;
-    void SubstituteArguments(const std::vector<const Value*>& args) override;
     std::optional<const Variable*> GetReturnValue() const override;
     void SubstituteReturnValue(const Variable*) override {
     }
@@ -69,14 +54,11 @@ public:
         return context_;
     }
 
-    // Интерфейс Branch
-    std::vector<const BasicBlock*> DestinationBlocks() const override;
-
 private:
     const Function* context_ = nullptr;
-    const BasicBlock* target_true_ = nullptr;
-    const BasicBlock* target_false_ = nullptr;
-    const Value* condition_ = nullptr;
+    // True target goes first
+    BasicBlock* targets_[2];
+    Use condition_[1];
 };
 
 }  // namespace bier
@@ -15,17 +15,17 @@
 */
 #include "call.h"
 #include <bier/core/exceptions.h>
+#include <memory>
+#include <new>
 
 namespace bier {
 
-CallOp::CallOp(const Function* context, const Function* function,
+CallOp::CallOp(Function* context, const Function* function,
                std::optional<const Variable*> return_value, const std::vector<const Value*>& arguments)
-    : args_(arguments),
-      context_(context),
+    : context_(context),
       type_(function->GetSignature()->FuncType()),
-      value_(function),
-      return_value_(return_value) {
-    check((!return_value_.has_value() && !function->GetSignature()->ReturnType().has_value()) ||
+      return_value_(this, return_value.value_or(nullptr), Use::Kind::RESULT) {
+    check((!return_value.has_value() && !function->GetSignature()->ReturnType().has_value()) ||
               return_value.value()->GetType() == function->GetSignature()->ReturnType().value(),
           IRException("call to function " + function->GetName() +
                              " does not match return type", context_));
@@ -37,49 +37,53 @@ CallOp::CallOp(const Function* context, const Function* function,
               IRException("type for argument " + arg->GetName() + " does not match",
                           context_));
     }
+    InitArguments(context, function, arguments);
 }
 
-CallOp::CallOp(const Function* context, const FunctionType* type, const Value* func_value,
+CallOp::CallOp(Function* context, const FunctionType* type, const Value* func_value,
                std::optional<const Variable*> return_value, const std::vector<const Value*>& arguments)
-    : args_(arguments),
-      context_(context),
+    : context_(context),
       type_(type),
-      value_(func_value),
-      return_value_(return_value) {
-    CheckReturnAndArgs();
+      return_value_(this, return_value.value_or(nullptr), Use::Kind::RESULT) {
+    CheckReturnAndArgs(return_value, arguments);
+    InitArguments(context, func_value, arguments);
 }
 
-std::vector<const Value*> CallOp::GetArguments() const {
-    std::vector<const Value*> args = {value_};
-    args.insert(args.end(), args_.begin(), args_.end());
-    return args;
+CallOp::~CallOp() {
+    std::destroy_n(arguments_, arguments_count_);
 }
 
-void CallOp::SubstituteArguments(const std::vector<const Value*>& args) {
-    assert(args.size() == args_.size() + 1);
-    value_ = *args.begin();
-    args_ = std::vector(args.begin() + 1, args.end());
-
+void CallOp::SubstituteReturnValue(const Variable* return_value) {
+    assert(GetReturnValue().has_value());
+    return_value_.Set(return_value);
 }
 
-void CallOp::SubstituteReturnValue(const Variable* return_value) {
-    assert(return_value_.has_value());
-    return_value_ = return_value;
+void CallOp::InitArguments(Function* context, const Value* callee,
+                           const std::vector<const Value*>& arguments) {
+    arguments_count_ = arguments.size() + 1;
+    arguments_ = context->GetArena().AllocateArray<Use>(arguments_count_);
+    new (arguments_) Use(this, callee);
+    for (std::size_t i = 0; i < arguments.size(); ++i) {
+        new (arguments_ + i + 1) Use(this, arguments[i]);
+    }
+    SetOperandStorage(arguments_, arguments_count_);
 }
 
-void CallOp::CheckReturnAndArgs() const {
+void CallOp::CheckReturnAndArgs(std::optional<const Variable*> return_value,
+                                const std::vector<const Value*>& arguments) const {
     auto message = "call to function does not match return type "
-            + (!return_value_.has_value() ? "none" : return_value_.value()->GetType()->ToString())
+            + (!return_value.has_value() ? "none" : return_value.value()->GetType()->ToString())
             + " vs " + (!type_->ReturnType().has_value() ? "none" : type_->ReturnType().value()->ToString());
-    check((!return_value_.has_value() && !type_->ReturnType().has_value()) ||
-              (return_value_.has_value() &&
-               return_value_.value()->GetType() == type_->ReturnType().value()),
+    check((!return_value.has_value() && !type_->ReturnType().has_value()) ||
+              (return_value.has_value() &&
+               return_value.value()->GetType() == type_->ReturnType().value()),
           IRException(message, context_));
     int index = 0;
-    check(type_->Arguments().size() == args_.size(), IRException("not enough arguments", context_));
+    check(type_->Arguments().size() == arguments.size(),
+          IRException("not enough arguments", context_));
     for (const auto arg : type_->Arguments()) {
-        check(arg == args_[index]->GetType(),
-            IRException("type for argument " + args_[index]->GetName() + " does not match",
+        check(arg == arguments[index]->GetType(),
+            IRException("type for argument " + arguments[index]->GetName() + " does not match",
                         context_));
         index += 1;
     }
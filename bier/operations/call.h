@@ -22,12 +22,14 @@ namespace bier {
 
 class CallOp : public BaseOperation<OpCodes::Op::CALL_OP> {
 public:
-    CallOp(const Function* context, const Function* function,
+    // Operands are allocated in the arena of the context function
+    CallOp(Function* context, const Function* function,
            std::optional<const Variable*> return_value = std::nullopt,
            const std::vector<const Value*>& arguments = {});
-    CallOp(const Function* context, const FunctionType* type, const Value* func_value,
+    CallOp(Function* context, const FunctionType* type, const Value* func_value,
            std::optional<const Variable*> return_value = std::nullopt,
            const std::vector<const Value*>& arguments = {});
+    ~CallOp() override;
 
     // FunctionContextInterface
     const Function* GetContextFunction() const override {
@@ -35,28 +37,30 @@ public:
     }
 
     // Operation Interface
-    std::vector<const Value*> GetArguments() const override;
-    void SubstituteArguments(const std::vector<const Value*>& args) override;
     std::optional<const Variable*> GetReturnValue() const override {
-        return return_value_;
+        return ResultOf(return_value_);
     }
     void SubstituteReturnValue(const Variable* return_value) override;
 
     const Value* Callee() const {
-        return value_;
+        return arguments_[0].Get();
     }
     const FunctionType* FuncType() const {
         return type_;
     }
 
 private:
-    std::vector<const Value*> args_;
     const Function* context_ = nullptr;
     const FunctionType* type_ = nullptr;
-    const Value* value_ = nullptr;
-    std::optional<const Variable*> return_value_ = std::nullopt;
+    // Callee followed by the call arguments
+    Use* arguments_ = nullptr;
+    std::size_t arguments_count_ = 0;
+    Use return_value_;
 
-    void CheckReturnAndArgs() const;
+    void InitArguments(Function* context, const Value* callee,
+                       const std::vector<const Value*>& arguments);
+    void CheckReturnAndArgs(std::optional<const Variable*> return_value,
+                            const std::vector<const Value*>& arguments) const;
 };
 
 }  // namespace bier
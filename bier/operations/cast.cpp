@@ -18,9 +18,10 @@
 namespace bier {
 
 CastOperation::CastOperation(const Function* funciton, const Value* from, const Variable* to)
-    : context_(funciton), from_(from), to_(to) {
-    assert(from_ != nullptr);
-    assert(to_ != nullptr);
+    : context_(funciton), from_{Use(this, from)}, to_(this, to, Use::Kind::RESULT) {
+    SetOperandStorage(from_, 1);
+    assert(from != nullptr);
+    assert(to != nullptr);
     assert(context_ != nullptr);
 }
 
@@ -28,21 +29,12 @@ const Function* CastOperation::GetContextFunction() const {
     return context_;
 }
 
-std::vector<const Value*> CastOperation::GetArguments() const {
-    return {from_};
-}
-
-void CastOperation::SubstituteArguments(const std::vector<const Value*>& args) {
-    assert(args.size() == 1);
-    from_ = args[0];
-}
-
 std::optional<const Variable*> CastOperation::GetReturnValue() const {
-    return to_;
+    return ResultOf(to_);
 }
 
 void CastOperation::SubstituteReturnValue(const Variable* return_value) {
-    to_ = return_value;
+    to_.Set(return_value);
 }
 
 }  // namespace bier
@@ -27,23 +27,21 @@ public:
     // FunctionContextMember interface
     const Function* GetContextFunction() const override;
     // Operation interface
-    std::vector<const Value*> GetArguments() const override;
-    void SubstituteArguments(const std::vector<const Value*>& args) override;
     std::optional<const Variable*> GetReturnValue() const override;
     void SubstituteReturnValue(const Variable* return_value) override;
 
     const Type* TypeTo() const {
-        return to_->GetType();
+        return to_.Get()->GetType();
     }
 
     const Type* TypeFrom() const {
-        return from_->GetType();
+        return from_[0].Get()->GetType();
     }
 
 private:
     const Function* context_ = nullptr;
-    const Value* from_ = nullptr;
-    const Variable* to_ = nullptr;
+    Use from_[1];
+    Use to_;
 };
 
 }  // namespace bier
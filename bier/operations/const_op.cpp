@@ -19,30 +19,22 @@ namespace bier {
 
 ConstOperation::ConstOperation(const Function* context, const ConstValue* const_value,
                                const Variable* ret_value)
-    : context_(context), value_(const_value), return_value_(ret_value) {
+    : context_(context),
+      value_{Use(this, const_value)},
+      return_value_(this, ret_value, Use::Kind::RESULT) {
+    SetOperandStorage(value_, 1);
 }
 
 const Function* ConstOperation::GetContextFunction() const {
     return context_;
 }
 
-std::vector<const Value*> ConstOperation::GetArguments() const {
-    return {value_};
-}
-
-void ConstOperation::SubstituteArguments(const std::vector<const Value*>& args) {
-    assert(args.size() == 1);
-    auto new_arg = dynamic_cast<const ConstValue*>(args[0]);
-    assert(new_arg != nullptr);
-    value_ = new_arg;
-}
-
 std::optional<const Variable*> ConstOperation::GetReturnValue() const {
-    return {return_value_};
+    return ResultOf(return_value_);
 }
 
 void ConstOperation::SubstituteReturnValue(const Variable* return_value) {
-    return_value_ = return_value;
+    return_value_.Set(return_value);
 }
 
 }  // namespace bier
@@ -29,15 +29,13 @@ public:
     const Function* GetContextFunction() const override;
 
     // Operation interface
-    std::vector<const Value*> GetArguments() const override;
-    void SubstituteArguments(const std::vector<const Value*>& args) override;
     std::optional<const Variable*> GetReturnValue() const override;
     void SubstituteReturnValue(const Variable* return_value) override;
 
 private:
     const Function* context_ = nullptr;
-    const ConstValue* value_ = nullptr;
-    const Variable* return_value_ = nullptr;
+    Use value_[1];
+    Use return_value_;
 };
 
 }  // namespace bier
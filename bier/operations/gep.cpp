@@ -23,53 +23,39 @@ GEPOp::GEPOp(const Function* func, const Value* ptr, int element_index, const Va
              const Layout* layout, std::optional<const Value*> base_offset,
              std::optional<const Value*> element_offset)
     : context_(func),
-      ptr_(ptr),
-      index_(element_index),
-      return_ptr_(return_value),
+      arguments_{Use(this, ptr), Use(this), Use(this)},
+      element_index_(element_index),
+      return_ptr_(this, return_value, Use::Kind::RESULT),
       mem_layout_(layout),
-      base_offset_(base_offset),
-      element_offset_(element_offset) {
-    auto typed_ptr = dynamic_cast<const TypedPtrType*>(return_ptr_->GetType());
-    check((typed_ptr != nullptr && typed_ptr->GetUnderlying() == mem_layout_->GetEntry(index_)) ||
-              dynamic_cast<const PtrType*>(return_ptr_->GetType()) != nullptr,
+      has_base_offset_(base_offset.has_value()),
+      has_element_offset_(element_offset.has_value()) {
+    std::size_t count = 1;
+    if (has_base_offset_) {
+        arguments_[count++].Set(base_offset.value());
+    }
+    if (has_element_offset_) {
+        arguments_[count++].Set(element_offset.value());
+    }
+    SetOperandStorage(arguments_, count);
+    auto typed_ptr = dyn_cast<TypedPtrType>(return_value->GetType());
+    check((typed_ptr != nullptr &&
+           typed_ptr->GetUnderlying() == mem_layout_->GetEntry(element_index_)) ||
+              isa<PtrType>(return_value->GetType()),
           IRException("cannot assign pointer of " +
                              mem_layout_->GetEntry(element_index)->ToString() + " to " +
-                             return_ptr_->GetType()->ToString(), context_));
+                             return_value->GetType()->ToString(), context_));
 }
 
 const Function* GEPOp::GetContextFunction() const {
     return context_;
 }
 
-std::vector<const Value*> GEPOp::GetArguments() const {
-    std::vector<const Value*> arguments = {ptr_};
-    if (base_offset_.has_value()) {
-        arguments.push_back(base_offset_.value());
-    }
-    if (element_offset_.has_value()) {
-        arguments.push_back(element_offset_.value());
-    }
-    return arguments;
-}
-
-void GEPOp::SubstituteArguments(const std::vector<const Value*>& args) {
-    assert(GetArguments().size() == args.size());
-    ptr_ = args[0];
-    std::size_t index = 1;
-    if (base_offset_.has_value()) {
-        base_offset_ = args[index++];
-    }
-    if (element_offset_.has_value()) {
-        element_offset_ = args[index++];
-    }
-}
-
 std::optional<const Variable*> GEPOp::GetReturnValue() const {
-    return return_ptr_;
+    return ResultOf(return_ptr_);
 }
 
 void GEPOp::SubstituteReturnValue(const Variable* return_value) {
-    return_ptr_ = return_value;
+    return_ptr_.Set(return_value);
 }
 
 }  // namespace bier
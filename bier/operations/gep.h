@@ -31,8 +31,6 @@ public:
     const Function* GetContextFunction() const override;
 
     // Operation interface
-    std::vector<const Value*> GetArguments() const override;
-    void SubstituteArguments(const std::vector<const Value*>& args) override;
     std::optional<const Variable*> GetReturnValue() const override;
     void SubstituteReturnValue(const Variable* return_value) override;
 
@@ -41,23 +39,30 @@ public:
     }
 
     int ElementIndex() const {
-        return index_;
+        return element_index_;
     }
     std::optional<const Value*> BaseOffset() const {
-        return base_offset_;
+        if (!has_base_offset_) {
+            return std::nullopt;
+        }
+        return arguments_[1].Get();
     }
     std::optional<const Value*> ElementOffset() const {
-        return element_offset_;
+        if (!has_element_offset_) {
+            return std::nullopt;
+        }
+        return arguments_[has_base_offset_ ? 2 : 1].Get();
     }
 
 private:
     const Function* context_ = nullptr;
-    const Value* ptr_ = nullptr;
-    int index_ = -1;
-    const Variable* return_ptr_ = nullptr;
+    // Pointer followed by present offsets
+    Use arguments_[3];
+    int element_index_ = -1;
+    Use return_ptr_;
     const Layout* mem_layout_ = nullptr;
-    std::optional<const Value*> base_offset_;
-    std::optional<const Value*> element_offset_;
+    bool has_base_offset_ = false;
+    bool has_element_offset_ = false;
 };
 
 }  // namespace bier
@@ -64,6 +64,9 @@ enum Op : int {
     // Alloc layout
     ALLOC_LAYOUT_OP,
 
+    // Phi
+    PHI_OP,
+
     OPS_COUNT
 };
 
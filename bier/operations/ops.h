@@ -22,4 +22,5 @@
 #include <bier/operations/cast.h>
 #include <bier/operations/const_op.h>
 #include <bier/operations/gep.h>
+#include <bier/operations/phi.h>
 #include <bier/operations/return.h>
@@ -0,0 +1,116 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "phi.h"
+#include <bier/core/exceptions.h>
+#include <algorithm>
+#include <memory>
+#include <new>
+
+namespace bier {
+
+PhiOp::PhiOp(Function* context, const Variable* return_value,
+             const std::vector<BasicBlock*>& incoming_blocks,
+             const std::vector<const Value*>& incoming_values)
+    : context_(context), return_value_(this, return_value, Use::Kind::RESULT) {
+    assert(return_value != nullptr);
+    check(incoming_values.empty() || incoming_values.size() == incoming_blocks.size(),
+          IRException("phi should have a value for every incoming block", context_));
+    for (const Value* value : incoming_values) {
+        check(value->GetType() == return_value->GetType(),
+              IRException("phi incoming value " + value->GetName() + " does not match type " +
+                              return_value->GetType()->ToString(),
+                          context_));
+    }
+    incoming_count_ = incoming_blocks.size();
+    incoming_blocks_ = context->GetArena().AllocateArray<BasicBlock*>(incoming_count_);
+    std::copy(incoming_blocks.begin(), incoming_blocks.end(), incoming_blocks_);
+    incoming_values_ = context->GetArena().AllocateArray<Use>(incoming_count_);
+    for (std::size_t i = 0; i < incoming_count_; ++i) {
+        new (incoming_values_ + i)
+            Use(this, incoming_values.empty() ? nullptr : incoming_values[i]);
+    }
+    SetOperandStorage(incoming_values_, incoming_count_);
+    context_->MarkModified();
+}
+
+PhiOp::~PhiOp() {
+    std::destroy_n(incoming_values_, incoming_count_);
+}
+
+void PhiOp::SubstituteReturnValue(const Variable* return_value) {
+    return_value_.Set(return_value);
+}
+
+void PhiOp::SetIncomingValue(std::size_t index, const Value* value) {
+    assert(value == nullptr || value->GetType() == return_value_.Get()->GetType());
+    SetOperand(index, value);
+}
+
+void PhiOp::SetIncomingBlock(std::size_t index, BasicBlock* block) {
+    assert(index < incoming_count_);
+    if (incoming_blocks_[index] == block) {
+        return;
+    }
+    incoming_blocks_[index] = block;
+    if (GetBlock() != nullptr) {
+        context_->MarkModified();
+    }
+}
+
+void PhiOp::RemoveIncoming(std::size_t index) {
+    assert(index < incoming_count_);
+    for (std::size_t i = index + 1; i < incoming_count_; ++i) {
+        incoming_values_[i - 1].Set(incoming_values_[i].Get());
+        incoming_blocks_[i - 1] = incoming_blocks_[i];
+    }
+    --incoming_count_;
+    std::destroy_at(incoming_values_ + incoming_count_);
+    SetOperandStorage(incoming_values_, incoming_count_);
+    context_->MarkModified();
+}
+
+std::vector<PhiOp*> PhiOp::GetPhis(BasicBlock* block) {
+    std::vector<PhiOp*> phis;
+    for (Operation* op : block->GetOperations()) {
+        if (op->OpCode() == OpCodes::PHI_OP) {
+            phis.push_back(static_cast<PhiOp*>(op));
+        }
+    }
+    return phis;
+}
+
+void PhiOp::RemoveIncomingEdge(BasicBlock* block, const BasicBlock* predecessor) {
+    for (PhiOp* phi : GetPhis(block)) {
+        for (std::size_t i = phi->IncomingCount(); i-- > 0;) {
+            if (phi->IncomingBlock(i) == predecessor) {
+                phi->RemoveIncoming(i);
+                break;
+            }
+        }
+    }
+}
+
+void PhiOp::ReplaceIncomingBlock(BasicBlock* block, const BasicBlock* from, BasicBlock* to) {
+    for (PhiOp* phi : GetPhis(block)) {
+        for (std::size_t i = 0; i < phi->IncomingCount(); ++i) {
+            if (phi->IncomingBlock(i) == from) {
+                phi->SetIncomingBlock(i, to);
+            }
+        }
+    }
+}
+
+}  // namespace bier
@@ -0,0 +1,78 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+
+#include <bier/core/function.h>
+#include <bier/operations/opcodes.h>
+
+namespace bier {
+
+// Selects the incoming value of the predecessor control came from. Should precede all the
+// other operations of its block.
+// A phi holds one entry per incoming edge, like BasicBlock::Predecessors lists them: a
+// predecessor branching to the block from both targets of a conditional branch has two.
+class PhiOp : public BaseOperation<OpCodes::Op::PHI_OP> {
+public:
+    // Incoming values and blocks are allocated in the arena of the context function. Values
+    // may be left out and set later with SetIncomingValue.
+    PhiOp(Function* context, const Variable* return_value,
+          const std::vector<BasicBlock*>& incoming_blocks,
+          const std::vector<const Value*>& incoming_values = {});
+    ~PhiOp() override;
+
+    // FunctionContextMember interface
+    const Function* GetContextFunction() const override {
+        return context_;
+    }
+
+    // Operation interface
+    std::optional<const Variable*> GetReturnValue() const override {
+        return ResultOf(return_value_);
+    }
+    void SubstituteReturnValue(const Variable* return_value) override;
+
+    std::size_t IncomingCount() const {
+        return incoming_count_;
+    }
+    const Value* IncomingValue(std::size_t index) const {
+        return GetArguments()[index];
+    }
+    BasicBlock* IncomingBlock(std::size_t index) const {
+        assert(index < incoming_count_);
+        return incoming_blocks_[index];
+    }
+    void SetIncomingValue(std::size_t index, const Value* value);
+    // For a predecessor replaced by another one, e.g. when a block is split
+    void SetIncomingBlock(std::size_t index, BasicBlock* block);
+    // Drops the entry of a predecessor which no longer branches to the block, the order of
+    // the remaining entries is kept
+    void RemoveIncoming(std::size_t index);
+
+    static std::vector<PhiOp*> GetPhis(BasicBlock* block);
+    // Drops the entries of one edge from predecessor in all phis of the block
+    static void RemoveIncomingEdge(BasicBlock* block, const BasicBlock* predecessor);
+    // Moves the entries of every edge from one predecessor to another in all phis of the block
+    static void ReplaceIncomingBlock(BasicBlock* block, const BasicBlock* from, BasicBlock* to);
+
+private:
+    const Function* context_ = nullptr;
+    Use* incoming_values_ = nullptr;
+    BasicBlock** incoming_blocks_ = nullptr;
+    std::size_t incoming_count_ = 0;
+    Use return_value_;
+};
+
+}  // namespace bier
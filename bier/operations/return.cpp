@@ -22,16 +22,13 @@ const Function* ReturnVoidOp::GetContextFunction() const {
     return context_;
 }
 
-std::vector<const Value*> ReturnVoidOp::GetArguments() const {
-    return {};
-}
-
 std::optional<const Variable*> ReturnVoidOp::GetReturnValue() const {
     return std::nullopt;
 }
 
 ReturnValueOp::ReturnValueOp(const Function* context_func, const Value* value)
-    : context_(context_func), value_(value) {
+    : context_(context_func), value_{Use(this, value)} {
+    SetOperandStorage(value_, 1);
     assert(context_func != nullptr);
     assert(value != nullptr);
     auto return_type = context_->GetSignature()->FuncType()->ReturnType();
@@ -49,15 +46,6 @@ const Function* ReturnValueOp::GetContextFunction() const {
     return context_;
 }
 
-std::vector<const Value*> ReturnValueOp::GetArguments() const {
-    return {value_};
-}
-
-void ReturnValueOp::SubstituteArguments(const std::vector<const Value*>& args) {
-    assert(args.size() == 1);
-    value_ = args[0];
-}
-
 std::optional<const Variable*> ReturnValueOp::GetReturnValue() const {
     return std::nullopt;
 }
@@ -29,9 +29,6 @@ public:
     const Function* GetContextFunction() const override;
 
     // Operation interface
-    std::vector<const Value*> GetArguments() const override;
-    void SubstituteArguments(const std::vector<const Value*>&) override {
-    }
     std::optional<const Variable*> GetReturnValue() const override;
     void SubstituteReturnValue(const Variable*) override {
     }
@@ -48,14 +45,12 @@ public:
     const Function* GetContextFunction() const override;
 
     // Operation interface
-    std::vector<const Value*> GetArguments() const override;
-    void SubstituteArguments(const std::vector<const Value*>& args) override;
     std::optional<const Variable*> GetReturnValue() const override;
     void SubstituteReturnValue(const Variable* return_value) override;
 
 private:
     const Function* context_ = nullptr;
-    const Value* value_ = nullptr;
+    Use value_[1];
 };
 
 }  // namespace bier
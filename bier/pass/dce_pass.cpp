@@ -0,0 +1,300 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "dce_pass.h"
+#include <bier/analysis/memory_utils.h>
+#include <bier/operations/branch.h>
+#include <bier/operations/phi.h>
+#include <bier/utils/casting.h>
+
+namespace bier {
+
+namespace {
+
+bool IsPure(const Operation* op) {
+    switch (op->OpCode()) {
+        case OpCodes::ADD_OP:
+        case OpCodes::SUB_OP:
+        case OpCodes::MULT_OP:
+        case OpCodes::UDIV_OP:
+        case OpCodes::SDIV_OP:
+        case OpCodes::UREM_OP:
+        case OpCodes::SREM_OP:
+        case OpCodes::EQ_OP:
+        case OpCodes::NE_OP:
+        case OpCodes::LE_OP:
+        case OpCodes::LT_OP:
+        case OpCodes::GE_OP:
+        case OpCodes::GT_OP:
+        case OpCodes::ALLOC_OP:
+        case OpCodes::ASSIGN_OP:
+        case OpCodes::CONST_OP:
+        case OpCodes::GEP_OP:
+        case OpCodes::CAST_OP:
+        case OpCodes::ALLOC_LAYOUT_OP:
+        case OpCodes::PHI_OP:
+            return true;
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+PreservedAnalyses DeadCodeEliminationPass::GetPreservedAnalyses() const {
+    if (mode_ == Mode::AGGRESSIVE) {
+        return PreservedAnalyses::None();
+    }
+    return PreservedAnalyses::None().Preserve<DominatorTree>().Preserve<PostDominatorTree>();
+}
+
+void DeadCodeEliminationPass::RunOnFunction(Function* function) {
+    function_ = function;
+    marked_.Clear();
+    worklist_.clear();
+    if (mode_ == Mode::AGGRESSIVE) {
+        RemoveAggressively();
+    } else {
+        RemoveUnused();
+    }
+}
+
+void DeadCodeEliminationPass::FindLocalAllocations() {
+    local_allocations_.Clear();
+    for (const BasicBlock* block : function_->GetBlocks()) {
+        for (const Operation* op : block->GetOperations()) {
+            if (const Variable* allocation = GetLocalAllocation(op)) {
+                local_allocations_.Insert(allocation);
+            }
+        }
+    }
+}
+
+// Operations that have to stay even if their results are unused
+bool DeadCodeEliminationPass::IsRoot(const Operation* op) const {
+    switch (op->OpCode()) {
+        case OpCodes::STORE_OP:
+            return !local_allocations_.Has(StoreAddress(op));
+        case OpCodes::CALL_OP:
+        case OpCodes::RETVOID_OP:
+        case OpCodes::RETVALUE_OP:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void DeadCodeEliminationPass::RemoveUnused() {
+    FindLocalAllocations();
+    live_uses_.Clear();
+    live_stores_.Clear();
+    for (BasicBlock* block : function_->GetBlocks()) {
+        for (Operation* op : block->GetOperations()) {
+            for (const Value* argument : op->GetArguments()) {
+                if (isa<Variable>(argument)) {
+                    ++live_uses_[argument];
+                }
+            }
+            worklist_.push_back(op);
+        }
+    }
+    for (BasicBlock* block : function_->GetBlocks()) {
+        for (Operation* op : block->GetOperations()) {
+            if (op->OpCode() == OpCodes::STORE_OP && local_allocations_.Has(StoreAddress(op))) {
+                ++live_stores_[StoreAddress(op)];
+            }
+        }
+    }
+
+    while (!worklist_.empty()) {
+        const Operation* op = worklist_.back();
+        worklist_.pop_back();
+        if (!marked_.Has(op) && IsUnused(op)) {
+            MarkDead(op);
+        }
+    }
+
+    std::size_t removed = 0;
+    for (BasicBlock* block : function_->GetBlocks()) {
+        auto ops = block->GetOperations();
+        for (auto it = ops.begin(); it != ops.end();) {
+            if (marked_.Has(*it)) {
+                it = block->DeleteAt(it);
+                ++removed;
+            } else {
+                ++it;
+            }
+        }
+    }
+    Count("removed operations", removed);
+}
+
+bool DeadCodeEliminationPass::IsUnused(const Operation* op) {
+    if (op->OpCode() == OpCodes::STORE_OP) {
+        // Nothing reads the memory
+        const Value* address = StoreAddress(op);
+        return local_allocations_.Has(address) && live_uses_[address] == live_stores_[address];
+    }
+    auto result = op->GetReturnValue();
+    if (!result.has_value() || live_uses_[result.value()] != 0) {
+        return false;
+    }
+    if (op->OpCode() == OpCodes::LOAD_OP) {
+        return local_allocations_.Has(op->GetArguments()[0]);
+    }
+    return IsPure(op);
+}
+
+void DeadCodeEliminationPass::MarkDead(const Operation* op) {
+    marked_.Insert(op);
+    const bool is_store = op->OpCode() == OpCodes::STORE_OP;
+    for (const Value* argument : op->GetArguments()) {
+        if (!isa<Variable>(argument)) {
+            continue;
+        }
+        --live_uses_[argument];
+        if (is_store && argument == StoreAddress(op) && local_allocations_.Has(argument)) {
+            --live_stores_[argument];
+        }
+        for (const Use* definition : argument->Definitions()) {
+            worklist_.push_back(definition->GetUser());
+        }
+        if (local_allocations_.Has(argument)) {
+            // The remaining stores may have become dead
+            for (const Use* use : argument->Uses()) {
+                worklist_.push_back(use->GetUser());
+            }
+        }
+    }
+}
+
+void DeadCodeEliminationPass::RemoveAggressively() {
+    auto post_dominators = GetAnalysis<PostDominatorTree>(function_);
+    ComputeControlDependences(*post_dominators);
+    FindLocalAllocations();
+    live_blocks_.Clear();
+
+    std::vector<BasicBlock*> blocks(function_->BlockIndexBound(), nullptr);
+    for (BasicBlock* block : function_->GetBlocks()) {
+        blocks[block->GetIndex()] = block;
+        for (const Operation* op : block->GetOperations()) {
+            if (IsRoot(op)) {
+                MarkLive(op);
+            }
+        }
+        const Operation* terminator = block->GetTerminator();
+        if (terminator == nullptr || terminator->OpCode() != OpCodes::COND_BRANCH_OP) {
+            continue;
+        }
+        if (!post_dominators->IsReachable(block)) {
+            // Keeps infinite loops, blocks control depending on them do as well
+            MarkBlockLive(block);
+            MarkLive(terminator);
+        } else if (post_dominators->GetIDom(block) == nullptr) {
+            // Paths to different exits, there is nothing to jump to instead
+            MarkLive(terminator);
+        }
+    }
+
+    while (!worklist_.empty()) {
+        const Operation* op = worklist_.back();
+        worklist_.pop_back();
+        MarkBlockLive(op->GetBlock());
+        for (const Value* argument : op->GetArguments()) {
+            for (const Use* definition : argument->Definitions()) {
+                MarkLive(definition->GetUser());
+            }
+        }
+        if (op->OpCode() == OpCodes::LOAD_OP && local_allocations_.Has(op->GetArguments()[0])) {
+            for (const Use* use : op->GetArguments()[0]->Uses()) {
+                if (use->GetUser()->OpCode() == OpCodes::STORE_OP) {
+                    MarkLive(use->GetUser());
+                }
+            }
+        }
+        if (op->OpCode() == OpCodes::PHI_OP) {
+            const auto* phi = static_cast<const PhiOp*>(op);
+            for (std::size_t i = 0; i < phi->IncomingCount(); ++i) {
+                MarkBlockLive(phi->IncomingBlock(i));
+            }
+        }
+    }
+
+    std::size_t removed = 0;
+    std::size_t folded = 0;
+    for (BasicBlock* block : function_->GetBlocks()) {
+        auto ops = block->GetOperations();
+        for (auto it = ops.begin(); it != ops.end();) {
+            Operation* op = *it;
+            if (marked_.Has(op) || op->OpCode() == OpCodes::BRANCH_OP) {
+                ++it;
+                continue;
+            }
+            if (op->OpCode() == OpCodes::COND_BRANCH_OP) {
+                // No live operation depends on the choice, so the paths meet again unchanged
+                BasicBlock* target = blocks[post_dominators->GetIDom(block)->GetIndex()];
+                it = block->InsertAt(it, function_->MakeOperation<BranchOperation>(function_,
+                                                                                  target));
+                ++it;
+                ++folded;
+            } else {
+                ++removed;
+            }
+            it = block->DeleteAt(it);
+        }
+    }
+    Count("removed operations", removed);
+    Count("folded branches", folded);
+}
+
+void DeadCodeEliminationPass::ComputeControlDependences(
+    const PostDominatorTree& post_dominators) {
+    control_dependences_.assign(function_->BlockIndexBound(), {});
+    for (const BasicBlock* block : function_->GetBlocks()) {
+        if (block->Successors().size() < 2) {
+            continue;
+        }
+        // Blocks on the way from a successor up to the immediate post-dominator of the branch
+        const BasicBlock* stop = post_dominators.GetIDom(block);
+        for (const BasicBlock* successor : block->Successors()) {
+            for (const BasicBlock* runner = successor; runner != nullptr && runner != stop;
+                 runner = post_dominators.GetIDom(runner)) {
+                auto& dependences = control_dependences_[runner->GetIndex()];
+                if (dependences.empty() || dependences.back() != block) {
+                    dependences.push_back(block);
+                }
+            }
+        }
+    }
+}
+
+void DeadCodeEliminationPass::MarkLive(const Operation* op) {
+    if (!marked_.Has(op)) {
+        marked_.Insert(op);
+        worklist_.push_back(op);
+    }
+}
+
+void DeadCodeEliminationPass::MarkBlockLive(const BasicBlock* block) {
+    if (live_blocks_.Has(block)) {
+        return;
+    }
+    live_blocks_.Insert(block);
+    for (const BasicBlock* dependence : control_dependences_[block->GetIndex()]) {
+        MarkLive(dependence->GetTerminator());
+    }
+}
+
+}  // namespace bier
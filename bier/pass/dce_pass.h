@@ -0,0 +1,82 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+
+#include <bier/analysis/dominator_tree.h>
+#include <bier/pass/function_pass.h>
+
+namespace bier {
+
+// Deletes operations without side effects whose results are never used.
+//
+// The USES mode looks at uses only. Besides pure operations it removes loads from allocations
+// that never escape, and stores into such allocations once nothing loads from them.
+// The AGGRESSIVE mode assumes everything dead until proven live. Returns, calls and stores to
+// memory that may escape are live, and so are the definitions of operands of live operations,
+// the stores into local allocations that live loads read and the branches that blocks with
+// live operations are control dependent on. A dead conditional branch becomes a jump to
+// the immediate post-dominator of its block. The emptied blocks are left to CFG simplification.
+class DeadCodeEliminationPass : public FunctionPass {
+public:
+    enum class Mode { USES, AGGRESSIVE };
+
+    explicit DeadCodeEliminationPass(Mode mode = Mode::USES) : mode_(mode) {
+    }
+
+    // ModulePass interface
+    PreservedAnalyses GetPreservedAnalyses() const override;
+
+protected:
+    // FunctionPass interface
+    void RunOnFunction(Function* function) override;
+    std::unique_ptr<FunctionPass> CloneForThread() const override {
+        return std::make_unique<DeadCodeEliminationPass>(mode_);
+    }
+
+private:
+    Mode mode_;
+    Function* function_ = nullptr;
+    // Operations found dead or live, depending on the mode
+    DenseIndexSet<Operation> marked_;
+    std::vector<const Operation*> worklist_;
+
+    DenseValueSet local_allocations_;
+
+    // USES mode
+    // Operand slots of variables in operations not found dead yet
+    DenseValueMap<std::uint32_t> live_uses_;
+    // Stores into local allocations not found dead yet
+    DenseValueMap<std::uint32_t> live_stores_;
+
+    // AGGRESSIVE mode
+    DenseBlockSet live_blocks_;
+    // Blocks ending with a branch the key block is control dependent on
+    std::vector<std::vector<const BasicBlock*>> control_dependences_;
+
+    void FindLocalAllocations();
+    bool IsRoot(const Operation* op) const;
+
+    void RemoveUnused();
+    bool IsUnused(const Operation* op);
+    void MarkDead(const Operation* op);
+
+    void RemoveAggressively();
+    void ComputeControlDependences(const PostDominatorTree& post_dominators);
+    void MarkLive(const Operation* op);
+    void MarkBlockLive(const BasicBlock* block);
+};
+
+}  // namespace bier
@@ -0,0 +1,153 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "function_cloner.h"
+#include <bier/core/exceptions.h>
+#include <bier/operations/ops.h>
+#include <bier/utils/casting.h>
+
+namespace bier {
+
+FunctionCloner::FunctionCloner(const Function* source, Function* target, std::string prefix)
+    : source_(source), target_(target), prefix_(std::move(prefix)) {
+}
+
+void FunctionCloner::MapValue(const Value* from, const Value* to) {
+    assert(from->GetIndex() != kNoDenseIndex);
+    values_[from] = to;
+}
+
+std::vector<BasicBlock*> FunctionCloner::CloneBody(BasicBlock* insert_after) {
+    std::vector<BasicBlock*> clones;
+    for (const BasicBlock* block : source_->GetBlocks()) {
+        insert_after = target_->CreateBlock(prefix_ + block->GetLabel(), insert_after);
+        blocks_.Insert(block, insert_after);
+        clones.push_back(insert_after);
+    }
+    // Branches need all the blocks, operands defined later are created on first use
+    for (const BasicBlock* block : source_->GetBlocks()) {
+        BasicBlock* clone = blocks_.At(block);
+        for (const Operation* op : block->GetOperations()) {
+            clone->InsertAt(clone->GetOperations().end(), CloneOperation(op));
+        }
+    }
+    return clones;
+}
+
+const Value* FunctionCloner::GetMapped(const Value* value) {
+    if (value->GetIndex() == kNoDenseIndex) {
+        return value;
+    }
+    if (values_.Has(value)) {
+        return values_.At(value);
+    }
+    check(isa<Variable>(value),
+          IRException("no value for argument " + value->GetName() + " of cloned function",
+                      source_));
+    return MapVariable(static_cast<const Variable*>(value));
+}
+
+const Variable* FunctionCloner::MapVariable(const Variable* variable) {
+    if (values_.Has(variable)) {
+        return static_cast<const Variable*>(values_.At(variable));
+    }
+    const Variable* clone = target_->AllocateVariable(Variable::Metadata(
+        prefix_ + variable->GetName(), variable->GetType(), variable->IsMutable()));
+    values_.Insert(variable, clone);
+    return clone;
+}
+
+std::optional<const Variable*> FunctionCloner::MapResult(const Operation* op) {
+    auto result = op->GetReturnValue();
+    if (!result.has_value()) {
+        return std::nullopt;
+    }
+    return MapVariable(result.value());
+}
+
+OperationPtr FunctionCloner::CloneOperation(const Operation* op) {
+    auto arguments = op->GetArguments();
+    auto result = MapResult(op);
+    const int opcode = op->OpCode();
+    if (opcode <= OpCodes::STORE_OP) {
+        const auto* binary = static_cast<const BinaryOperation*>(op);
+        return target_->MakeOperation<BinaryOperation>(
+            target_, binary->GetOp(), GetMapped(binary->LeftValue()),
+            GetMapped(binary->RightValue()), result.value_or(nullptr));
+    }
+    switch (opcode) {
+        case OpCodes::ALLOC_OP:
+        case OpCodes::LOAD_OP:
+        case OpCodes::ASSIGN_OP:
+            return target_->MakeOperation<UnaryOperation>(
+                target_, static_cast<const UnaryOperation*>(op)->GetOp(),
+                GetMapped(arguments[0]), result.value());
+        case OpCodes::CONST_OP:
+            return target_->MakeOperation<ConstOperation>(
+                target_, static_cast<const ConstValue*>(arguments[0]), result.value());
+        case OpCodes::RETVOID_OP:
+            return target_->MakeOperation<ReturnVoidOp>(target_);
+        case OpCodes::RETVALUE_OP:
+            return target_->MakeOperation<ReturnValueOp>(target_, GetMapped(arguments[0]));
+        case OpCodes::GEP_OP: {
+            const auto* gep = static_cast<const GEPOp*>(op);
+            auto map_offset = [this](std::optional<const Value*> offset) {
+                return offset.has_value() ? std::optional(GetMapped(offset.value()))
+                                          : std::nullopt;
+            };
+            return target_->MakeOperation<GEPOp>(
+                target_, GetMapped(arguments[0]), gep->ElementIndex(), result.value(),
+                gep->GetLayout(), map_offset(gep->BaseOffset()), map_offset(gep->ElementOffset()));
+        }
+        case OpCodes::CALL_OP: {
+            const auto* call = static_cast<const CallOp*>(op);
+            std::vector<const Value*> call_arguments;
+            for (std::size_t i = 1; i < arguments.size(); ++i) {
+                call_arguments.push_back(GetMapped(arguments[i]));
+            }
+            return target_->MakeOperation<CallOp>(target_, call->FuncType(),
+                                                  GetMapped(call->Callee()), result,
+                                                  call_arguments);
+        }
+        case OpCodes::BRANCH_OP:
+            return target_->MakeOperation<BranchOperation>(
+                target_, GetMapped(op->GetSuccessors()[0]));
+        case OpCodes::COND_BRANCH_OP:
+            return target_->MakeOperation<ConditionalBranchOperation>(
+                target_, GetMapped(arguments[0]), GetMapped(op->GetSuccessors()[0]),
+                GetMapped(op->GetSuccessors()[1]));
+        case OpCodes::CAST_OP:
+            return target_->MakeOperation<CastOperation>(target_, GetMapped(arguments[0]),
+                                                         result.value());
+        case OpCodes::ALLOC_LAYOUT_OP:
+            return target_->MakeOperation<AllocateLayout>(
+                target_, static_cast<const AllocateLayout*>(op)->GetLayout(),
+                GetMapped(arguments[0]), result.value());
+        case OpCodes::PHI_OP: {
+            const auto* phi = static_cast<const PhiOp*>(op);
+            std::vector<BasicBlock*> blocks;
+            std::vector<const Value*> values;
+            for (std::size_t i = 0; i < phi->IncomingCount(); ++i) {
+                blocks.push_back(GetMapped(phi->IncomingBlock(i)));
+                values.push_back(GetMapped(phi->IncomingValue(i)));
+            }
+            return target_->MakeOperation<PhiOp>(target_, result.value(), blocks, values);
+        }
+        default:
+            throw IRException("cannot clone operation", source_);
+    }
+}
+
+}  // namespace bier
@@ -0,0 +1,55 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+
+#include <bier/core/function.h>
+#include <bier/utils/dense_map.h>
+
+namespace bier {
+
+// Copies the body of a function into another one. Operands, results and branch targets are
+// remapped: arguments to the values given with MapValue, variables to fresh variables of the
+// target named with the prefix, blocks to their copies. Module-level values and constants are
+// shared between the functions.
+class FunctionCloner {
+public:
+    FunctionCloner(const Function* source, Function* target, std::string prefix);
+
+    void MapValue(const Value* from, const Value* to);
+
+    // Copies every block of the source right after insert_after, keeping their order. The
+    // copy of the entry block goes first.
+    std::vector<BasicBlock*> CloneBody(BasicBlock* insert_after);
+
+    // Creates the copy of a variable on first use
+    const Value* GetMapped(const Value* value);
+    BasicBlock* GetMapped(const BasicBlock* block) const {
+        return blocks_.At(block);
+    }
+
+private:
+    const Function* source_ = nullptr;
+    Function* target_ = nullptr;
+    std::string prefix_;
+    DenseValueMap<const Value*> values_;
+    DenseIndexMap<BasicBlock, BasicBlock*> blocks_;
+
+    const Variable* MapVariable(const Variable* variable);
+    std::optional<const Variable*> MapResult(const Operation* op);
+    OperationPtr CloneOperation(const Operation* op);
+};
+
+}  // namespace bier
@@ -0,0 +1,68 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "function_pass.h"
+#include <bier/pass/thread_pool.h>
+
+namespace bier {
+
+void FunctionPass::Apply(ModulePtr&& module) {
+    current_module_ = std::move(module);
+    module_ = current_module_.get();
+    ResetCounters();
+    std::vector<Function*> functions;
+    for (auto& [name, func] : module_->GetDefinedFunctions()) {
+        functions.push_back(func.get());
+    }
+
+    ThreadPool* pool = GetThreadPool();
+    if (pool == nullptr || pool->Size() == 1 || functions.size() < 2) {
+        for (Function* function : functions) {
+            RunOnFunction(function);
+            function->Normalize();
+        }
+        return;
+    }
+
+    std::vector<std::unique_ptr<FunctionPass>> clones(pool->Size());
+    pool->ParallelFor(functions.size(), [&](std::size_t index, std::size_t participant) {
+        ConcurrentEditScope scope(module_);
+        FunctionPass* pass = this;
+        if (participant != 0) {
+            auto& clone = clones[participant];
+            if (clone == nullptr) {
+                clone = CloneForThread();
+                clone->module_ = module_;
+                clone->SetAnalysisManager(GetAnalysisManager());
+                clone->SetThreadPool(pool);
+            }
+            pass = clone.get();
+        }
+        pass->RunOnFunction(functions[index]);
+        functions[index]->Normalize();
+    });
+    for (const auto& clone : clones) {
+        if (clone != nullptr) {
+            MergeCounters(*clone);
+        }
+    }
+}
+
+ModulePtr FunctionPass::GetTransformed() {
+    module_ = nullptr;
+    return std::move(current_module_);
+}
+
+}  // namespace bier
@@ -0,0 +1,49 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+#include <bier/pass/transform_pass.h>
+
+namespace bier {
+
+// Transforms every defined function on its own. With a thread pool set, functions are spread
+// over its threads and every thread but the calling one runs a fresh clone of the pass, sharing
+// the analysis manager of this one.
+class FunctionPass : public TransformPass {
+public:
+    // ModulePass interface
+    void Apply(ModulePtr&& module) override;
+
+    // TransformPass interface
+    ModulePtr GetTransformed() override;
+
+protected:
+    virtual void RunOnFunction(Function* function) = 0;
+    // Instance of the same pass for another thread, sharing nothing with this one
+    virtual std::unique_ptr<FunctionPass> CloneForThread() const = 0;
+
+    Module* GetModule() const {
+        return module_;
+    }
+    DefaultTypesRegistry* Types() const {
+        return module_->Types();
+    }
+
+private:
+    ModulePtr current_module_;
+    Module* module_ = nullptr;
+};
+
+}  // namespace bier
@@ -0,0 +1,164 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gvn_pass.h"
+#include <bier/analysis/memory_utils.h>
+#include <bier/operations/gep.h>
+#include <bier/utils/casting.h>
+#include <boost/functional/hash.hpp>
+
+namespace bier {
+
+namespace {
+
+bool IsCommutative(int opcode) {
+    switch (opcode) {
+        case OpCodes::ADD_OP:
+        case OpCodes::MULT_OP:
+        case OpCodes::EQ_OP:
+        case OpCodes::NE_OP:
+            return true;
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+HashType GlobalValueNumberingPass::Expression::Hash::operator()(
+    const Expression& expression) const {
+    HashType hash = 0;
+    boost::hash_combine(hash, expression.opcode);
+    boost::hash_combine(hash, expression.type);
+    boost::hash_combine(hash, expression.layout);
+    boost::hash_combine(hash, expression.element_index);
+    boost::hash_combine(hash, expression.has_base_offset);
+    for (const Value* operand : expression.operands) {
+        boost::hash_combine(hash, operand);
+    }
+    return hash;
+}
+
+bool GlobalValueNumberingPass::Expression::operator==(const Expression& other) const {
+    return opcode == other.opcode && type == other.type && layout == other.layout &&
+           element_index == other.element_index && has_base_offset == other.has_base_offset &&
+           operands == other.operands;
+}
+
+PreservedAnalyses GlobalValueNumberingPass::GetPreservedAnalyses() const {
+    return PreservedAnalyses::None().Preserve<DominatorTree>().Preserve<PostDominatorTree>();
+}
+
+std::optional<GlobalValueNumberingPass::Expression> GlobalValueNumberingPass::MakeExpression(
+    const Operation* op) {
+    const int opcode = op->OpCode();
+    const bool is_binary = opcode < OpCodes::STORE_OP;
+    if (!is_binary && opcode != OpCodes::GEP_OP && opcode != OpCodes::CAST_OP &&
+        opcode != OpCodes::CONST_OP) {
+        return std::nullopt;
+    }
+    auto result = op->GetReturnValue();
+    if (!result.has_value() || result.value()->GetDefiningOp() != op) {
+        return std::nullopt;
+    }
+
+    Expression expression;
+    expression.opcode = opcode;
+    expression.type = result.value()->GetType();
+    auto arguments = op->GetArguments();
+    assert(arguments.size() <= expression.operands.size());
+    for (std::size_t i = 0; i < arguments.size(); ++i) {
+        if (!HasSingleValue(arguments[i])) {
+            return std::nullopt;
+        }
+        expression.operands[i] = arguments[i];
+    }
+    if (IsCommutative(opcode) && std::less<>()(expression.operands[1], expression.operands[0])) {
+        std::swap(expression.operands[0], expression.operands[1]);
+    }
+    if (opcode == OpCodes::GEP_OP) {
+        const auto* gep = static_cast<const GEPOp*>(op);
+        expression.layout = gep->GetLayout();
+        expression.element_index = gep->ElementIndex();
+        expression.has_base_offset = gep->BaseOffset().has_value();
+    }
+    return expression;
+}
+
+void GlobalValueNumberingPass::RunOnFunction(Function* function) {
+    auto dominators = GetAnalysis<DominatorTree>(function);
+    std::vector<BasicBlock*> blocks(function->BlockIndexBound(), nullptr);
+    for (BasicBlock* block : function->GetBlocks()) {
+        blocks[block->GetIndex()] = block;
+    }
+    available_.clear();
+    scopes_.clear();
+
+    // Preorder walk of the dominator tree, a block leaves its expressions in available_ for the
+    // subtree and the marks pop them once the walk returns past it
+    struct Visit {
+        const BasicBlock* block;
+        std::size_t scope_begin;
+        bool leaving;
+    };
+    std::vector<Visit> stack;
+    for (const BasicBlock* root : dominators->GetRoots()) {
+        stack.push_back({root, 0, false});
+    }
+    std::uint32_t budget = budget_;
+    std::size_t removed = 0;
+    while (!stack.empty()) {
+        const Visit visit = stack.back();
+        stack.pop_back();
+        if (visit.leaving) {
+            for (std::size_t i = visit.scope_begin; i < scopes_.size(); ++i) {
+                available_.erase(scopes_[i]);
+            }
+            scopes_.resize(visit.scope_begin);
+            continue;
+        }
+
+        stack.push_back({visit.block, scopes_.size(), true});
+        BasicBlock* block = blocks[visit.block->GetIndex()];
+        auto ops = block->GetOperations();
+        for (auto it = ops.begin(); it != ops.end() && budget != 0;) {
+            auto expression = MakeExpression(*it);
+            if (!expression.has_value()) {
+                ++it;
+                continue;
+            }
+            --budget;
+            const Variable* result = (*it)->GetReturnValue().value();
+            auto [existing, inserted] = available_.emplace(expression.value(), result);
+            if (inserted) {
+                scopes_.push_back(expression.value());
+                ++it;
+                continue;
+            }
+            result->ReplaceAllUsesWith(existing->second);
+            it = block->DeleteAt(it);
+            ++removed;
+        }
+        if (budget == 0) {
+            break;
+        }
+        for (const BasicBlock* child : dominators->GetChildren(visit.block)) {
+            stack.push_back({child, 0, false});
+        }
+    }
+    Count("removed operations", removed);
+}
+
+}  // namespace bier
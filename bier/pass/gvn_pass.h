@@ -0,0 +1,77 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+
+#include <bier/analysis/dominator_tree.h>
+#include <bier/core/layout.h>
+#include <bier/pass/function_pass.h>
+#include <array>
+#include <limits>
+
+namespace bier {
+
+// Removes operations recomputing a value that an operation in a dominating position already
+// holds. Expressions are keyed by opcode, result type and operands, with the operands of
+// commutative operators ordered, plus the layout and element index of GEPs. Operations reading
+// or defining variables assigned more than once are not numbered, equal keys would not mean
+// equal values for them.
+// The budget caps the number of operations numbered per function, the rest of the function is
+// left as is.
+class GlobalValueNumberingPass : public FunctionPass {
+public:
+    static constexpr std::uint32_t kNoBudget = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::uint32_t kDefaultBudget = 1u << 14u;
+
+    explicit GlobalValueNumberingPass(std::uint32_t budget = kNoBudget) : budget_(budget) {
+    }
+
+    // ModulePass interface
+    PreservedAnalyses GetPreservedAnalyses() const override;
+
+protected:
+    // FunctionPass interface
+    void RunOnFunction(Function* function) override;
+    std::unique_ptr<FunctionPass> CloneForThread() const override {
+        return std::make_unique<GlobalValueNumberingPass>(budget_);
+    }
+
+private:
+    struct Expression {
+        struct Hash {
+            HashType operator()(const Expression& expression) const;
+        };
+
+        bool operator==(const Expression& other) const;
+
+        int opcode = 0;
+        const Type* type = nullptr;
+        // GEP only
+        const Layout* layout = nullptr;
+        int element_index = -1;
+        bool has_base_offset = false;
+        std::array<const Value*, 3> operands{};
+    };
+
+    std::uint32_t budget_;
+    // Expressions computed in the dominators of the current block
+    HashMap<Expression, const Variable*> available_;
+    // Expressions added to available_ by the blocks on the dominator tree path
+    std::vector<Expression> scopes_;
+
+    static std::optional<Expression> MakeExpression(const Operation* op);
+};
+
+}  // namespace bier
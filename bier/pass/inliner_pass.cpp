@@ -0,0 +1,197 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "inliner_pass.h"
+#include <bier/analysis/call_graph.h>
+#include <bier/analysis/loop_info.h>
+#include <bier/analysis/memory_utils.h>
+#include <bier/operations/ops.h>
+#include <bier/pass/function_cloner.h>
+#include <bier/utils/casting.h>
+
+namespace bier {
+
+namespace {
+
+const Function* DirectCallee(const CallOp* call) {
+    return dyn_cast<Function>(call->Callee());
+}
+
+bool DefinesArguments(const Function* function) {
+    for (const ArgumentValue* argument : function->GetSignature()->Arguments()) {
+        if (!argument->Definitions().Empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool IsStaticAllocation(const Operation* op) {
+    return IsAllocation(op) && isa<IntegerConst>(op->GetArguments()[0]);
+}
+
+}  // namespace
+
+void InlinerPass::Apply(ModulePtr&& module) {
+    module_ = std::move(module);
+    inlined_ = 0;
+    ResetCounters();
+    StdHashMap<const Function*, Function*> functions;
+    for (auto& [signature, function] : module_->GetDefinedFunctions()) {
+        functions[function.get()] = function.get();
+    }
+    const CallGraph call_graph(module_.get());
+    for (const auto& component : call_graph.GetBottomUpOrder()) {
+        for (const Function* function : component) {
+            Function* caller = functions.at(function);
+            InlineCalls(caller, call_graph);
+            caller->Normalize();
+        }
+    }
+    Count("inlined calls", inlined_);
+}
+
+ModulePtr InlinerPass::GetTransformed() {
+    return std::move(module_);
+}
+
+int InlinerPass::GetCost(const CallOp* call, std::uint32_t loop_depth) const {
+    int cost = static_cast<int>(DirectCallee(call)->CountOperations()) - cost_model_.call_bonus -
+               cost_model_.loop_depth_bonus * static_cast<int>(loop_depth);
+    auto arguments = call->GetArguments();
+    for (std::size_t i = 1; i < arguments.size(); ++i) {
+        if (isa<IntegerConst>(arguments[i])) {
+            cost -= cost_model_.constant_argument_bonus;
+        }
+    }
+    return cost;
+}
+
+void InlinerPass::InlineCalls(Function* caller, const CallGraph& call_graph) {
+    std::vector<std::pair<CallOp*, std::uint32_t>> candidates;
+    {
+        auto loops = GetAnalysis<LoopInfo>(caller);
+        for (BasicBlock* block : caller->GetBlocks()) {
+            for (Operation* op : block->GetOperations()) {
+                if (op->OpCode() != OpCodes::CALL_OP) {
+                    continue;
+                }
+                auto* call = static_cast<CallOp*>(op);
+                const Function* callee = DirectCallee(call);
+                if (callee == nullptr || callee->GetBlocks().Size() == 0 ||
+                    call_graph.InSameComponent(caller, callee) || DefinesArguments(callee)) {
+                    continue;
+                }
+                candidates.emplace_back(call, loops->GetLoopDepth(block));
+            }
+        }
+    }
+
+    std::size_t size = caller->CountOperations();
+    for (auto [call, loop_depth] : candidates) {
+        const std::size_t callee_size = DirectCallee(call)->CountOperations();
+        if (!ShouldInline(call, loop_depth) || size + callee_size > cost_model_.caller_size_limit) {
+            continue;
+        }
+        size += callee_size;
+        InlineCall(caller, call);
+    }
+}
+
+void InlinerPass::InlineCall(Function* caller, CallOp* call) {
+    const Function* callee = DirectCallee(call);
+    BasicBlock* block = call->GetBlock();
+    const std::string prefix = callee->GetName() + "." + std::to_string(inlined_++) + ".";
+
+    FunctionCloner cloner(callee, caller, prefix);
+    auto arguments = call->GetArguments();
+    std::size_t index = 1;
+    for (const ArgumentValue* argument : callee->GetSignature()->Arguments()) {
+        cloner.MapValue(argument, arguments[index++]);
+    }
+
+    // The operations after the call continue in a new block. It is in the same loops as the
+    // block, so the loop depths taken for the remaining candidates before inlining stay right.
+    auto call_it = block->GetIterator(call);
+    BasicBlock* continuation = caller->CreateBlock(prefix + "return", block);
+    continuation->Splice(continuation->GetOperations().end(), block, std::next(call_it),
+                         block->GetOperations().end());
+    for (BasicBlock* successor : continuation->Successors()) {
+        PhiOp::ReplaceIncomingBlock(successor, block, continuation);
+    }
+    std::vector<BasicBlock*> body = cloner.CloneBody(block);
+
+    auto result = call->GetReturnValue();
+    const bool result_has_single_definition =
+        result.has_value() && result.value()->GetDefiningOp() == call;
+    auto end = block->DeleteAt(call_it);
+    block->InsertAt(end, caller->MakeOperation<BranchOperation>(caller, body.front()));
+
+    // Allocations of a fixed size go to the entry, so a call in a loop does not grow the stack.
+    // All iterations then share the memory, which is only valid because an allocation does not
+    // outlive the call of the callee, i.e. the iteration it was made in.
+    BasicBlock* entry = caller->GetEntryBlock();
+    auto callee_entry_ops = body.front()->GetOperations();
+    const bool runs_once = body.front()->Predecessors().size() == 1;
+    for (auto it = callee_entry_ops.begin(); runs_once && it != callee_entry_ops.end();) {
+        auto next = std::next(it);
+        if (IsStaticAllocation(*it)) {
+            entry->Splice(entry->GetOperations().begin(), body.front(), it);
+        }
+        it = next;
+    }
+
+    std::vector<BasicBlock*> returning;
+    std::vector<const Value*> returned;
+    for (BasicBlock* clone : body) {
+        auto ops = clone->GetOperations();
+        auto last = std::prev(ops.end());
+        const int opcode = (*last)->OpCode();
+        if (opcode != OpCodes::RETVOID_OP && opcode != OpCodes::RETVALUE_OP) {
+            continue;
+        }
+        returning.push_back(clone);
+        if (opcode == OpCodes::RETVALUE_OP) {
+            returned.push_back((*last)->GetArguments()[0]);
+        }
+        auto clone_end = clone->DeleteAt(last);
+        clone->InsertAt(clone_end, caller->MakeOperation<BranchOperation>(caller, continuation));
+    }
+
+    if (!result.has_value()) {
+        return;
+    }
+    const Variable* result_variable = result.value();
+    if (returned.empty()) {
+        // The callee never returns
+        if (result_has_single_definition) {
+            result_variable->ReplaceAllUsesWith(
+                caller->Constants()->GetUndef(result_variable->GetType()));
+        }
+    } else if (returned.size() == 1 && result_has_single_definition) {
+        result_variable->ReplaceAllUsesWith(returned.front());
+    } else if (returned.size() == 1) {
+        continuation->InsertAt(continuation->GetOperations().begin(),
+                               caller->MakeOperation<UnaryOperation>(
+                                   caller, UnaryOperation::UnOp::ASSIGN, returned.front(),
+                                   result_variable));
+    } else {
+        continuation->InsertAt(
+            continuation->GetOperations().begin(),
+            caller->MakeOperation<PhiOp>(caller, result_variable, returning, returned));
+    }
+}
+
+}  // namespace bier
@@ -0,0 +1,73 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+
+#include <bier/pass/transform_pass.h>
+
+namespace bier {
+
+class CallGraph;
+class CallOp;
+
+// Sizes are counted in operations. A call is inlined when the size of the callee less the
+// bonuses of the call site is within the threshold.
+struct InlineCostModel {
+    int threshold = 25;
+    // The call, its arguments and the return are gone
+    int call_bonus = 3;
+    // Per argument that is a constant at the call site, the body likely folds
+    int constant_argument_bonus = 5;
+    // Per loop the call site is nested in, as it likely runs more often
+    int loop_depth_bonus = 15;
+    // Inlining stops once a caller grows past this
+    std::size_t caller_size_limit = 4096;
+};
+
+// Copies the bodies of small defined functions into their callers. Functions are visited
+// bottom-up in the call graph, so callees have their own calls inlined first. Calls within
+// a cycle of the call graph are left as they are.
+class InlinerPass : public TransformPass {
+public:
+    explicit InlinerPass(InlineCostModel cost_model = InlineCostModel()) : cost_model_(cost_model) {
+    }
+
+    // ModulePass interface
+    void Apply(ModulePtr&& module) override;
+
+    // TransformPass interface
+    ModulePtr GetTransformed() override;
+
+    // Size of the callee less the bonuses, compared with the threshold
+    int GetCost(const CallOp* call, std::uint32_t loop_depth) const;
+    bool ShouldInline(const CallOp* call, std::uint32_t loop_depth) const {
+        return GetCost(call, loop_depth) <= cost_model_.threshold;
+    }
+
+    // Calls inlined by the last Apply
+    std::size_t GetInlinedCount() const {
+        return inlined_;
+    }
+
+private:
+    InlineCostModel cost_model_;
+    ModulePtr module_;
+    std::size_t inlined_ = 0;
+
+    void InlineCalls(Function* caller, const CallGraph& call_graph);
+    void InlineCall(Function* caller, CallOp* call);
+};
+
+}  // namespace bier
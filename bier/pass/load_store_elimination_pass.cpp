@@ -0,0 +1,269 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "load_store_elimination_pass.h"
+#include <bier/analysis/dataflow.h>
+#include <bier/analysis/memory_utils.h>
+#include <bier/operations/opcodes.h>
+#include <bier/utils/casting.h>
+
+namespace bier {
+
+namespace {
+
+std::uint32_t AllocationOf(const std::vector<std::uint32_t>& allocation_of,
+                           const Value* pointer) {
+    return isa<Variable>(pointer) ? allocation_of[pointer->GetIndex()] : kNoDenseIndex;
+}
+
+// Values known to be in the memory of every allocation, nullptr when unknown
+struct AvailableValues {
+    // Identity of the meet, for blocks no path has reached yet
+    bool top = true;
+    std::vector<const Value*> values;
+
+    bool operator==(const AvailableValues& other) const {
+        return top == other.top && values == other.values;
+    }
+};
+
+class AvailableValuesProblem {
+public:
+    using Domain = AvailableValues;
+    static constexpr DataflowDirection kDirection = DataflowDirection::FORWARD;
+
+    AvailableValuesProblem(const Function* function,
+                           const std::vector<std::uint32_t>* allocation_of,
+                           std::uint32_t allocations)
+        : function_(function), allocation_of_(allocation_of), allocations_(allocations) {
+    }
+
+    Domain Top() const {
+        return {true, std::vector<const Value*>(allocations_, nullptr)};
+    }
+    void Initialize(const BasicBlock* block, Domain* value) const {
+        value->top = block != function_->GetEntryBlock();
+        std::fill(value->values.begin(), value->values.end(), nullptr);
+    }
+    void Meet(Domain* into, const Domain& value) const {
+        if (value.top) {
+            return;
+        }
+        if (into->top) {
+            *into = value;
+            return;
+        }
+        for (std::size_t i = 0; i < allocations_; ++i) {
+            if (into->values[i] != value.values[i]) {
+                into->values[i] = nullptr;
+            }
+        }
+    }
+    bool Transfer(const BasicBlock* block, const Domain& in, Domain* out) const {
+        Domain result = in;
+        if (!result.top) {
+            for (const Operation* op : block->GetOperations()) {
+                Step(op, &result);
+            }
+        }
+        if (result == *out) {
+            return false;
+        }
+        *out = std::move(result);
+        return true;
+    }
+
+    // Updates the values past op, returns the value a load reads or a store overwrites
+    const Value* Step(const Operation* op, Domain* state) const {
+        if (op->OpCode() == OpCodes::LOAD_OP) {
+            const auto allocation = AllocationOf(*allocation_of_, LoadAddress(op));
+            if (allocation == kNoDenseIndex) {
+                return nullptr;
+            }
+            const Value*& value = state->values[allocation];
+            if (value == nullptr || value->GetType() != op->GetReturnValue().value()->GetType()) {
+                const Value* loaded = op->GetReturnValue().value();
+                value = HasSingleValue(loaded) ? loaded : nullptr;
+                return nullptr;
+            }
+            return value;
+        }
+        if (op->OpCode() == OpCodes::STORE_OP) {
+            const auto allocation = AllocationOf(*allocation_of_, StoreAddress(op));
+            if (allocation == kNoDenseIndex) {
+                return nullptr;
+            }
+            const Value* previous = state->values[allocation];
+            const Value* stored = StoredValue(op);
+            state->values[allocation] = HasSingleValue(stored) ? stored : nullptr;
+            return previous;
+        }
+        return nullptr;
+    }
+
+private:
+    const Function* function_;
+    const std::vector<std::uint32_t>* allocation_of_;
+    std::uint32_t allocations_;
+};
+
+// Allocations some load may read before the memory is overwritten
+class LiveAllocationsProblem : public GenKillProblem<DataflowDirection::BACKWARD, false> {
+public:
+    LiveAllocationsProblem(const Function* function,
+                           const std::vector<std::uint32_t>& allocation_of,
+                           const std::vector<bool>& uniform_stores, std::uint32_t allocations)
+        : GenKillProblem(function, allocations) {
+        for (const BasicBlock* block : function->GetBlocks()) {
+            auto& gen = gen_[block->GetIndex()];
+            auto& kill = kill_[block->GetIndex()];
+            auto ops = block->GetOperations();
+            for (auto it = ops.end(); it != ops.begin();) {
+                const Operation* op = *--it;
+                if (op->OpCode() == OpCodes::LOAD_OP) {
+                    const auto allocation = AllocationOf(allocation_of, LoadAddress(op));
+                    if (allocation != kNoDenseIndex) {
+                        gen.Set(allocation);
+                    }
+                } else if (op->OpCode() == OpCodes::STORE_OP) {
+                    const auto allocation = AllocationOf(allocation_of, StoreAddress(op));
+                    if (allocation != kNoDenseIndex && uniform_stores[allocation]) {
+                        gen.Reset(allocation);
+                        kill.Set(allocation);
+                    }
+                }
+            }
+        }
+    }
+};
+
+}  // namespace
+
+void LoadStoreEliminationPass::RunOnFunction(Function* function) {
+    function_ = function;
+    FindLocalAllocations();
+    if (allocations_ == 0) {
+        return;
+    }
+    ForwardValues();
+    RemoveDeadStores();
+}
+
+void LoadStoreEliminationPass::FindLocalAllocations() {
+    allocation_of_.assign(function_->ValueIndexBound(), kNoDenseIndex);
+    allocations_ = 0;
+    for (const BasicBlock* block : function_->GetBlocks()) {
+        for (const Operation* op : block->GetOperations()) {
+            if (const Variable* allocation = GetLocalAllocation(op)) {
+                allocation_of_[allocation->GetIndex()] = allocations_++;
+            }
+        }
+    }
+
+    uniform_stores_.assign(allocations_, true);
+    std::vector<const Type*> stored_type(allocations_, nullptr);
+    for (const BasicBlock* block : function_->GetBlocks()) {
+        for (const Operation* op : block->GetOperations()) {
+            if (op->OpCode() != OpCodes::STORE_OP) {
+                continue;
+            }
+            const auto allocation = AllocationOf(allocation_of_, StoreAddress(op));
+            if (allocation == kNoDenseIndex) {
+                continue;
+            }
+            const Type* type = StoredValue(op)->GetType();
+            if (stored_type[allocation] == nullptr) {
+                stored_type[allocation] = type;
+            } else if (stored_type[allocation] != type) {
+                uniform_stores_[allocation] = false;
+            }
+        }
+    }
+}
+
+void LoadStoreEliminationPass::ForwardValues() {
+    const DataflowSolver<AvailableValuesProblem> solver(
+        function_, AvailableValuesProblem(function_, &allocation_of_, allocations_));
+    const auto& problem = solver.GetProblem();
+    std::size_t forwarded = 0;
+    std::size_t removed = 0;
+    for (BasicBlock* block : function_->GetBlocks()) {
+        AvailableValues state = solver.GetBlockEntry(block);
+        if (state.top) {
+            // Unreachable
+            continue;
+        }
+        auto ops = block->GetOperations();
+        for (auto it = ops.begin(); it != ops.end();) {
+            Operation* op = *it;
+            const Value* known = problem.Step(op, &state);
+            if (op->OpCode() == OpCodes::LOAD_OP && known != nullptr) {
+                op->GetReturnValue().value()->ReplaceAllUsesWith(known);
+                it = block->DeleteAt(it);
+                ++forwarded;
+            } else if (op->OpCode() == OpCodes::STORE_OP && known != nullptr &&
+                       known == StoredValue(op)) {
+                it = block->DeleteAt(it);
+                ++removed;
+            } else {
+                ++it;
+            }
+        }
+    }
+    Count("forwarded loads", forwarded);
+    Count("removed stores", removed);
+}
+
+void LoadStoreEliminationPass::RemoveDeadStores() {
+    const DataflowSolver<LiveAllocationsProblem> solver(
+        function_,
+        LiveAllocationsProblem(function_, allocation_of_, uniform_stores_, allocations_));
+    std::size_t removed = 0;
+    for (BasicBlock* block : function_->GetBlocks()) {
+        DenseBitVector live = solver.GetBlockExit(block);
+        auto it = block->GetOperations().end();
+        // Deleting the first operation moves the beginning
+        while (it != block->GetOperations().begin()) {
+            --it;
+            const Operation* op = *it;
+            if (op->OpCode() == OpCodes::LOAD_OP) {
+                const auto allocation = AllocationOf(allocation_of_, LoadAddress(op));
+                if (allocation != kNoDenseIndex) {
+                    live.Set(allocation);
+                }
+                continue;
+            }
+            if (op->OpCode() != OpCodes::STORE_OP) {
+                continue;
+            }
+            const auto allocation = AllocationOf(allocation_of_, StoreAddress(op));
+            if (allocation == kNoDenseIndex) {
+                continue;
+            }
+            if (live.Test(allocation)) {
+                if (uniform_stores_[allocation]) {
+                    live.Reset(allocation);
+                }
+                continue;
+            }
+            // Nothing reads the value before it is overwritten or the function returns
+            it = block->DeleteAt(it);
+            ++removed;
+        }
+    }
+    Count("removed stores", removed);
+}
+
+}  // namespace bier
@@ -0,0 +1,62 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+
+#include <bier/analysis/dominator_tree.h>
+#include <bier/pass/function_pass.h>
+
+namespace bier {
+
+// Removes loads and stores of allocations which are only loaded from and stored to, like the
+// ones SSAPass creates for mutable variables. Such memory is private to the function and no
+// two allocations alias.
+// A forward dataflow finds the value every allocation holds on all paths to each point: a load
+// is replaced by that value and a store of the value the memory already holds is removed.
+// A backward dataflow then removes stores no load may read. A store only hides the ones before
+// it if all stores to the allocation have the same type: ALLOC_LAYOUT memory may be written
+// with values of different widths, and a narrower store overwrites a part of a wider one.
+// Within a block, memory operations are visited in the order of the sequence links of its
+// DAG, which is the order of the operations, so the block is scanned directly.
+// A stored value is only forwarded if it has a single definition, a variable reassigned
+// between the store and the load no longer holds what was stored.
+class LoadStoreEliminationPass : public FunctionPass {
+public:
+    // ModulePass interface
+    PreservedAnalyses GetPreservedAnalyses() const override {
+        return PreservedAnalyses::None().Preserve<DominatorTree>().Preserve<PostDominatorTree>();
+    }
+
+protected:
+    // FunctionPass interface
+    void RunOnFunction(Function* function) override;
+    std::unique_ptr<FunctionPass> CloneForThread() const override {
+        return std::make_unique<LoadStoreEliminationPass>();
+    }
+
+private:
+    Function* function_ = nullptr;
+    // Number of the local allocation of a pointer by value index, kNoDenseIndex for the rest
+    std::vector<std::uint32_t> allocation_of_;
+    std::uint32_t allocations_ = 0;
+    // Allocations which every store writes with a value of the same type, by their number
+    std::vector<bool> uniform_stores_;
+
+    void FindLocalAllocations();
+    void ForwardValues();
+    void RemoveDeadStores();
+};
+
+}  // namespace bier
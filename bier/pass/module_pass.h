@@ -14,14 +14,71 @@
    limitations under the License.
 */
 #pragma once
+#include <bier/analysis/analysis_manager.h>
 #include <bier/core/module.h>
 
 namespace bier {
 
+class ThreadPool;
+
 class ModulePass {
 public:
     virtual ~ModulePass() = default;
     virtual void Apply(ModulePtr&& module) = 0;
+
+    // Analyses still valid in the functions changed by Apply
+    virtual PreservedAnalyses GetPreservedAnalyses() const {
+        return PreservedAnalyses::None();
+    }
+
+    void SetAnalysisManager(AnalysisManager* analysis_manager) {
+        analysis_manager_ = analysis_manager;
+    }
+    AnalysisManager* GetAnalysisManager() const {
+        return analysis_manager_;
+    }
+
+    // Result of a function analysis from the analysis manager, computed afresh without one
+    template <typename TAnalysis>
+    std::shared_ptr<const TAnalysis> GetAnalysis(const Function* function) const {
+        if (analysis_manager_ != nullptr) {
+            return analysis_manager_->GetResult<TAnalysis>(function);
+        }
+        return std::make_shared<const TAnalysis>(function);
+    }
+
+    // Passes able to run in parallel use the pool, others ignore it
+    void SetThreadPool(ThreadPool* thread_pool) {
+        thread_pool_ = thread_pool;
+    }
+    ThreadPool* GetThreadPool() const {
+        return thread_pool_;
+    }
+
+    // Named counts of the changes made by the last Apply, e.g. removed operations
+    const StdHashMap<std::string, std::size_t>& GetCounters() const {
+        return counters_;
+    }
+
+protected:
+    void Count(const std::string& counter, std::size_t amount = 1) {
+        if (amount != 0) {
+            counters_[counter] += amount;
+        }
+    }
+    void ResetCounters() {
+        counters_.clear();
+    }
+    void MergeCounters(const ModulePass& other) {
+        for (const auto& [counter, amount] : other.counters_) {
+            counters_[counter] += amount;
+        }
+    }
+
+private:
+    StdHashMap<std::string, std::size_t> counters_;
+    AnalysisManager* analysis_manager_ = nullptr;
+    ThreadPool* thread_pool_ = nullptr;
 };
 
 }  // namespace bier
@@ -17,24 +17,16 @@
 
 namespace bier {
 
-void OperationPass::Apply(ModulePtr&& module) {
-    current_module_ = std::move(module);
-    for (auto& [name, func] : current_module_->GetDefinedFunctions()) {
-        OnFunction(func.get());
-        for (auto& block : func->GetBlocks()) {
-            auto ops = block.GetOperations();
-            for (auto it = ops.begin(); it != ops.end();) {
-                it = OperationTransformation(&block, it);
-            }
+void OperationPass::RunOnFunction(Function* function) {
+    OnFunction(function);
+    for (BasicBlock* block : function->GetBlocks()) {
+        auto ops = block->GetOperations();
+        for (auto it = ops.begin(); it != ops.end();) {
+            it = OperationTransformation(block, it);
         }
-        func->Normalize();
     }
 }
 
-ModulePtr OperationPass::GetTransformed() {
-    return std::move(current_module_);
-}
-
 void OperationPass::OnFunction(Function* /* function */) {
     return;
 }
@@ -44,8 +36,4 @@ OperationPass::OperationIterator OperationPass::OperationTransformation(
     return ++iterator;
 }
 
-DefaultTypesRegistry* OperationPass::Types() {
-    return current_module_->Types();
-}
-
 }  // namespace bier
@@ -14,28 +14,21 @@
    limitations under the License.
 */
 #pragma once
-#include <bier/pass/transform_pass.h>
+#include <bier/pass/function_pass.h>
 
 namespace bier {
 
-class OperationPass : public TransformPass {
+class OperationPass : public FunctionPass {
 public:
     using OperationIterator = BasicBlock::OperationIterator;
 
-    // ModulePass interface
-    void Apply(ModulePtr&& module) override;
-
-    // TransformPass interface
-    ModulePtr GetTransformed() override;
-
 protected:
+    // FunctionPass interface
+    void RunOnFunction(Function* function) override;
+
     virtual void OnFunction(Function* function);
     virtual OperationIterator OperationTransformation(BasicBlock* block,
                                                       OperationIterator iterator);
-    DefaultTypesRegistry* Types();
-
-private:
-    ModulePtr current_module_;
 };
 
 }  // namespace bier
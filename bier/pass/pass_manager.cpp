@@ -0,0 +1,178 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "pass_manager.h"
+#include <bier/core/exceptions.h>
+#include <bier/pass/dce_pass.h>
+#include <bier/pass/gvn_pass.h>
+#include <bier/pass/inliner_pass.h>
+#include <bier/pass/load_store_elimination_pass.h>
+#include <bier/pass/sccp_pass.h>
+#include <bier/pass/simplify_cfg_pass.h>
+#include <bier/pass/ssa_construction_pass.h>
+#include <bier/pass/ssa_pass.h>
+#include <algorithm>
+#include <iomanip>
+
+namespace bier {
+
+namespace {
+
+PassRegistry MakeDefaultRegistry() {
+    PassRegistry registry;
+    registry.Register("dce", [] { return std::make_unique<DeadCodeEliminationPass>(); });
+    registry.Register("adce", [] {
+        return std::make_unique<DeadCodeEliminationPass>(DeadCodeEliminationPass::Mode::AGGRESSIVE);
+    });
+    registry.Register("gvn", [] { return std::make_unique<GlobalValueNumberingPass>(); });
+    registry.Register("gvn-budget", [] {
+        return std::make_unique<GlobalValueNumberingPass>(GlobalValueNumberingPass::kDefaultBudget);
+    });
+    registry.Register("inline", [] { return std::make_unique<InlinerPass>(); });
+    registry.Register("lse", [] { return std::make_unique<LoadStoreEliminationPass>(); });
+    registry.Register("sccp", [] {
+        return std::make_unique<SparseConditionalConstantPropagationPass>();
+    });
+    registry.Register("simplifycfg", [] { return std::make_unique<SimplifyCFGPass>(); });
+    registry.Register("ssa", [] { return std::make_unique<SSAConstructionPass>(); });
+    registry.Register("ssa-memory", [] { return std::make_unique<SSAPass>(); });
+    return registry;
+}
+
+std::string_view Trim(std::string_view text) {
+    const auto first = text.find_first_not_of(" \t\n");
+    if (first == std::string_view::npos) {
+        return {};
+    }
+    const auto last = text.find_last_not_of(" \t\n");
+    return text.substr(first, last - first + 1);
+}
+
+}  // namespace
+
+const PassRegistry& PassRegistry::Default() {
+    static const PassRegistry registry = MakeDefaultRegistry();
+    return registry;
+}
+
+void PassRegistry::Register(const std::string& name, Factory factory) {
+    check(!Has(name), IRException("Pass " + name + " is already registered"));
+    factories_.emplace(name, std::move(factory));
+}
+
+std::unique_ptr<TransformPass> PassRegistry::Create(const std::string& name) const {
+    auto it = factories_.find(name);
+    check(it != factories_.end(), IRException("Unknown pass " + name));
+    return it->second();
+}
+
+PassManager::PassManager(std::string_view pipeline, const PassRegistry& registry) {
+    while (!pipeline.empty()) {
+        const auto comma = pipeline.find(',');
+        const std::string name(Trim(pipeline.substr(0, comma)));
+        check(!name.empty(), IRException("Empty pass name in pipeline"));
+        AddPass(name, registry.Create(name));
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        pipeline.remove_prefix(comma + 1);
+        check(!pipeline.empty(), IRException("Empty pass name in pipeline"));
+    }
+}
+
+void PassManager::AddPass(std::string name, std::unique_ptr<TransformPass> pass) {
+    pass->SetAnalysisManager(&analysis_manager_);
+    pass->SetThreadPool(thread_pool_);
+    passes_.push_back({std::move(name), std::move(pass)});
+}
+
+void PassManager::SetThreadPool(ThreadPool* thread_pool) {
+    thread_pool_ = thread_pool;
+    for (auto& [name, pass] : passes_) {
+        pass->SetThreadPool(thread_pool_);
+    }
+}
+
+ModulePtr PassManager::Run(ModulePtr&& module) {
+    for (auto& [name, pass] : passes_) {
+        PassStatistics statistics;
+        statistics.name = name;
+        statistics.operations_before = module->CountOperations();
+        const std::size_t bytes_before = CountAllocatedBytes(module.get());
+
+        analysis_manager_.OnPassStarted(module.get());
+        const auto start = std::chrono::steady_clock::now();
+        pass->Apply(std::move(module));
+        module = pass->GetTransformed();
+        statistics.time = std::chrono::steady_clock::now() - start;
+
+        analysis_manager_.OnPassFinished(module.get(), pass->GetPreservedAnalyses());
+        statistics.operations_after = module->CountOperations();
+        statistics.allocated_bytes = static_cast<std::int64_t>(CountAllocatedBytes(module.get())) -
+                                     static_cast<std::int64_t>(bytes_before);
+        statistics.counters = pass->GetCounters();
+        statistics_.push_back(std::move(statistics));
+    }
+    return std::move(module);
+}
+
+void PassManager::PrintReport(std::ostream& stream) const {
+    std::vector<const PassStatistics*> sorted;
+    std::chrono::nanoseconds total{0};
+    for (const auto& statistics : statistics_) {
+        sorted.push_back(&statistics);
+        total += statistics.time;
+    }
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const auto* lhs, const auto* rhs) { return lhs->time > rhs->time; });
+
+    const auto flags = stream.flags();
+    stream << std::left << std::setw(20) << "pass" << std::right << std::setw(12) << "time, ms"
+           << std::setw(8) << "%" << std::setw(12) << "ops" << std::setw(12) << "ops delta"
+           << std::setw(14) << "bytes" << '\n';
+    for (const PassStatistics* statistics : sorted) {
+        const double ms = std::chrono::duration<double, std::milli>(statistics->time).count();
+        const double percent =
+            total.count() == 0 ? 0.0 : 100.0 * statistics->time.count() / total.count();
+        stream << std::left << std::setw(20) << statistics->name << std::right << std::fixed
+               << std::setprecision(3) << std::setw(12) << ms << std::setprecision(1)
+               << std::setw(8) << percent << std::setw(12) << statistics->operations_after
+               << std::setw(12) << std::showpos << statistics->OperationsDelta()
+               << std::setw(14) << statistics->allocated_bytes << std::noshowpos << '\n';
+    }
+    stream << std::left << std::setw(20) << "total" << std::right << std::fixed
+           << std::setprecision(3) << std::setw(12)
+           << std::chrono::duration<double, std::milli>(total).count() << '\n';
+    for (const auto& statistics : statistics_) {
+        std::vector<std::pair<std::string, std::size_t>> counters(statistics.counters.begin(),
+                                                                  statistics.counters.end());
+        std::sort(counters.begin(), counters.end());
+        for (const auto& [counter, amount] : counters) {
+            stream << std::left << std::setw(20) << statistics.name << counter << ": " << amount
+                   << '\n';
+        }
+    }
+    stream.flags(flags);
+}
+
+std::size_t CountAllocatedBytes(const Module* module) {
+    std::size_t bytes = module->GetArena().AllocatedBytes();
+    for (const auto& [signature, function] : module->GetDefinedFunctions()) {
+        bytes += function->GetArena().AllocatedBytes();
+    }
+    return bytes;
+}
+
+}  // namespace bier
@@ -0,0 +1,101 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+#include <bier/pass/transform_pass.h>
+#include <chrono>
+#include <functional>
+#include <ostream>
+#include <string_view>
+
+namespace bier {
+
+// Maps pipeline names to pass factories
+class PassRegistry {
+public:
+    using Factory = std::function<std::unique_ptr<TransformPass>()>;
+
+    // Registry of all passes shipped with the library
+    static const PassRegistry& Default();
+
+    void Register(const std::string& name, Factory factory);
+    bool Has(const std::string& name) const {
+        return ContainerHas(factories_, name);
+    }
+    std::unique_ptr<TransformPass> Create(const std::string& name) const;
+
+private:
+    StdHashMap<std::string, Factory> factories_;
+};
+
+struct PassStatistics {
+    std::string name;
+    std::chrono::nanoseconds time{0};
+    std::size_t operations_before = 0;
+    std::size_t operations_after = 0;
+    // Growth of the module and function arenas, negative if functions were erased
+    std::int64_t allocated_bytes = 0;
+    // Counters reported by the pass
+    StdHashMap<std::string, std::size_t> counters;
+
+    std::int64_t OperationsDelta() const {
+        return static_cast<std::int64_t>(operations_after) -
+               static_cast<std::int64_t>(operations_before);
+    }
+};
+
+// Runs a sequence of passes over a module, sharing one analysis manager between them.
+// Pipelines are comma-separated pass names, e.g. "ssa,dce,gvn,simplifycfg".
+class PassManager {
+public:
+    PassManager() = default;
+    explicit PassManager(std::string_view pipeline,
+                         const PassRegistry& registry = PassRegistry::Default());
+
+    void AddPass(std::string name, std::unique_ptr<TransformPass> pass);
+    // Function passes of the pipeline spread functions over the pool, nullptr runs them serially
+    void SetThreadPool(ThreadPool* thread_pool);
+    std::size_t GetPassCount() const {
+        return passes_.size();
+    }
+
+    ModulePtr Run(ModulePtr&& module);
+
+    AnalysisManager& GetAnalysisManager() {
+        return analysis_manager_;
+    }
+    // One entry per executed pass, in execution order
+    const std::vector<PassStatistics>& GetStatistics() const {
+        return statistics_;
+    }
+    // Passes sorted by time spent in them, slowest first, then the counters of every pass
+    void PrintReport(std::ostream& stream) const;
+
+private:
+    struct NamedPass {
+        std::string name;
+        std::unique_ptr<TransformPass> pass;
+    };
+
+    std::vector<NamedPass> passes_;
+    AnalysisManager analysis_manager_;
+    ThreadPool* thread_pool_ = nullptr;
+    std::vector<PassStatistics> statistics_;
+};
+
+// Bytes allocated in the arenas of the module and its functions
+std::size_t CountAllocatedBytes(const Module* module);
+
+}  // namespace bier
@@ -0,0 +1,283 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "sccp_pass.h"
+#include <bier/operations/branch.h>
+#include <bier/operations/phi.h>
+#include <bier/utils/casting.h>
+#include <algorithm>
+
+namespace bier {
+
+void SparseConditionalConstantPropagationPass::RunOnFunction(Function* function) {
+    function_ = function;
+    ConstantFolder folder(function->Constants());
+    folder_ = &folder;
+    values_.assign(function->ValueIndexBound(), LatticeValue());
+    executable_blocks_.Clear();
+    executable_from_.assign(function->BlockIndexBound(), {});
+
+    MarkEdgeExecutable(nullptr, function->GetEntryBlock());
+    Solve();
+    while (ResolveUnknownBranches()) {
+        Solve();
+    }
+    Rewrite();
+    folder_ = nullptr;
+}
+
+SparseConditionalConstantPropagationPass::LatticeValue
+SparseConditionalConstantPropagationPass::Meet(const LatticeValue& a, const LatticeValue& b) {
+    if (a.state == LatticeValue::State::UNKNOWN) {
+        return b;
+    }
+    if (b.state == LatticeValue::State::UNKNOWN || a == b) {
+        return a;
+    }
+    return Overdefined();
+}
+
+void SparseConditionalConstantPropagationPass::Solve() {
+    while (!block_worklist_.empty() || !value_worklist_.empty()) {
+        if (!value_worklist_.empty()) {
+            const Value* value = value_worklist_.back();
+            value_worklist_.pop_back();
+            for (const Use* use : value->Uses()) {
+                const Operation* user = use->GetUser();
+                if (executable_blocks_.Has(user->GetBlock())) {
+                    Visit(user);
+                }
+            }
+            continue;
+        }
+        const BasicBlock* block = block_worklist_.back();
+        block_worklist_.pop_back();
+        for (const Operation* op : block->GetOperations()) {
+            Visit(op);
+        }
+    }
+}
+
+bool SparseConditionalConstantPropagationPass::ResolveUnknownBranches() {
+    bool resolved = false;
+    for (const BasicBlock* block : function_->GetBlocks()) {
+        const Operation* terminator = block->GetTerminator();
+        if (!executable_blocks_.Has(block) || terminator == nullptr ||
+            terminator->OpCode() != OpCodes::COND_BRANCH_OP) {
+            continue;
+        }
+        const Value* condition = terminator->GetArguments()[0];
+        if (Lookup(condition).state != LatticeValue::State::UNKNOWN) {
+            continue;
+        }
+        // Only variables have unknown values, the branch is revisited as their user
+        values_[condition->GetIndex()] = Overdefined();
+        value_worklist_.push_back(condition);
+        resolved = true;
+    }
+    return resolved;
+}
+
+SparseConditionalConstantPropagationPass::LatticeValue
+SparseConditionalConstantPropagationPass::Lookup(const Value* value) const {
+    if (const auto* constant = dyn_cast<IntegerConst>(value)) {
+        return {LatticeValue::State::CONSTANT, constant};
+    }
+    // Arguments and variables assigned more than once are never constant
+    if (isa<Variable>(value) && value->GetDefiningOp() != nullptr) {
+        return values_[value->GetIndex()];
+    }
+    return Overdefined();
+}
+
+bool SparseConditionalConstantPropagationPass::IsExecutable(const BasicBlock* from,
+                                                            const BasicBlock* to) const {
+    const auto& predecessors = executable_from_[to->GetIndex()];
+    return std::find(predecessors.begin(), predecessors.end(), from) != predecessors.end();
+}
+
+void SparseConditionalConstantPropagationPass::MarkEdgeExecutable(const BasicBlock* from,
+                                                                  const BasicBlock* to) {
+    if (from != nullptr) {
+        if (IsExecutable(from, to)) {
+            return;
+        }
+        executable_from_[to->GetIndex()].push_back(from);
+    }
+    if (!executable_blocks_.Has(to)) {
+        executable_blocks_.Insert(to);
+        block_worklist_.push_back(to);
+        return;
+    }
+    // Only phis see a new way into a block that was already evaluated
+    for (const Operation* op : to->GetOperations()) {
+        if (op->OpCode() == OpCodes::PHI_OP) {
+            Visit(op);
+        }
+    }
+}
+
+void SparseConditionalConstantPropagationPass::Visit(const Operation* op) {
+    const BasicBlock* block = op->GetBlock();
+    if (op->OpCode() == OpCodes::BRANCH_OP) {
+        MarkEdgeExecutable(block, op->GetSuccessors()[0]);
+        return;
+    }
+    if (op->OpCode() == OpCodes::COND_BRANCH_OP) {
+        const LatticeValue condition = Lookup(op->GetArguments()[0]);
+        if (condition.state == LatticeValue::State::CONSTANT) {
+            const std::size_t taken = condition.constant->GetValue() != 0 ? 0 : 1;
+            MarkEdgeExecutable(block, op->GetSuccessors()[taken]);
+        } else if (condition.state == LatticeValue::State::OVERDEFINED) {
+            MarkEdgeExecutable(block, op->GetSuccessors()[0]);
+            MarkEdgeExecutable(block, op->GetSuccessors()[1]);
+        }
+        return;
+    }
+
+    auto result = op->GetReturnValue();
+    if (!result.has_value() || result.value()->GetDefiningOp() != op) {
+        return;
+    }
+    LatticeValue evaluated = Evaluate(op);
+    if (evaluated.state == LatticeValue::State::CONSTANT &&
+        evaluated.constant->GetType() != result.value()->GetType()) {
+        evaluated = Overdefined();
+    }
+    LatticeValue& current = values_[result.value()->GetIndex()];
+    const LatticeValue updated = Meet(current, evaluated);
+    if (updated != current) {
+        current = updated;
+        value_worklist_.push_back(result.value());
+    }
+}
+
+SparseConditionalConstantPropagationPass::LatticeValue
+SparseConditionalConstantPropagationPass::Evaluate(const Operation* op) const {
+    auto arguments = op->GetArguments();
+    const int opcode = op->OpCode();
+    if (opcode < OpCodes::STORE_OP || opcode == OpCodes::CAST_OP) {
+        for (const Value* argument : arguments) {
+            const LatticeValue value = Lookup(argument);
+            if (value.state != LatticeValue::State::CONSTANT) {
+                return value;
+            }
+        }
+        const Type* type = op->GetReturnValue().value()->GetType();
+        const IntegerConst* folded =
+            opcode == OpCodes::CAST_OP
+                ? folder_->FoldCast(Lookup(arguments[0]).constant, type)
+                : folder_->FoldBinary(opcode, Lookup(arguments[0]).constant,
+                                      Lookup(arguments[1]).constant, type);
+        if (folded == nullptr) {
+            return Overdefined();
+        }
+        return {LatticeValue::State::CONSTANT, folded};
+    }
+
+    switch (opcode) {
+        case OpCodes::CONST_OP:
+        case OpCodes::ASSIGN_OP:
+            return Lookup(arguments[0]);
+        case OpCodes::PHI_OP: {
+            const auto* phi = static_cast<const PhiOp*>(op);
+            LatticeValue value;
+            for (std::size_t i = 0; i < phi->IncomingCount(); ++i) {
+                if (IsExecutable(phi->IncomingBlock(i), phi->GetBlock())) {
+                    value = Meet(value, Lookup(phi->IncomingValue(i)));
+                }
+            }
+            return value;
+        }
+        default:
+            return Overdefined();
+    }
+}
+
+void SparseConditionalConstantPropagationPass::Rewrite() {
+    std::size_t replaced = 0;
+    for (BasicBlock* block : function_->GetBlocks()) {
+        if (!executable_blocks_.Has(block)) {
+            continue;
+        }
+        auto ops = block->GetOperations();
+        for (auto it = ops.begin(); it != ops.end();) {
+            auto result = (*it)->GetReturnValue();
+            if (!result.has_value() || result.value()->GetDefiningOp() != *it) {
+                ++it;
+                continue;
+            }
+            const LatticeValue& value = values_[result.value()->GetIndex()];
+            if (value.state != LatticeValue::State::CONSTANT) {
+                ++it;
+                continue;
+            }
+            // Only operations without side effects evaluate to constants
+            result.value()->ReplaceAllUsesWith(value.constant);
+            it = block->DeleteAt(it);
+            ++replaced;
+        }
+        const Operation* terminator = block->GetTerminator();
+        if (terminator == nullptr || terminator->OpCode() != OpCodes::COND_BRANCH_OP) {
+            continue;
+        }
+        const auto* condition = dyn_cast<IntegerConst>(terminator->GetArguments()[0]);
+        if (condition != nullptr &&
+            terminator->GetSuccessors()[0] != terminator->GetSuccessors()[1]) {
+            FoldBranch(block, condition->GetValue() != 0 ? 0 : 1);
+            Count("folded branches");
+        }
+    }
+    Count("replaced values", replaced);
+    EraseDeadBlocks();
+}
+
+void SparseConditionalConstantPropagationPass::FoldBranch(BasicBlock* block, std::size_t taken) {
+    auto ops = block->GetOperations();
+    auto terminator = std::prev(ops.end());
+    BasicBlock* target = (*terminator)->GetSuccessors()[taken];
+    BasicBlock* dropped = (*terminator)->GetSuccessors()[1 - taken];
+    auto end = block->DeleteAt(terminator);
+    block->InsertAt(end, function_->MakeOperation<BranchOperation>(function_, target));
+    PhiOp::RemoveIncomingEdge(dropped, block);
+}
+
+void SparseConditionalConstantPropagationPass::EraseDeadBlocks() {
+    std::vector<BasicBlock*> dead;
+    for (BasicBlock* block : function_->GetBlocks()) {
+        if (!executable_blocks_.Has(block)) {
+            dead.push_back(block);
+        }
+    }
+    for (BasicBlock* block : dead) {
+        for (BasicBlock* successor : block->Successors()) {
+            if (executable_blocks_.Has(successor)) {
+                PhiOp::RemoveIncomingEdge(successor, block);
+            }
+        }
+    }
+    for (BasicBlock* block : dead) {
+        auto ops = block->GetOperations();
+        for (auto it = ops.begin(); it != ops.end();) {
+            it = block->DeleteAt(it);
+        }
+    }
+    for (BasicBlock* block : dead) {
+        function_->EraseBlock(block);
+    }
+    Count("erased blocks", dead.size());
+}
+
+}  // namespace bier
@@ -0,0 +1,87 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+
+#include <bier/analysis/constant_folding.h>
+#include <bier/pass/function_pass.h>
+
+namespace bier {
+
+// Sparse conditional constant propagation of Wegman and Zadeck. Values start unknown and are
+// lowered to a constant or to overdefined, only blocks reachable through edges found executable
+// are evaluated, so values coming along branches that are never taken do not spoil phis.
+// Constant results replace their variables, conditional branches on constants become jumps and
+// the blocks that are never executed are erased.
+class SparseConditionalConstantPropagationPass : public FunctionPass {
+public:
+    // ModulePass interface
+    PreservedAnalyses GetPreservedAnalyses() const override {
+        return PreservedAnalyses::None();
+    }
+
+protected:
+    // FunctionPass interface
+    void RunOnFunction(Function* function) override;
+    std::unique_ptr<FunctionPass> CloneForThread() const override {
+        return std::make_unique<SparseConditionalConstantPropagationPass>();
+    }
+
+private:
+    struct LatticeValue {
+        enum class State { UNKNOWN, CONSTANT, OVERDEFINED };
+
+        State state = State::UNKNOWN;
+        const IntegerConst* constant = nullptr;
+
+        bool operator==(const LatticeValue& other) const {
+            return state == other.state && constant == other.constant;
+        }
+        bool operator!=(const LatticeValue& other) const {
+            return !(*this == other);
+        }
+    };
+
+    Function* function_ = nullptr;
+    const ConstantFolder* folder_ = nullptr;
+    std::vector<LatticeValue> values_;
+    DenseBlockSet executable_blocks_;
+    // Predecessors along executable edges
+    std::vector<std::vector<const BasicBlock*>> executable_from_;
+    std::vector<const BasicBlock*> block_worklist_;
+    std::vector<const Value*> value_worklist_;
+
+    static LatticeValue Overdefined() {
+        return {LatticeValue::State::OVERDEFINED, nullptr};
+    }
+    static LatticeValue Meet(const LatticeValue& a, const LatticeValue& b);
+
+    void Solve();
+    // A condition may stay unknown at the fixpoint if its only definition is never executed,
+    // such conditions become overdefined so that the branch keeps both of its successors.
+    // Returns whether there was any
+    bool ResolveUnknownBranches();
+    LatticeValue Lookup(const Value* value) const;
+    bool IsExecutable(const BasicBlock* from, const BasicBlock* to) const;
+    void MarkEdgeExecutable(const BasicBlock* from, const BasicBlock* to);
+    void Visit(const Operation* op);
+    LatticeValue Evaluate(const Operation* op) const;
+
+    void Rewrite();
+    void FoldBranch(BasicBlock* block, std::size_t taken);
+    void EraseDeadBlocks();
+};
+
+}  // namespace bier
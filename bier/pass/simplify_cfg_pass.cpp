@@ -0,0 +1,262 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "simplify_cfg_pass.h"
+#include <bier/operations/branch.h>
+#include <bier/operations/phi.h>
+#include <bier/utils/casting.h>
+#include <algorithm>
+#include <unordered_set>
+
+namespace bier {
+
+namespace {
+
+void EraseWithOperations(Function* function, BasicBlock* block) {
+    auto ops = block->GetOperations();
+    for (auto it = ops.begin(); it != ops.end();) {
+        it = block->DeleteAt(it);
+    }
+    function->EraseBlock(block);
+}
+
+}  // namespace
+
+void SimplifyCFGPass::RunOnFunction(Function* function) {
+    if (function->GetBlocks().Size() == 0) {
+        return;
+    }
+    function_ = function;
+    bool changed = true;
+    while (changed) {
+        changed = FoldBranches();
+        changed |= EraseUnreachableBlocks();
+        changed |= ForwardEmptyBlocks();
+        changed |= MergeBlocks();
+    }
+    function_ = nullptr;
+}
+
+bool SimplifyCFGPass::FoldBranches() {
+    bool changed = false;
+    for (BasicBlock* block : function_->GetBlocks()) {
+        Operation* terminator = block->GetTerminator();
+        if (terminator == nullptr || terminator->OpCode() != OpCodes::COND_BRANCH_OP) {
+            continue;
+        }
+        BasicBlock* on_true = terminator->GetSuccessors()[0];
+        BasicBlock* on_false = terminator->GetSuccessors()[1];
+        const auto* condition = dyn_cast<IntegerConst>(terminator->GetArguments()[0]);
+        if (on_true != on_false && condition == nullptr) {
+            continue;
+        }
+        const bool take_true = on_true == on_false || condition->GetValue() != 0;
+        BasicBlock* target = take_true ? on_true : on_false;
+        BasicBlock* dropped = take_true ? on_false : on_true;
+        auto end = block->DeleteAt(block->GetIterator(terminator));
+        block->InsertAt(end, function_->MakeOperation<BranchOperation>(function_, target));
+        PhiOp::RemoveIncomingEdge(dropped, block);
+        Count("folded branches");
+        changed = true;
+    }
+    return changed;
+}
+
+bool SimplifyCFGPass::EraseUnreachableBlocks() {
+    DenseBlockSet reachable;
+    std::vector<const BasicBlock*> stack{function_->GetEntryBlock()};
+    reachable.Insert(stack.back());
+    while (!stack.empty()) {
+        const BasicBlock* block = stack.back();
+        stack.pop_back();
+        for (const BasicBlock* successor : block->Successors()) {
+            if (!reachable.Has(successor)) {
+                reachable.Insert(successor);
+                stack.push_back(successor);
+            }
+        }
+    }
+
+    std::vector<BasicBlock*> dead;
+    for (BasicBlock* block : function_->GetBlocks()) {
+        if (!reachable.Has(block)) {
+            dead.push_back(block);
+        }
+    }
+    for (BasicBlock* block : dead) {
+        for (BasicBlock* successor : block->Successors()) {
+            if (reachable.Has(successor)) {
+                PhiOp::RemoveIncomingEdge(successor, block);
+            }
+        }
+    }
+    // Dead blocks may still branch to each other, so edges go before any block is erased
+    for (BasicBlock* block : dead) {
+        auto ops = block->GetOperations();
+        for (auto it = ops.begin(); it != ops.end();) {
+            it = block->DeleteAt(it);
+        }
+    }
+    for (BasicBlock* block : dead) {
+        function_->EraseBlock(block);
+    }
+    Count("erased blocks", dead.size());
+    return !dead.empty();
+}
+
+bool SimplifyCFGPass::ForwardEmptyBlocks() {
+    std::vector<BasicBlock*> candidates;
+    for (BasicBlock* block : function_->GetBlocks()) {
+        if (CanForward(block)) {
+            candidates.push_back(block);
+        }
+    }
+    bool changed = false;
+    for (BasicBlock* block : candidates) {
+        // Forwarding an earlier candidate may have added predecessors of the target
+        if (CanForward(block)) {
+            Forward(block);
+            Count("forwarded blocks");
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+bool SimplifyCFGPass::CanForward(const BasicBlock* block) const {
+    if (block == function_->GetEntryBlock() || block->Predecessors().empty()) {
+        return false;
+    }
+    auto ops = block->GetOperations();
+    if (ops.Size() != 1 || (*ops.begin())->OpCode() != OpCodes::BRANCH_OP) {
+        return false;
+    }
+    BasicBlock* target = block->Successors().front();
+    if (target == block) {
+        return false;
+    }
+    if (PhiOp::GetPhis(target).empty()) {
+        return true;
+    }
+    // A predecessor already branching to the target may bring a different phi value
+    const auto& target_predecessors = target->Predecessors();
+    return std::none_of(block->Predecessors().begin(), block->Predecessors().end(),
+                        [&target_predecessors](const BasicBlock* predecessor) {
+                            return std::find(target_predecessors.begin(),
+                                             target_predecessors.end(),
+                                             predecessor) != target_predecessors.end();
+                        });
+}
+
+void SimplifyCFGPass::Forward(BasicBlock* block) {
+    BasicBlock* target = block->Successors().front();
+    const std::vector<BasicBlock*> predecessors = block->Predecessors();
+
+    // Entries of the bypassed block are repeated for each of its incoming edges
+    for (PhiOp* phi : PhiOp::GetPhis(target)) {
+        std::vector<BasicBlock*> blocks;
+        std::vector<const Value*> values;
+        for (std::size_t i = 0; i < phi->IncomingCount(); ++i) {
+            if (phi->IncomingBlock(i) != block) {
+                blocks.push_back(phi->IncomingBlock(i));
+                values.push_back(phi->IncomingValue(i));
+                continue;
+            }
+            for (BasicBlock* predecessor : predecessors) {
+                blocks.push_back(predecessor);
+                values.push_back(phi->IncomingValue(i));
+            }
+        }
+        auto it = target->GetIterator(phi);
+        target->InsertAt(it, function_->MakeOperation<PhiOp>(
+                                 function_, phi->GetReturnValue().value(), blocks, values));
+        target->DeleteAt(it);
+    }
+
+    for (BasicBlock* predecessor : predecessors) {
+        Operation* terminator = predecessor->GetTerminator();
+        for (std::size_t i = 0; i < terminator->GetSuccessors().size(); ++i) {
+            if (terminator->GetSuccessors()[i] == block) {
+                terminator->SetSuccessor(i, target);
+            }
+        }
+    }
+    EraseWithOperations(function_, block);
+}
+
+bool SimplifyCFGPass::MergeBlocks() {
+    std::vector<BasicBlock*> blocks;
+    for (BasicBlock* block : function_->GetBlocks()) {
+        blocks.push_back(block);
+    }
+    // Only compared against, the erased blocks are never dereferenced
+    std::unordered_set<const BasicBlock*> merged;
+    for (BasicBlock* block : blocks) {
+        if (merged.count(block) != 0) {
+            continue;
+        }
+        while (BasicBlock* successor = GetMergeableSuccessor(block)) {
+            Merge(block, successor);
+            merged.insert(successor);
+            Count("merged blocks");
+        }
+    }
+    return !merged.empty();
+}
+
+BasicBlock* SimplifyCFGPass::GetMergeableSuccessor(BasicBlock* block) const {
+    Operation* terminator = block->GetTerminator();
+    if (terminator == nullptr || terminator->OpCode() != OpCodes::BRANCH_OP) {
+        return nullptr;
+    }
+    BasicBlock* successor = terminator->GetSuccessors()[0];
+    if (successor == block || successor == function_->GetEntryBlock() ||
+        successor->Predecessors().size() != 1) {
+        return nullptr;
+    }
+    return successor;
+}
+
+void SimplifyCFGPass::Merge(BasicBlock* block, BasicBlock* successor) {
+    // With a single predecessor phis just pass their only incoming value through
+    auto ops = successor->GetOperations();
+    for (auto it = ops.begin(); it != ops.end();) {
+        if ((*it)->OpCode() != OpCodes::PHI_OP) {
+            ++it;
+            continue;
+        }
+        auto* phi = static_cast<PhiOp*>(*it);
+        const Variable* result = phi->GetReturnValue().value();
+        const Value* incoming = phi->IncomingValue(0);
+        if (result->GetDefiningOp() == phi) {
+            result->ReplaceAllUsesWith(incoming);
+        } else {
+            successor->InsertAt(it, function_->MakeOperation<UnaryOperation>(
+                                        function_, UnaryOperation::UnOp::ASSIGN, incoming,
+                                        result));
+        }
+        it = successor->DeleteAt(it);
+    }
+
+    block->DeleteAt(block->GetIterator(block->GetTerminator()));
+    auto moved = successor->GetOperations();
+    block->Splice(block->GetOperations().end(), successor, moved.begin(), moved.end());
+    for (BasicBlock* next : block->Successors()) {
+        PhiOp::ReplaceIncomingBlock(next, successor, block);
+    }
+    function_->EraseBlock(successor);
+}
+
+}  // namespace bier
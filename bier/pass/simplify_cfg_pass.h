@@ -0,0 +1,53 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+
+#include <bier/pass/function_pass.h>
+
+namespace bier {
+
+// Cleans up the control flow graph until nothing changes: conditional branches on constants
+// or to a single target become jumps, blocks unreachable from the entry are erased, blocks
+// holding only a jump are bypassed and a block is merged into its predecessor when they
+// are the only successor and predecessor of each other.
+class SimplifyCFGPass : public FunctionPass {
+public:
+    // ModulePass interface
+    PreservedAnalyses GetPreservedAnalyses() const override {
+        return PreservedAnalyses::None();
+    }
+
+protected:
+    // FunctionPass interface
+    void RunOnFunction(Function* function) override;
+    std::unique_ptr<FunctionPass> CloneForThread() const override {
+        return std::make_unique<SimplifyCFGPass>();
+    }
+
+private:
+    Function* function_ = nullptr;
+
+    bool FoldBranches();
+    bool EraseUnreachableBlocks();
+    bool ForwardEmptyBlocks();
+    bool CanForward(const BasicBlock* block) const;
+    void Forward(BasicBlock* block);
+    bool MergeBlocks();
+    BasicBlock* GetMergeableSuccessor(BasicBlock* block) const;
+    void Merge(BasicBlock* block, BasicBlock* successor);
+};
+
+}  // namespace bier
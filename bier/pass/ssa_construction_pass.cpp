@@ -0,0 +1,209 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "ssa_construction_pass.h"
+#include <bier/core/exceptions.h>
+
+namespace bier {
+
+void SSAConstructionPass::RunOnFunction(Function* function) {
+    function_ = function;
+    mutable_.Clear();
+    definitions_.clear();
+    incomplete_phis_.clear();
+    filled_.clear();
+    sealed_.clear();
+    replaced_.Clear();
+    removed_phis_.Clear();
+
+    bool has_mutable = false;
+    for (const auto& [name, variable] : function->GetVariables()) {
+        if (variable->IsMutable()) {
+            mutable_.Insert(variable.get());
+            has_mutable = true;
+        }
+    }
+    if (!has_mutable) {
+        return;
+    }
+
+    for (BasicBlock* block : function->GetBlocks()) {
+        if (!ContainerHas(sealed_, block) && CanSeal(block)) {
+            SealBlock(block);
+        }
+        FillBlock(block);
+        for (BasicBlock* successor : block->Successors()) {
+            if (!ContainerHas(sealed_, successor) && CanSeal(successor)) {
+                SealBlock(successor);
+            }
+        }
+    }
+    // Blocks behind unreachable predecessors
+    for (BasicBlock* block : function->GetBlocks()) {
+        if (!ContainerHas(sealed_, block)) {
+            SealBlock(block);
+        }
+    }
+    removed_ops_.clear();
+}
+
+void SSAConstructionPass::FillBlock(BasicBlock* block) {
+    // Phis are only inserted in front of the block, so they are never visited here
+    for (Operation* op : block->GetOperations()) {
+        auto arguments = op->GetArguments();
+        for (std::size_t i = 0; i < arguments.size(); ++i) {
+            const Value* argument = arguments[i];
+            if (mutable_.Has(argument)) {
+                check(op->OpCode() != OpCodes::PHI_OP,
+                      IRException("phi of mutable variable " + argument->GetName(), function_,
+                                  block));
+                op->SetOperand(i, ReadVariable(argument, block));
+            }
+        }
+        auto result = op->GetReturnValue();
+        if (result.has_value() && mutable_.Has(result.value())) {
+            const Variable* variable = result.value();
+            const Variable* value = function_->AllocateVariable(
+                Variable::Metadata(variable->GetName(), variable->GetType()));
+            op->SubstituteReturnValue(value);
+            WriteVariable(variable, block, value);
+        }
+    }
+    filled_.insert(block);
+}
+
+void SSAConstructionPass::SealBlock(BasicBlock* block) {
+    std::vector<IncompletePhi> phis = std::move(incomplete_phis_[block]);
+    incomplete_phis_.erase(block);
+    for (const auto& [variable, phi] : phis) {
+        AddPhiOperands(variable, phi);
+    }
+    sealed_.insert(block);
+}
+
+bool SSAConstructionPass::CanSeal(const BasicBlock* block) const {
+    for (const BasicBlock* predecessor : block->Predecessors()) {
+        if (!ContainerHas(filled_, predecessor)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SSAConstructionPass::WriteVariable(const Value* variable, const BasicBlock* block,
+                                        const Value* value) {
+    definitions_[block][variable] = value;
+}
+
+const Value* SSAConstructionPass::ReadVariable(const Value* variable, BasicBlock* block) {
+    auto it = definitions_.find(block);
+    if (it != definitions_.end() && it->second.Has(variable)) {
+        return Resolve(it->second.At(variable));
+    }
+    return ReadVariableRecursive(variable, block);
+}
+
+const Value* SSAConstructionPass::ReadVariableRecursive(const Value* variable, BasicBlock* block) {
+    const Value* value = nullptr;
+    const auto& predecessors = block->Predecessors();
+    if (!ContainerHas(sealed_, block)) {
+        PhiOp* phi = MakePhi(variable, block);
+        incomplete_phis_[block].push_back({variable, phi});
+        value = phi->GetReturnValue().value();
+    } else if (predecessors.empty()) {
+        value = function_->Constants()->GetUndef(variable->GetType());
+    } else if (predecessors.size() == 1) {
+        value = ReadVariable(variable, predecessors.front());
+    } else {
+        // Breaks cycles through the loops
+        PhiOp* phi = MakePhi(variable, block);
+        WriteVariable(variable, block, phi->GetReturnValue().value());
+        value = AddPhiOperands(variable, phi);
+    }
+    WriteVariable(variable, block, value);
+    return value;
+}
+
+PhiOp* SSAConstructionPass::MakePhi(const Value* variable, BasicBlock* block) {
+    const Variable* result =
+        function_->AllocateVariable(Variable::Metadata(variable->GetName(), variable->GetType()));
+    auto phi = function_->MakeOperation<PhiOp>(function_, result, block->Predecessors());
+    PhiOp* raw = phi.get();
+    block->InsertAt(block->GetOperations().begin(), std::move(phi));
+    return raw;
+}
+
+const Value* SSAConstructionPass::AddPhiOperands(const Value* variable, PhiOp* phi) {
+    for (std::size_t i = 0; i < phi->IncomingCount(); ++i) {
+        phi->SetIncomingValue(i, ReadVariable(variable, phi->IncomingBlock(i)));
+    }
+    return TryRemoveTrivialPhi(phi);
+}
+
+const Value* SSAConstructionPass::TryRemoveTrivialPhi(PhiOp* phi) {
+    const Variable* result = phi->GetReturnValue().value();
+    const Value* same = nullptr;
+    for (const Value* operand : phi->GetArguments()) {
+        if (operand == nullptr) {
+            // Operands are still being added
+            return result;
+        }
+        if (operand == same || operand == result) {
+            continue;
+        }
+        if (same != nullptr) {
+            return result;
+        }
+        same = operand;
+    }
+    if (same == nullptr) {
+        same = function_->Constants()->GetUndef(result->GetType());
+    }
+
+    std::vector<PhiOp*> phi_users;
+    for (const Use* use : result->Uses()) {
+        Operation* user = use->GetUser();
+        if (user != phi && user->OpCode() == OpCodes::PHI_OP) {
+            phi_users.push_back(static_cast<PhiOp*>(user));
+        }
+    }
+    result->ReplaceAllUsesWith(same);
+    replaced_.Insert(result, same);
+
+    // Kept alive until the function is done, phi_users of other removals may point to it
+    BasicBlock* block = phi->GetBlock();
+    removed_ops_.push_back(block->Remove(block->GetIterator(phi)));
+    removed_phis_.Insert(phi);
+    for (std::size_t i = 0; i < phi->IncomingCount(); ++i) {
+        phi->SetIncomingValue(i, nullptr);
+    }
+    phi->SubstituteReturnValue(nullptr);
+
+    for (PhiOp* user : phi_users) {
+        if (!removed_phis_.Has(user)) {
+            TryRemoveTrivialPhi(user);
+        }
+    }
+    return same;
+}
+
+const Value* SSAConstructionPass::Resolve(const Value* value) const {
+    while (replaced_.Has(value)) {
+        value = replaced_.At(value);
+    }
+    return value;
+}
+
+}  // namespace bier
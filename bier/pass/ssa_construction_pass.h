@@ -0,0 +1,73 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+
+#include <bier/analysis/dominator_tree.h>
+#include <bier/operations/phi.h>
+#include <bier/pass/function_pass.h>
+
+namespace bier {
+
+// Turns mutable variables into SSA registers joined by phis, without any memory traffic.
+// Uses the on-the-fly construction of Braun et al.: a block is sealed once all of its
+// predecessors are processed, reads in unsealed blocks get incomplete phis filled on sealing,
+// and trivial phis are removed as soon as they are complete.
+class SSAConstructionPass : public FunctionPass {
+public:
+    // Only phis and operands change, the CFG stays intact
+    PreservedAnalyses GetPreservedAnalyses() const override {
+        return PreservedAnalyses::None().Preserve<DominatorTree>().Preserve<PostDominatorTree>();
+    }
+
+protected:
+    // FunctionPass interface
+    void RunOnFunction(Function* function) override;
+    std::unique_ptr<FunctionPass> CloneForThread() const override {
+        return std::make_unique<SSAConstructionPass>();
+    }
+
+private:
+    struct IncompletePhi {
+        const Value* variable = nullptr;
+        PhiOp* phi = nullptr;
+    };
+
+    Function* function_ = nullptr;
+    DenseValueSet mutable_;
+    // Latest definition of every mutable variable in a block
+    StdHashMap<const BasicBlock*, DenseValueMap<const Value*>> definitions_;
+    StdHashMap<const BasicBlock*, std::vector<IncompletePhi>> incomplete_phis_;
+    StdHashSet<const BasicBlock*> filled_;
+    StdHashSet<const BasicBlock*> sealed_;
+    // Results of removed trivial phis, definitions_ may still refer to them
+    DenseValueMap<const Value*> replaced_;
+    DenseIndexSet<Operation> removed_phis_;
+    std::vector<OperationPtr> removed_ops_;
+
+    void FillBlock(BasicBlock* block);
+    void SealBlock(BasicBlock* block);
+    bool CanSeal(const BasicBlock* block) const;
+
+    void WriteVariable(const Value* variable, const BasicBlock* block, const Value* value);
+    const Value* ReadVariable(const Value* variable, BasicBlock* block);
+    const Value* ReadVariableRecursive(const Value* variable, BasicBlock* block);
+    PhiOp* MakePhi(const Value* variable, BasicBlock* block);
+    const Value* AddPhiOperands(const Value* variable, PhiOp* phi);
+    const Value* TryRemoveTrivialPhi(PhiOp* phi);
+    const Value* Resolve(const Value* value) const;
+};
+
+}  // namespace bier
@@ -29,51 +29,42 @@ void SSAPass::OnFunction(Function* function) {
         variable->MakeImmutable();
     }
 
-    mutable_values_.clear();
-    allocated_.clear();
+    mutable_values_.Clear();
+    allocated_.Clear();
     BasicBlock* start_block = function->CreateBlockAtStart();
+    const Value* one = function->Constants()->GetInteger(1, cast<IntTypeBase>(Types()->GetInt64()));
     for (const Value* val : values) {
-        const Value* one = start_block->InsertConst(std::make_unique<IntegerConst>(
-            1, static_cast<const IntTypeBase*>(Types()->GetInt64())));
         const Variable* variable = function->AllocateVariable(
             Variable::Metadata(val->GetName() + "_ptr", Types()->GetPtrTo(val->GetType())));
-        auto unOp = std::make_unique<UnaryOperation>(start_block->GetContextFunction(),
-                                                     UnaryOperation::UnOp::ALLOC, one, variable);
+        auto unOp = function->MakeOperation<UnaryOperation>(function, UnaryOperation::UnOp::ALLOC,
+                                                            one, variable);
         start_block->Append(std::move(unOp));
-        mutable_values_.insert({val, variable});
-        allocated_.insert(variable);
+        mutable_values_.Insert(val, variable);
+        allocated_.Insert(variable);
     }
-    start_block->Append(
-        std::make_unique<BranchOperation>(start_block->GetContextFunction(), start_block->Next()));
+    start_block->Append(function->MakeOperation<BranchOperation>(function, start_block->Next()));
 }
 
 OperationPass::OperationIterator SSAPass::OperationTransformation(BasicBlock* block,
                                                                   OperationIterator iterator) {
-    Operation* op = iterator->get();
+    Operation* op = *iterator;
     if (op->GetReturnValue().has_value() &&
-        ContainerHas(allocated_, op->GetReturnValue().value())) {
+        allocated_.Has(op->GetReturnValue().value())) {
         // Skip allocations
         return ++iterator;
     }
 
-    std::vector<const Value*> args;
     OperationIterator next_it = iterator;
-    int n_loads = 0;
-    for (const Value* val : op->GetArguments()) {
-        if (ContainerHas(mutable_values_, val)) {
-            args.push_back(MakeLoad(block, next_it, val));
-            // ++next_it;
-            ++n_loads;
-        } else {
-            args.push_back(val);
+    auto arguments = op->GetArguments();
+    for (std::size_t i = 0; i < arguments.size(); ++i) {
+        const Value* val = arguments[i];
+        if (mutable_values_.Has(val)) {
+            op->SetOperand(i, MakeLoad(block, next_it, val));
         }
     }
-    if (n_loads > 0) {
-        op->SubstituteArguments(args);
-    }
     ++next_it;
     if (op->GetReturnValue().has_value() &&
-        ContainerHas(mutable_values_, op->GetReturnValue().value())) {
+        mutable_values_.Has(op->GetReturnValue().value())) {
         op->SubstituteReturnValue(MakeStore(block, next_it, op->GetReturnValue().value()));
         // ++next_it;
     }
@@ -86,8 +77,8 @@ const Variable* SSAPass::MakeLoad(BasicBlock* block, OperationIterator iterator,
     const Variable* loaded = function_->AllocateVariable(
         Variable::Metadata(to_load->GetName() + "_val", to_load->GetType()));
     block->InsertAt(iterator,
-                    std::make_unique<UnaryOperation>(function_, UnaryOperation::UnOp::LOAD,
-                                                     mutable_values_.at(to_load), loaded));
+                    function_->MakeOperation<UnaryOperation>(function_, UnaryOperation::UnOp::LOAD,
+                                                             mutable_values_.At(to_load), loaded));
     return loaded;
 }
 
@@ -95,9 +86,9 @@ const Variable* SSAPass::MakeStore(BasicBlock* block, OperationPass::OperationIt
                                 const Value* to_store) const {
     const Variable* store_in = function_->AllocateVariable(
         Variable::Metadata(to_store->GetName() + "_val", to_store->GetType()));
-    block->InsertAt(iterator, std::make_unique<BinaryOperation>(
+    block->InsertAt(iterator, function_->MakeOperation<BinaryOperation>(
                                   function_, BinaryOperation::BinOp::STORE, store_in,
-                                  mutable_values_.at(to_store), nullptr));
+                                  mutable_values_.At(to_store), nullptr));
     return store_in;
 }
 
@@ -21,14 +21,19 @@ namespace bier {
 
 class SSAPass : public OperationPass {
 protected:
+    // FunctionPass interface
+    std::unique_ptr<FunctionPass> CloneForThread() const override {
+        return std::make_unique<SSAPass>();
+    }
+
     // OperationPass interface
     void OnFunction(Function* function) override;
     OperationIterator OperationTransformation(BasicBlock* block,
                                               OperationIterator iterator) override;
 
 private:
-    StdHashMap<const Value*, const Value*> mutable_values_;
-    StdHashSet<const Value*> allocated_;
+    DenseValueMap<const Value*> mutable_values_;
+    DenseValueSet allocated_;
     Function* function_ = nullptr;
 
     const Variable* MakeLoad(BasicBlock* block, OperationIterator iterator,
@@ -0,0 +1,161 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "thread_pool.h"
+#include <algorithm>
+#include <utility>
+
+namespace bier {
+
+ThreadPool::ThreadPool(std::size_t threads) {
+    threads = std::max<std::size_t>(threads, 1);
+    for (std::size_t i = 0; i < threads; ++i) {
+        slices_.push_back(std::make_unique<Slice>());
+    }
+    for (std::size_t i = 1; i < threads; ++i) {
+        workers_.emplace_back([this, i] { WorkerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    start_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+std::size_t ThreadPool::DefaultThreadCount() {
+    return std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+void ThreadPool::ParallelFor(std::size_t count, const Body& body) {
+    if (count == 0) {
+        return;
+    }
+    const std::size_t participants = Size();
+    for (std::size_t i = 0; i < participants; ++i) {
+        slices_[i]->begin = count * i / participants;
+        slices_[i]->end = count * (i + 1) / participants;
+    }
+    body_ = &body;
+    failed_ = false;
+    error_ = nullptr;
+    {
+        std::lock_guard lock(mutex_);
+        running_ = workers_.size();
+        ++generation_;
+    }
+    start_.notify_all();
+
+    Participate(0);
+    {
+        std::unique_lock lock(mutex_);
+        finished_.wait(lock, [this] { return running_ == 0; });
+    }
+    body_ = nullptr;
+    if (error_ != nullptr) {
+        std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+}
+
+void ThreadPool::WorkerLoop(std::size_t participant) {
+    std::uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock lock(mutex_);
+            start_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) {
+                return;
+            }
+            seen = generation_;
+        }
+        Participate(participant);
+        {
+            std::lock_guard lock(mutex_);
+            --running_;
+        }
+        finished_.notify_one();
+    }
+}
+
+void ThreadPool::Participate(std::size_t participant) {
+    std::size_t index = 0;
+    while (TakeOwn(participant, &index) || (Steal(participant) && TakeOwn(participant, &index))) {
+        if (failed_.load(std::memory_order_relaxed)) {
+            continue;
+        }
+        try {
+            (*body_)(index, participant);
+        } catch (...) {
+            std::lock_guard lock(mutex_);
+            if (!failed_.exchange(true)) {
+                error_ = std::current_exception();
+            }
+        }
+    }
+}
+
+bool ThreadPool::TakeOwn(std::size_t participant, std::size_t* index) {
+    Slice& slice = *slices_[participant];
+    std::lock_guard lock(slice.mutex);
+    if (slice.begin == slice.end) {
+        return false;
+    }
+    *index = slice.begin++;
+    return true;
+}
+
+bool ThreadPool::Steal(std::size_t participant) {
+    while (true) {
+        // Sizes are only a hint, the victim is checked again under its lock
+        std::size_t victim = participant;
+        std::size_t largest = 0;
+        for (std::size_t i = 0; i < Size(); ++i) {
+            Slice& slice = *slices_[i];
+            std::lock_guard lock(slice.mutex);
+            if (slice.end - slice.begin > largest) {
+                largest = slice.end - slice.begin;
+                victim = i;
+            }
+        }
+        if (largest == 0) {
+            return false;
+        }
+        std::size_t begin = 0;
+        std::size_t end = 0;
+        {
+            Slice& slice = *slices_[victim];
+            std::lock_guard lock(slice.mutex);
+            if (slice.begin == slice.end) {
+                continue;
+            }
+            // Rounded down, so the only index of a slice is taken as well
+            begin = slice.begin + (slice.end - slice.begin) / 2;
+            end = slice.end;
+            slice.end = begin;
+        }
+        Slice& own = *slices_[participant];
+        std::lock_guard lock(own.mutex);
+        own.begin = begin;
+        own.end = end;
+        return true;
+    }
+}
+
+}  // namespace bier
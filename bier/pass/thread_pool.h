@@ -0,0 +1,82 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bier {
+
+// Fixed set of worker threads running index loops. Every participant starts with an equal
+// slice of the indices and takes them one at a time from the front, an idle participant
+// steals the back half of the largest remaining slice.
+class ThreadPool {
+public:
+    // Body of a loop, gets the index and the participant running it, in [0, Size())
+    using Body = std::function<void(std::size_t index, std::size_t participant)>;
+
+    // The calling thread participates in loops too, so threads - 1 workers are started
+    explicit ThreadPool(std::size_t threads = DefaultThreadCount());
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool();
+
+    static std::size_t DefaultThreadCount();
+
+    std::size_t Size() const {
+        return slices_.size();
+    }
+
+    // Runs body for every index in [0, count) and returns once all of them are done. The first
+    // exception thrown by the body is rethrown here, the remaining indices are skipped.
+    // Loops of one pool must not overlap.
+    void ParallelFor(std::size_t count, const Body& body);
+
+private:
+    struct alignas(64) Slice {
+        std::mutex mutex;
+        std::size_t begin = 0;
+        std::size_t end = 0;
+    };
+
+    std::vector<std::unique_ptr<Slice>> slices_;
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable start_;
+    std::condition_variable finished_;
+    std::uint64_t generation_ = 0;
+    std::size_t running_ = 0;
+    bool stop_ = false;
+
+    const Body* body_ = nullptr;
+    std::atomic<bool> failed_{false};
+    std::exception_ptr error_;
+
+    void WorkerLoop(std::size_t participant);
+    void Participate(std::size_t participant);
+    bool TakeOwn(std::size_t participant, std::size_t* index);
+    bool Steal(std::size_t participant);
+};
+
+}  // namespace bier
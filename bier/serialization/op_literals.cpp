@@ -142,6 +142,12 @@ struct OpLiteral<OpCodes::ALLOC_LAYOUT_OP> {
     static constexpr const char* Literal = "alloc_layout";
 };
 
+// Phi
+template <>
+struct OpLiteral<OpCodes::PHI_OP> {
+    static constexpr const char* Literal = "phi";
+};
+
 LiteralArray<0>::LiteralArray() : Value(OpLiteral<0>::Literal){};
 
 const Literal Literal::instance_;
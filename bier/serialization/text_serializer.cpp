@@ -54,12 +54,20 @@ std::ostream& StringSerializer::TranslateOp(const Operation* op, std::ostream& s
         const Layout* layout = alloc_op->GetLayout();
         layout->Name().empty() ? TranslateLayout(layout, stream) : stream << "@" + layout->Name();
     }
+    if (op->OpCode() == OpCodes::PHI_OP) {
+        auto phi_op = static_cast<const PhiOp*>(op);
+        for (std::size_t i = 0; i < phi_op->IncomingCount(); ++i) {
+            stream << (i == 0 ? "[" : ", [");
+            TranslateValue(phi_op->IncomingValue(i), stream)
+                << ", " << phi_op->IncomingBlock(i)->GetLabel() << "]";
+        }
+        return stream;
+    }
     JoinWithSeparator(", ", stream, op->GetArguments(), [&](const Value* arg){
         TranslateValue(arg, stream);
     });
     if (op->OpCode() == OpCodes::BRANCH_OP || op->OpCode() == OpCodes::COND_BRANCH_OP) {
-        auto branch_op = dynamic_cast<const Branch*>(op);
-        JoinWithSeparator(", ", stream, branch_op->DestinationBlocks(), [&](const BasicBlock* block) {
+        JoinWithSeparator(", ", stream, op->GetSuccessors(), [&](const BasicBlock* block) {
              stream << block->GetLabel();
         });
     }
@@ -68,10 +76,10 @@ std::ostream& StringSerializer::TranslateOp(const Operation* op, std::ostream& s
 
 std::ostream& StringSerializer::TranslateValue(const Value* value, std::ostream& stream) const {
     stream << value->GetType()->ToString() << " ";
-    const auto const_val = dynamic_cast<const ConstValue*>(value);
+    const auto const_val = dyn_cast<ConstValue>(value);
     if (const_val != nullptr) {
         stream << const_val->GetConstValue();
-    } else if(const auto func_ptr = dynamic_cast<const FunctionPointer*>(value)) {
+    } else if(const auto func_ptr = dyn_cast<FunctionPointer>(value)) {
         TranslateFunctionSignature(func_ptr->GetFunc(), stream);
     } else {
         stream << (value->IsMutable() ? "$" : "%") << value->GetName();
@@ -113,13 +121,13 @@ std::ostream& StringSerializer::PrintModule(const Module* module, std::ostream&
     stream << "\n";
     for (const auto& [signature, body] : module->GetDefinedFunctions()) {
         TranslateFunctionSignature(signature, stream) << " {\n";
-        for (const auto& block : body->GetBlocks()) {
-            if (!block.GetLabel().empty()) {
-                stream << block.GetLabel() << ":\n";
+        for (const BasicBlock* block : body->GetBlocks()) {
+            if (!block->GetLabel().empty()) {
+                stream << block->GetLabel() << ":\n";
             }
-            for (const auto& op : block.GetOperations()) {
+            for (const auto& op : block->GetOperations()) {
                 stream << "\t";
-                TranslateOp(op.get(), stream) << "\n";
+                TranslateOp(op, stream) << "\n";
             }
         }
         stream << "}\n\n";
@@ -0,0 +1,109 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace bier {
+
+// Destroys an arena-allocated object in place. The memory itself is owned by the arena and
+// is released all at once together with it.
+struct ArenaDeleter {
+    template <typename T>
+    void operator()(T* object) const {
+        object->~T();
+    }
+};
+
+template <typename T>
+using ArenaPtr = std::unique_ptr<T, ArenaDeleter>;
+
+// Bump allocator. Memory is carved out of large chunks and is never returned before the
+// arena itself is destroyed, so allocation is a pointer increment and teardown is a handful
+// of chunk deallocations.
+class Arena {
+public:
+    static constexpr std::size_t kDefaultChunkSize = 64 * 1024;
+
+    explicit Arena(std::size_t chunk_size = kDefaultChunkSize) : chunk_size_(chunk_size) {
+        assert(chunk_size_ > 0);
+    }
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* Allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t)) {
+        assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+        allocated_ += size;
+        if (size + alignment > chunk_size_ / 4) {
+            // Large objects get a dedicated chunk, so that the current one is not wasted
+            return Align(AddChunk(size + alignment), alignment);
+        }
+        char* aligned = current_ == nullptr ? nullptr : Align(current_, alignment);
+        if (aligned == nullptr || aligned + size > end_) {
+            current_ = AddChunk(chunk_size_);
+            end_ = current_ + chunk_size_;
+            aligned = Align(current_, alignment);
+        }
+        current_ = aligned + size;
+        return aligned;
+    }
+
+    template <typename T>
+    T* AllocateArray(std::size_t count) {
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    template <typename T, typename... Args>
+    ArenaPtr<T> Make(Args&&... args) {
+        void* memory = Allocate(sizeof(T), alignof(T));
+        return ArenaPtr<T>(new (memory) T(std::forward<Args>(args)...));
+    }
+
+    // Bytes requested by the users of the arena
+    std::size_t AllocatedBytes() const {
+        return allocated_;
+    }
+    // Bytes actually obtained from the system allocator
+    std::size_t ReservedBytes() const {
+        return reserved_;
+    }
+
+private:
+    std::vector<std::unique_ptr<char[]>> chunks_;
+    std::size_t chunk_size_;
+    char* current_ = nullptr;
+    char* end_ = nullptr;
+    std::size_t allocated_ = 0;
+    std::size_t reserved_ = 0;
+
+    static char* Align(char* ptr, std::size_t alignment) {
+        const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+        return ptr + ((alignment - address % alignment) % alignment);
+    }
+
+    char* AddChunk(std::size_t size) {
+        chunks_.emplace_back(new char[size]);
+        reserved_ += size;
+        return chunks_.back().get();
+    }
+};
+
+}  // namespace bier
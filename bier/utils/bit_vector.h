@@ -0,0 +1,166 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace bier {
+
+// Fixed-size bitvector for dataflow sets. Bulk operations work on whole 64-bit words in plain
+// branch-free loops, so the compiler can vectorize them. Bits past Size() are always zero.
+class DenseBitVector {
+public:
+    static constexpr std::size_t kNoBit = static_cast<std::size_t>(-1);
+
+    explicit DenseBitVector(std::size_t size = 0, bool value = false)
+        : words_(WordCount(size), value ? ~Word(0) : 0), size_(size) {
+        ClearTail();
+    }
+
+    std::size_t Size() const {
+        return size_;
+    }
+    void Resize(std::size_t size) {
+        words_.resize(WordCount(size), 0);
+        size_ = size;
+        ClearTail();
+    }
+
+    bool Test(std::size_t index) const {
+        assert(index < size_);
+        return (words_[index / kWordBits] >> (index % kWordBits)) & 1;
+    }
+    void Set(std::size_t index) {
+        assert(index < size_);
+        words_[index / kWordBits] |= Word(1) << (index % kWordBits);
+    }
+    void Reset(std::size_t index) {
+        assert(index < size_);
+        words_[index / kWordBits] &= ~(Word(1) << (index % kWordBits));
+    }
+    void SetAll() {
+        for (auto& word : words_) {
+            word = ~Word(0);
+        }
+        ClearTail();
+    }
+    void ResetAll() {
+        for (auto& word : words_) {
+            word = 0;
+        }
+    }
+
+    // Bulk operations return whether this vector changed
+    bool UnionWith(const DenseBitVector& other) {
+        return Apply(other, [](Word a, Word b) { return a | b; });
+    }
+    bool IntersectWith(const DenseBitVector& other) {
+        return Apply(other, [](Word a, Word b) { return a & b; });
+    }
+    bool Subtract(const DenseBitVector& other) {
+        return Apply(other, [](Word a, Word b) { return a & ~b; });
+    }
+    // this = gen | (in & ~kill), the transfer function of gen/kill problems
+    bool AssignTransfer(const DenseBitVector& gen, const DenseBitVector& in,
+                        const DenseBitVector& kill) {
+        assert(gen.size_ == size_ && in.size_ == size_ && kill.size_ == size_);
+        Word changed = 0;
+        for (std::size_t i = 0; i < words_.size(); ++i) {
+            const Word word = gen.words_[i] | (in.words_[i] & ~kill.words_[i]);
+            changed |= word ^ words_[i];
+            words_[i] = word;
+        }
+        return changed != 0;
+    }
+
+    bool Any() const {
+        Word any = 0;
+        for (auto word : words_) {
+            any |= word;
+        }
+        return any != 0;
+    }
+    std::size_t Count() const {
+        std::size_t count = 0;
+        for (auto word : words_) {
+            count += __builtin_popcountll(word);
+        }
+        return count;
+    }
+
+    // First set bit at or after index, kNoBit if there is none
+    std::size_t FindNext(std::size_t index) const {
+        if (index >= size_) {
+            return kNoBit;
+        }
+        std::size_t word_index = index / kWordBits;
+        Word word = words_[word_index] & (~Word(0) << (index % kWordBits));
+        while (word == 0) {
+            if (++word_index == words_.size()) {
+                return kNoBit;
+            }
+            word = words_[word_index];
+        }
+        return word_index * kWordBits + __builtin_ctzll(word);
+    }
+
+    template <typename TCallback>
+    void ForEach(TCallback callback) const {
+        for (std::size_t i = 0; i < words_.size(); ++i) {
+            for (Word word = words_[i]; word != 0; word &= word - 1) {
+                callback(i * kWordBits + __builtin_ctzll(word));
+            }
+        }
+    }
+
+    bool operator==(const DenseBitVector& other) const {
+        return size_ == other.size_ && words_ == other.words_;
+    }
+    bool operator!=(const DenseBitVector& other) const {
+        return !(*this == other);
+    }
+
+private:
+    using Word = std::uint64_t;
+    static constexpr std::size_t kWordBits = 64;
+
+    std::vector<Word> words_;
+    std::size_t size_ = 0;
+
+    static std::size_t WordCount(std::size_t size) {
+        return (size + kWordBits - 1) / kWordBits;
+    }
+    void ClearTail() {
+        if (size_ % kWordBits != 0) {
+            words_.back() &= (Word(1) << (size_ % kWordBits)) - 1;
+        }
+    }
+
+    template <typename TOperation>
+    bool Apply(const DenseBitVector& other, TOperation operation) {
+        assert(other.size_ == size_);
+        Word changed = 0;
+        for (std::size_t i = 0; i < words_.size(); ++i) {
+            const Word word = operation(words_[i], other.words_[i]);
+            changed |= word ^ words_[i];
+            words_[i] = word;
+        }
+        return changed != 0;
+    }
+};
+
+}  // namespace bier
@@ -0,0 +1,52 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+#include <cassert>
+#include <type_traits>
+
+namespace bier {
+
+// LLVM-style classification. To should provide static bool classof(const Base*), which
+// usually compares the kind tag stored in the base class, so no RTTI is involved.
+
+template <typename To, typename From>
+using CastResult = std::conditional_t<std::is_const_v<From>, const To*, To*>;
+
+template <typename To, typename From>
+bool isa(From* object) {
+    assert(object != nullptr);
+    return To::classof(object);
+}
+
+template <typename To, typename From>
+CastResult<To, From> cast(From* object) {
+    assert(isa<To>(object));
+    return static_cast<CastResult<To, From>>(object);
+}
+
+// Returns nullptr if object is not a To
+template <typename To, typename From>
+CastResult<To, From> dyn_cast(From* object) {
+    return isa<To>(object) ? static_cast<CastResult<To, From>>(object) : nullptr;
+}
+
+// Same as dyn_cast, but accepts nullptr
+template <typename To, typename From>
+CastResult<To, From> dyn_cast_or_null(From* object) {
+    return object != nullptr ? dyn_cast<To>(object) : nullptr;
+}
+
+}  // namespace bier
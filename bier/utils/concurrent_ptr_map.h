@@ -0,0 +1,142 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace bier {
+
+// Open addressing hash map from non-null pointers to non-null pointers for read-mostly data.
+// Lookups take no locks and may run concurrently with an insertion. Insertions have to be
+// serialized by the owner. A full table is copied into one twice as large, and the old one is
+// kept until the map is destroyed, so a lookup racing with the copy still reads valid slots.
+// Keys are matched through callers' predicates, so lookups can use probes of another type.
+// Hashes are scrambled by the map, so raw addresses make fine hashes.
+template <typename TKey, typename TValue>
+class ConcurrentPtrMap {
+public:
+    static constexpr std::size_t kInitialCapacity = 16;
+
+    ConcurrentPtrMap() {
+        tables_.push_back(std::make_unique<Table>(kInitialCapacity));
+        table_.store(tables_.back().get(), std::memory_order_release);
+    }
+    ConcurrentPtrMap(const ConcurrentPtrMap&) = delete;
+    ConcurrentPtrMap& operator=(const ConcurrentPtrMap&) = delete;
+
+    // Value of the key with the given hash satisfying matches(key), nullptr if there is none
+    template <typename TMatch>
+    TValue FindIf(std::size_t hash, const TMatch& matches) const {
+        const Table* table = table_.load(std::memory_order_acquire);
+        for (std::size_t i = table->Start(hash);; i = (i + 1) & table->mask) {
+            const Slot& slot = table->slots[i];
+            const TKey key = slot.key.load(std::memory_order_acquire);
+            if (key == nullptr) {
+                return nullptr;
+            }
+            if (slot.hash.load(std::memory_order_relaxed) == hash && matches(key)) {
+                return slot.value.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    TValue Find(std::size_t hash, TKey key) const {
+        return FindIf(hash, [key](TKey other) { return other == key; });
+    }
+
+    // The key must not be present yet
+    void Insert(std::size_t hash, TKey key, TValue value) {
+        assert(key != nullptr && value != nullptr);
+        Table* table = tables_.back().get();
+        if ((size_ + 1) * 2 > table->mask + 1) {
+            table = Grow(*table);
+        }
+        Place(table, hash, key, value);
+        ++size_;
+    }
+
+    // Number of keys, only meaningful while no insertion runs
+    std::size_t Size() const {
+        return size_;
+    }
+
+private:
+    static constexpr unsigned kHashBits = 64;
+
+    struct Slot {
+        std::atomic<TKey> key{nullptr};
+        std::atomic<TValue> value{nullptr};
+        std::atomic<std::size_t> hash{0};
+    };
+    struct Table {
+        explicit Table(std::size_t capacity)
+            : mask(capacity - 1), slots(std::make_unique<Slot[]>(capacity)) {
+            assert((capacity & mask) == 0);
+            while ((std::size_t(1) << (kHashBits - shift)) < capacity) {
+                --shift;
+            }
+        }
+
+        // Fibonacci hashing, the top bits of the product pick the slot
+        std::size_t Start(std::size_t hash) const {
+            return static_cast<std::size_t>((std::uint64_t(hash) * 0x9E3779B97F4A7C15ull) >>
+                                            shift) &
+                   mask;
+        }
+
+        const std::size_t mask;
+        unsigned shift = kHashBits;
+        const std::unique_ptr<Slot[]> slots;
+    };
+
+    std::atomic<const Table*> table_{nullptr};
+    // The current table and every retired one
+    std::vector<std::unique_ptr<Table>> tables_;
+    std::size_t size_ = 0;
+
+    static void Place(Table* table, std::size_t hash, TKey key, TValue value) {
+        std::size_t i = table->Start(hash);
+        while (table->slots[i].key.load(std::memory_order_relaxed) != nullptr) {
+            i = (i + 1) & table->mask;
+        }
+        Slot& slot = table->slots[i];
+        slot.hash.store(hash, std::memory_order_relaxed);
+        slot.value.store(value, std::memory_order_relaxed);
+        // Publishes the hash and the value together with the key
+        slot.key.store(key, std::memory_order_release);
+    }
+
+    Table* Grow(const Table& table) {
+        auto grown = std::make_unique<Table>((table.mask + 1) * 2);
+        for (std::size_t i = 0; i <= table.mask; ++i) {
+            const Slot& slot = table.slots[i];
+            const TKey key = slot.key.load(std::memory_order_relaxed);
+            if (key != nullptr) {
+                Place(grown.get(), slot.hash.load(std::memory_order_relaxed), key,
+                      slot.value.load(std::memory_order_relaxed));
+            }
+        }
+        tables_.push_back(std::move(grown));
+        table_.store(tables_.back().get(), std::memory_order_release);
+        return tables_.back().get();
+    }
+};
+
+}  // namespace bier
@@ -0,0 +1,133 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace bier {
+
+constexpr std::uint32_t kNoDenseIndex = std::numeric_limits<std::uint32_t>::max();
+
+// Vector-backed map for keys carrying a dense index through GetIndex(). Indices are only
+// unique within one function, so a map should not mix keys of different functions.
+// Keys without an index are never contained in the map.
+template <typename TKey, typename TValue>
+class DenseIndexMap {
+public:
+    explicit DenseIndexMap(std::size_t capacity = 0) {
+        slots_.reserve(capacity);
+    }
+
+    bool Has(const TKey* key) const {
+        const std::uint32_t index = key->GetIndex();
+        return index < slots_.size() && slots_[index].has_value();
+    }
+
+    // Does not overwrite an existing value, same as std::unordered_map::insert
+    bool Insert(const TKey* key, TValue value) {
+        auto& slot = Slot(key);
+        if (slot.has_value()) {
+            return false;
+        }
+        slot.emplace(std::move(value));
+        ++size_;
+        return true;
+    }
+
+    TValue& operator[](const TKey* key) {
+        auto& slot = Slot(key);
+        if (!slot.has_value()) {
+            slot.emplace();
+            ++size_;
+        }
+        return slot.value();
+    }
+
+    const TValue& At(const TKey* key) const {
+        assert(Has(key));
+        return slots_[key->GetIndex()].value();
+    }
+    TValue& At(const TKey* key) {
+        assert(Has(key));
+        return slots_[key->GetIndex()].value();
+    }
+
+    void Erase(const TKey* key) {
+        if (Has(key)) {
+            slots_[key->GetIndex()].reset();
+            --size_;
+        }
+    }
+
+    void Clear() {
+        slots_.clear();
+        size_ = 0;
+    }
+    std::size_t Size() const {
+        return size_;
+    }
+
+private:
+    std::vector<std::optional<TValue>> slots_;
+    std::size_t size_ = 0;
+
+    std::optional<TValue>& Slot(const TKey* key) {
+        const std::uint32_t index = key->GetIndex();
+        assert(index != kNoDenseIndex);
+        if (index >= slots_.size()) {
+            slots_.resize(index + 1);
+        }
+        return slots_[index];
+    }
+};
+
+// Bitvector of keys carrying a dense index
+template <typename TKey>
+class DenseIndexSet {
+public:
+    explicit DenseIndexSet(std::size_t capacity = 0) {
+        bits_.reserve(capacity);
+    }
+
+    bool Has(const TKey* key) const {
+        const std::uint32_t index = key->GetIndex();
+        return index < bits_.size() && bits_[index];
+    }
+    void Insert(const TKey* key) {
+        const std::uint32_t index = key->GetIndex();
+        assert(index != kNoDenseIndex);
+        if (index >= bits_.size()) {
+            bits_.resize(index + 1, false);
+        }
+        bits_[index] = true;
+    }
+    void Erase(const TKey* key) {
+        if (Has(key)) {
+            bits_[key->GetIndex()] = false;
+        }
+    }
+    void Clear() {
+        bits_.clear();
+    }
+
+private:
+    std::vector<bool> bits_;
+};
+
+}  // namespace bier
@@ -14,86 +14,247 @@
    limitations under the License.
 */
 #pragma once
+#include <cassert>
+#include <cstddef>
+#include <iterator>
 #include <memory>
 
 namespace bier {
 
+template <typename T, typename TDeleter>
+class IntrusiveDList;
+
+// Node of a doubly-linked list, links are stored in the element itself, so that
+// insertion and removal do not allocate.
 template <typename T>
-class IntrusiveListNode {
+class IntrusiveDListNode {
+public:
+    const T* Prev() const {
+        return prev_;
+    }
+    T* Prev() {
+        return prev_;
+    }
+    const T* Next() const {
+        return next_;
+    }
+    T* Next() {
+        return next_;
+    }
+
+private:
+    template <typename, typename>
+    friend class IntrusiveDList;
+
+    T* prev_ = nullptr;
+    T* next_ = nullptr;
+};
+
+// Owning doubly-linked list of IntrusiveDListNode-s. Elements are destroyed with TDeleter.
+template <typename T, typename TDeleter = std::default_delete<T>>
+class IntrusiveDList {
 public:
-    using Ptr = std::unique_ptr<T>;
-    class Iterator {
+    using Ptr = std::unique_ptr<T, TDeleter>;
+
+    template <typename TValue>
+    class BaseIterator {
     public:
-        explicit Iterator(IntrusiveListNode* node) : node_(node) {
-        }
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = TValue*;
+        using difference_type = std::ptrdiff_t;
+        using pointer = TValue*;
+        using reference = TValue*;
 
-        const T& operator*() const {
-            return static_cast<const T&>(*node_);
+        BaseIterator() = default;
+        BaseIterator(TValue* node, const IntrusiveDList* list) : node_(node), list_(list) {
         }
-        T& operator*() {
-            return static_cast<T&>(*node_);
+        template <typename TOther>
+        BaseIterator(const BaseIterator<TOther>& other)
+            : node_(other.node_), list_(other.list_) {
         }
-        const T& operator->() const {
-            return static_cast<const T&>(*node_);
+
+        TValue* operator*() const {
+            return node_;
         }
-        T& operator->() {
-            return static_cast<T&>(*node_);
+        TValue* operator->() const {
+            return node_;
         }
-        bool operator==(const Iterator& other) const {
+        bool operator==(const BaseIterator& other) const {
             return node_ == other.node_;
         }
-        bool operator!=(const Iterator& other) const {
+        bool operator!=(const BaseIterator& other) const {
             return !(*this == other);
         }
-        Iterator& operator++() {
+        BaseIterator& operator++() {
             node_ = node_->Next();
             return *this;
         }
+        BaseIterator operator++(int) {
+            BaseIterator copy = *this;
+            ++*this;
+            return copy;
+        }
+        // Decrementing end() gives the last element
+        BaseIterator& operator--() {
+            node_ = node_ == nullptr ? list_->tail_ : node_->Prev();
+            return *this;
+        }
+        BaseIterator operator--(int) {
+            BaseIterator copy = *this;
+            --*this;
+            return copy;
+        }
 
     private:
-        IntrusiveListNode* node_;
+        template <typename>
+        friend class BaseIterator;
+        friend class IntrusiveDList;
+
+        TValue* node_ = nullptr;
+        const IntrusiveDList* list_ = nullptr;
     };
 
-    using iterator = Iterator;
-    using const_iterator = const Iterator;
+    using iterator = BaseIterator<T>;
+    using const_iterator = BaseIterator<const T>;
 
-    auto begin() {
-        return IntrusiveListNode::Iterator(this);
-    }
-    auto end() {
-        return IntrusiveListNode::Iterator(nullptr);
+    IntrusiveDList() = default;
+    IntrusiveDList(const IntrusiveDList&) = delete;
+    IntrusiveDList& operator=(const IntrusiveDList&) = delete;
+    ~IntrusiveDList() {
+        clear();
     }
 
-    auto begin() const {
-        return IntrusiveListNode::Iterator(this);
+    iterator begin() {
+        return iterator(head_, this);
     }
-    auto end() const {
-        return IntrusiveListNode::Iterator(nullptr);
+    iterator end() {
+        return iterator(nullptr, this);
+    }
+    const_iterator begin() const {
+        return const_iterator(head_, this);
+    }
+    const_iterator end() const {
+        return const_iterator(nullptr, this);
+    }
+    // Recounted after a splice of a part of the list, so the splice itself stays O(1)
+    std::size_t size() const {
+        if (!size_known_) {
+            size_ = 0;
+            for (const T* node = head_; node != nullptr; node = node->Next()) {
+                ++size_;
+            }
+            size_known_ = true;
+        }
+        return size_;
+    }
+    bool empty() const {
+        return head_ == nullptr;
+    }
+    T* front() const {
+        return head_;
+    }
+    T* back() const {
+        return tail_;
     }
 
-    void InsertNext(Ptr&& toInsert) {
-        toInsert->next_ = std::move(next_);
-        next_ = std::move(toInsert);
+    iterator MakeIterator(T* node) {
+        return iterator(node, this);
     }
-    void Attach(Ptr&& toInsert) {
-        next_ = std::move(toInsert);
+    const_iterator MakeIterator(const T* node) const {
+        return const_iterator(node, this);
     }
-    Ptr DetachNext() {
-        Ptr toDetach = std::move(next_);
-        next_ = std::move(toDetach->next_);
 
-        return toDetach;
+    // Inserts node before position
+    iterator Insert(iterator position, Ptr&& node) {
+        assert(node != nullptr);
+        T* raw = node.release();
+        Link(position.node_, raw);
+        return iterator(raw, this);
+    }
+    void PushBack(Ptr&& node) {
+        Insert(end(), std::move(node));
+    }
+    void PushFront(Ptr&& node) {
+        Insert(begin(), std::move(node));
+    }
+    // Unlinks node and hands over its ownership
+    Ptr Remove(iterator position) {
+        assert(position.node_ != nullptr);
+        T* raw = position.node_;
+        Unlink(raw);
+        return Ptr(raw);
+    }
+    // Destroys node and returns the following one
+    iterator Erase(iterator position) {
+        iterator next = std::next(position);
+        Remove(position);
+        return iterator(next.node_, this);
     }
+    // Moves [first, last) from other before position in O(1). Unless the whole of other is
+    // moved, the sizes of both lists are recounted on the next size() call.
+    void Splice(iterator position, IntrusiveDList& other, iterator first, iterator last) {
+        if (first == last) {
+            return;
+        }
+        T* first_node = first.node_;
+        T* last_node = last.node_ == nullptr ? other.tail_ : last.node_->Prev();
+        const bool whole = first_node == other.head_ && last_node == other.tail_;
+        if (whole && other.size_known_) {
+            size_ += other.size_;
+        } else {
+            size_known_ = false;
+        }
+        other.size_ = 0;
+        other.size_known_ = whole;
 
-    const T* Next() const {
-        return next_.get();
+        // Cut out of other
+        T* before = first_node->Prev();
+        T* after = last_node->Next();
+        (before == nullptr ? other.head_ : Links(before).next_) = after;
+        (after == nullptr ? other.tail_ : Links(after).prev_) = before;
+
+        // Stitch into this
+        T* next = position.node_;
+        T* prev = next == nullptr ? tail_ : next->Prev();
+        Links(first_node).prev_ = prev;
+        Links(last_node).next_ = next;
+        (prev == nullptr ? head_ : Links(prev).next_) = first_node;
+        (next == nullptr ? tail_ : Links(next).prev_) = last_node;
     }
-    T* Next() {
-        return next_.get();
+    void clear() {
+        while (head_ != nullptr) {
+            Remove(begin());
+        }
     }
 
 private:
-    Ptr next_;
+    T* head_ = nullptr;
+    T* tail_ = nullptr;
+    // Only exact while size_known_ is set
+    mutable std::size_t size_ = 0;
+    mutable bool size_known_ = true;
+
+    static IntrusiveDListNode<T>& Links(T* node) {
+        return static_cast<IntrusiveDListNode<T>&>(*node);
+    }
+
+    void Link(T* next, T* node) {
+        T* prev = next == nullptr ? tail_ : next->Prev();
+        Links(node).prev_ = prev;
+        Links(node).next_ = next;
+        (prev == nullptr ? head_ : Links(prev).next_) = node;
+        (next == nullptr ? tail_ : Links(next).prev_) = node;
+        ++size_;
+    }
+    void Unlink(T* node) {
+        T* prev = node->Prev();
+        T* next = node->Next();
+        (prev == nullptr ? head_ : Links(prev).next_) = next;
+        (next == nullptr ? tail_ : Links(next).prev_) = prev;
+        Links(node).prev_ = nullptr;
+        Links(node).next_ = nullptr;
+        --size_;
+    }
 };
 
 }  // namespace bier
@@ -0,0 +1,130 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace bier {
+
+class SymbolTable;
+
+// Interned string. Two symbols of the same table are equal iff their strings are equal,
+// so symbols are compared and hashed as integers. The default symbol is the empty string.
+class Symbol {
+public:
+    struct Hash {
+        std::size_t operator()(const Symbol& symbol) const {
+            return std::hash<std::uint32_t>()(symbol.Id());
+        }
+    };
+
+    Symbol() = default;
+
+    const std::string& Str() const {
+        static const std::string kEmpty;
+        return entry_ == nullptr ? kEmpty : entry_->str;
+    }
+    std::string_view View() const {
+        return Str();
+    }
+    std::uint32_t Id() const {
+        return entry_ == nullptr ? 0 : entry_->id;
+    }
+    bool Empty() const {
+        return entry_ == nullptr;
+    }
+
+    bool operator==(const Symbol& other) const {
+        return entry_ == other.entry_;
+    }
+    bool operator!=(const Symbol& other) const {
+        return entry_ != other.entry_;
+    }
+
+private:
+    friend class SymbolTable;
+
+    struct Entry {
+        std::string str;
+        std::uint32_t id = 0;
+    };
+
+    explicit Symbol(const Entry* entry) : entry_(entry) {
+    }
+
+    const Entry* entry_ = nullptr;
+};
+
+// Owns interned strings, they stay at the same address for the lifetime of the table.
+// Safe to use from several threads.
+class SymbolTable {
+public:
+    SymbolTable() = default;
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    Symbol Intern(std::string_view str) {
+        if (str.empty()) {
+            return Symbol();
+        }
+        if (auto symbol = Find(str)) {
+            return *symbol;
+        }
+        std::unique_lock lock(mutex_);
+        auto it = index_.find(str);
+        if (it != index_.end()) {
+            return Symbol(it->second);
+        }
+        Symbol::Entry& entry = entries_.emplace_back();
+        entry.str = str;
+        entry.id = static_cast<std::uint32_t>(entries_.size());
+        index_.emplace(entry.str, &entry);
+        return Symbol(&entry);
+    }
+
+    // Does not intern, so lookups of unknown names leave the table intact
+    std::optional<Symbol> Find(std::string_view str) const {
+        if (str.empty()) {
+            return Symbol();
+        }
+        std::shared_lock lock(mutex_);
+        auto it = index_.find(str);
+        if (it == index_.end()) {
+            return std::nullopt;
+        }
+        return Symbol(it->second);
+    }
+
+    std::size_t Size() const {
+        std::shared_lock lock(mutex_);
+        return entries_.size();
+    }
+
+private:
+    mutable std::shared_mutex mutex_;
+    std::deque<Symbol::Entry> entries_;
+    std::unordered_map<std::string_view, const Symbol::Entry*> index_;
+};
+
+}  // namespace bier
@@ -0,0 +1,127 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/analysis/analysis_manager.h>
+#include <bier/analysis/dominator_tree.h>
+#include "loop_function.h"
+
+using namespace bier;
+
+namespace bier_tests {
+
+namespace {
+
+struct BlockCount {
+    explicit BlockCount(const Function* function) : count(function->GetBlocks().Size()) {}
+    std::size_t count;
+};
+
+struct FunctionCount {
+    explicit FunctionCount(const Module* module)
+        : count(module->GetDefinedFunctions().Size()) {}
+    std::size_t count;
+};
+
+}  // namespace
+
+TEST_CASE("Analysis results are cached until the function changes", "[analysis_manager]") {
+    LoopFunction f;
+    AnalysisManager manager;
+    auto first = manager.GetResult<BlockCount>(f.function);
+    REQUIRE(first->count == 4);
+    REQUIRE(manager.GetResult<BlockCount>(f.function) == first);
+    REQUIRE(manager.GetCachedResult<BlockCount>(f.function) == first);
+    REQUIRE(manager.GetCachedResult<DominatorTree>(f.function) == nullptr);
+    REQUIRE(manager.GetComputedCount() == 1);
+
+    // Changes made outside of a pass always invalidate
+    f.function->CreateBlock("extra");
+    REQUIRE(manager.GetCachedResult<BlockCount>(f.function) == nullptr);
+    REQUIRE(manager.GetResult<BlockCount>(f.function)->count == 5);
+    REQUIRE(manager.GetComputedCount() == 2);
+}
+
+TEST_CASE("Passes invalidate what they do not preserve", "[analysis_manager]") {
+    LoopFunction f;
+    LoopFunction untouched;
+    AnalysisManager manager;
+    auto blocks = manager.GetResult<BlockCount>(f.function);
+    auto domtree = manager.GetResult<DominatorTree>(f.function);
+    auto other = manager.GetResult<DominatorTree>(untouched.function);
+    REQUIRE(manager.GetComputedCount() == 3);
+
+    // A pass changes f, keeping the dominator tree valid
+    manager.OnPassStarted(&f.module);
+    f.function->MarkModified();
+    manager.OnPassFinished(&f.module, PreservedAnalyses::None().Preserve<DominatorTree>());
+    REQUIRE(manager.GetCachedResult<DominatorTree>(f.function) == domtree);
+    REQUIRE(manager.GetCachedResult<BlockCount>(f.function) == nullptr);
+    REQUIRE(manager.GetResult<DominatorTree>(f.function) == domtree);
+
+    // The next pass preserves nothing but leaves the functions intact
+    manager.OnPassStarted(&f.module);
+    manager.OnPassFinished(&f.module, PreservedAnalyses::None());
+    REQUIRE(manager.GetResult<DominatorTree>(f.function) == domtree);
+    REQUIRE(manager.GetResult<DominatorTree>(untouched.function) == other);
+    REQUIRE(manager.GetComputedCount() == 3);
+
+    manager.OnPassStarted(&f.module);
+    f.function->MarkModified();
+    manager.OnPassFinished(&f.module, PreservedAnalyses::None());
+    REQUIRE(manager.GetResult<DominatorTree>(f.function) != domtree);
+    REQUIRE(manager.GetResult<DominatorTree>(untouched.function) == other);
+    REQUIRE(manager.GetComputedCount() == 4);
+
+    manager.OnPassStarted(&f.module);
+    f.function->MarkModified();
+    manager.OnPassFinished(&f.module, PreservedAnalyses::All());
+    REQUIRE(manager.GetCachedResult<DominatorTree>(f.function) != nullptr);
+    manager.Invalidate(f.function);
+    REQUIRE(manager.GetCachedResult<DominatorTree>(f.function) == nullptr);
+}
+
+TEST_CASE("Edits outside of passes are never preserved", "[analysis_manager]") {
+    LoopFunction f;
+    AnalysisManager manager;
+    auto domtree = manager.GetResult<DominatorTree>(f.function);
+
+    f.function->CreateBlock("extra");
+    manager.OnPassStarted(&f.module);
+    manager.OnPassFinished(&f.module, PreservedAnalyses::All());
+    REQUIRE(manager.GetCachedResult<DominatorTree>(f.function) == nullptr);
+
+    // Nor are they by a pass changing the function afterwards
+    manager.OnPassStarted(&f.module);
+    f.function->MarkModified();
+    manager.OnPassFinished(&f.module, PreservedAnalyses::All());
+    REQUIRE(manager.GetCachedResult<DominatorTree>(f.function) == nullptr);
+    REQUIRE(manager.GetResult<DominatorTree>(f.function) != domtree);
+    REQUIRE(manager.GetComputedCount() == 2);
+}
+
+TEST_CASE("Module analysis results", "[analysis_manager]") {
+    LoopFunction f;
+    AnalysisManager manager;
+    auto functions = manager.GetModuleResult<FunctionCount>(&f.module);
+    REQUIRE(functions->count == 1);
+    manager.OnPassFinished(&f.module, PreservedAnalyses::None().Preserve<FunctionCount>());
+    REQUIRE(manager.GetModuleResult<FunctionCount>(&f.module) == functions);
+    manager.OnPassFinished(&f.module, PreservedAnalyses::None());
+    REQUIRE(manager.GetModuleResult<FunctionCount>(&f.module) != functions);
+    REQUIRE(manager.GetComputedCount() == 2);
+}
+
+}  // namespace bier_tests
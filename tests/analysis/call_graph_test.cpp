@@ -0,0 +1,90 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/analysis/call_graph.h>
+#include <bier/builder/module_builder.h>
+#include <algorithm>
+
+using namespace bier;
+
+namespace bier_tests {
+
+namespace {
+
+// f(n) = callees(n) + ... + 1
+void DefineBody(ModuleBuilder* builder, Function* function,
+                const std::vector<const Function*>& callees) {
+    ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+    builder->AttachTo(builder->CreateBlock(function, "entry"));
+    const Value* sum = builder->CreateInt64Const(1);
+    for (const Function* callee : callees) {
+        sum = builder->CreateAdd(sum, builder->CreateCall(callee, {n}).value());
+    }
+    builder->CreateReturnValue(sum);
+}
+
+std::size_t ComponentOf(const CallGraph& call_graph, const Function* function) {
+    const auto& order = call_graph.GetBottomUpOrder();
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        if (std::find(order[i].begin(), order[i].end(), function) != order[i].end()) {
+            return i;
+        }
+    }
+    return order.size();
+}
+
+}  // namespace
+
+TEST_CASE("Call graph components go bottom-up", "[call_graph]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    std::vector<Function*> functions;
+    for (const char* name : {"leaf", "mid", "even", "odd", "self", "top"}) {
+        functions.push_back(builder.CreateFunction(name, i64, {i64}));
+        (*functions.back()->GetSignature()->Arguments().begin())->SetName("n");
+    }
+    auto [leaf, mid, even, odd, self, top] =
+        std::tie(functions[0], functions[1], functions[2], functions[3], functions[4],
+                 functions[5]);
+    DefineBody(&builder, leaf, {});
+    DefineBody(&builder, mid, {leaf, leaf});
+    DefineBody(&builder, even, {odd, leaf});
+    DefineBody(&builder, odd, {even});
+    DefineBody(&builder, self, {self});
+    DefineBody(&builder, top, {mid, even, self});
+
+    const CallGraph call_graph(module.get());
+    REQUIRE(call_graph.GetBottomUpOrder().size() == 5);
+    REQUIRE(call_graph.GetCallees(mid) == std::vector<const Function*>{leaf});
+    REQUIRE(call_graph.GetCallers(leaf).size() == 2);
+    REQUIRE(call_graph.GetCallees(leaf).empty());
+
+    REQUIRE(call_graph.InSameComponent(even, odd));
+    REQUIRE(!call_graph.InSameComponent(even, leaf));
+    REQUIRE(ComponentOf(call_graph, leaf) < ComponentOf(call_graph, mid));
+    REQUIRE(ComponentOf(call_graph, leaf) < ComponentOf(call_graph, even));
+    REQUIRE(ComponentOf(call_graph, mid) < ComponentOf(call_graph, top));
+    REQUIRE(ComponentOf(call_graph, even) < ComponentOf(call_graph, top));
+    REQUIRE(ComponentOf(call_graph, self) < ComponentOf(call_graph, top));
+
+    REQUIRE(call_graph.IsRecursive(even));
+    REQUIRE(call_graph.IsRecursive(self));
+    REQUIRE(!call_graph.IsRecursive(leaf));
+    REQUIRE(!call_graph.IsRecursive(top));
+}
+
+}  // namespace bier_tests
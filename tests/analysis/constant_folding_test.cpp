@@ -0,0 +1,104 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/analysis/constant_folding.h>
+#include <bier/core/module.h>
+#include <bier/operations/opcodes.h>
+
+using namespace bier;
+
+namespace bier_tests {
+
+TEST_CASE("Integer arithmetic wraps around the bit width", "[constant_folding]") {
+    Module module;
+    const auto* i8 = cast<IntTypeBase>(module.Types()->GetInt8());
+    const auto* i64 = cast<IntTypeBase>(module.Types()->GetInt64());
+    ConstantPool* pool = module.Constants();
+    ConstantFolder folder(pool);
+    auto i8_const = [&](std::uint64_t value) { return pool->GetInteger(value, i8); };
+
+    REQUIRE(folder.FoldBinary(OpCodes::ADD_OP, i8_const(200), i8_const(100), i8) == i8_const(44));
+    REQUIRE(folder.FoldBinary(OpCodes::SUB_OP, i8_const(1), i8_const(2), i8) == i8_const(255));
+    REQUIRE(folder.FoldBinary(OpCodes::MULT_OP, i8_const(16), i8_const(17), i8) == i8_const(16));
+    REQUIRE(folder.FoldBinary(OpCodes::ADD_OP, pool->GetInteger(~0ull, i64),
+                              pool->GetInteger(2, i64), i64) == pool->GetInteger(1, i64));
+    // Operands of different types
+    REQUIRE(folder.FoldBinary(OpCodes::ADD_OP, i8_const(1), pool->GetInteger(1, i64), i64) ==
+            nullptr);
+}
+
+TEST_CASE("Signed and unsigned division", "[constant_folding]") {
+    Module module;
+    const auto* i8 = cast<IntTypeBase>(module.Types()->GetInt8());
+    const auto* i64 = cast<IntTypeBase>(module.Types()->GetInt64());
+    ConstantPool* pool = module.Constants();
+    ConstantFolder folder(pool);
+    auto i8_const = [&](std::uint64_t value) { return pool->GetInteger(value, i8); };
+
+    // 0xf9 is -7
+    REQUIRE(folder.FoldBinary(OpCodes::UDIV_OP, i8_const(0xf9), i8_const(2), i8) ==
+            i8_const(124));
+    REQUIRE(folder.FoldBinary(OpCodes::SDIV_OP, i8_const(0xf9), i8_const(2), i8) ==
+            i8_const(0xfd));
+    REQUIRE(folder.FoldBinary(OpCodes::UREM_OP, i8_const(0xf9), i8_const(2), i8) ==
+            i8_const(1));
+    REQUIRE(folder.FoldBinary(OpCodes::SREM_OP, i8_const(0xf9), i8_const(2), i8) ==
+            i8_const(0xff));
+    REQUIRE(folder.FoldBinary(OpCodes::SDIV_OP, i8_const(7), i8_const(0xfe), i8) ==
+            i8_const(0xfd));
+
+    REQUIRE(folder.FoldBinary(OpCodes::UDIV_OP, i8_const(1), i8_const(0), i8) == nullptr);
+    REQUIRE(folder.FoldBinary(OpCodes::SREM_OP, i8_const(1), i8_const(0), i8) == nullptr);
+    REQUIRE(folder.FoldBinary(OpCodes::SDIV_OP, i8_const(0x80), i8_const(0xff), i8) == nullptr);
+    REQUIRE(folder.FoldBinary(OpCodes::SREM_OP, pool->GetInteger(1ull << 63, i64),
+                              pool->GetInteger(~0ull, i64), i64) == nullptr);
+    REQUIRE(folder.FoldBinary(OpCodes::UDIV_OP, i8_const(0x80), i8_const(0xff), i8) ==
+            i8_const(0));
+}
+
+TEST_CASE("Comparisons are signed", "[constant_folding]") {
+    Module module;
+    const auto* i1 = cast<IntTypeBase>(module.Types()->GetInt1());
+    const auto* i16 = cast<IntTypeBase>(module.Types()->GetInt16());
+    ConstantPool* pool = module.Constants();
+    ConstantFolder folder(pool);
+    const IntegerConst* minus_one = pool->GetInteger(0xffff, i16);
+    const IntegerConst* one = pool->GetInteger(1, i16);
+    const IntegerConst* yes = pool->GetInteger(1, i1);
+    const IntegerConst* no = pool->GetInteger(0, i1);
+
+    REQUIRE(folder.FoldBinary(OpCodes::LT_OP, minus_one, one, i1) == yes);
+    REQUIRE(folder.FoldBinary(OpCodes::GT_OP, minus_one, one, i1) == no);
+    REQUIRE(folder.FoldBinary(OpCodes::LE_OP, one, one, i1) == yes);
+    REQUIRE(folder.FoldBinary(OpCodes::GE_OP, minus_one, one, i1) == no);
+    REQUIRE(folder.FoldBinary(OpCodes::EQ_OP, minus_one, one, i1) == no);
+    REQUIRE(folder.FoldBinary(OpCodes::NE_OP, minus_one, one, i1) == yes);
+}
+
+TEST_CASE("Casts sign extend and truncate", "[constant_folding]") {
+    Module module;
+    const auto* i8 = cast<IntTypeBase>(module.Types()->GetInt8());
+    const auto* i32 = cast<IntTypeBase>(module.Types()->GetInt32());
+    ConstantPool* pool = module.Constants();
+    ConstantFolder folder(pool);
+
+    REQUIRE(folder.FoldCast(pool->GetInteger(0x80, i8), i32) == pool->GetInteger(0xffffff80, i32));
+    REQUIRE(folder.FoldCast(pool->GetInteger(0x7f, i8), i32) == pool->GetInteger(0x7f, i32));
+    REQUIRE(folder.FoldCast(pool->GetInteger(0x12345, i32), i8) == pool->GetInteger(0x45, i8));
+    REQUIRE(folder.FoldCast(pool->GetInteger(1, i8), module.Types()->GetInt8Ptr()) == nullptr);
+}
+
+}  // namespace bier_tests
@@ -0,0 +1,171 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/analysis/available_expressions.h>
+#include <bier/analysis/liveness.h>
+#include <bier/analysis/reaching_definitions.h>
+#include <bier/operations/branch.h>
+#include <bier/operations/phi.h>
+#include "loop_function.h"
+
+using namespace bier;
+
+namespace bier_tests {
+
+namespace {
+
+using BinOp = BinaryOperation::BinOp;
+
+std::vector<std::size_t> Bits(const DenseBitVector& bits) {
+    std::vector<std::size_t> set;
+    bits.ForEach([&](std::size_t bit) { set.push_back(bit); });
+    return set;
+}
+
+std::vector<std::size_t> Indices(const std::vector<const Value*>& values) {
+    std::vector<std::size_t> indices;
+    for (const Value* value : values) {
+        indices.push_back(value->GetIndex());
+    }
+    std::sort(indices.begin(), indices.end());
+    return indices;
+}
+
+}  // namespace
+
+TEST_CASE("Liveness over a loop", "[dataflow]") {
+    LoopFunction f;
+    Liveness liveness(f.function);
+    REQUIRE(!liveness.GetLiveIn(f.entry).Any());
+    REQUIRE(Bits(liveness.GetLiveOut(f.entry)) == Indices({f.x, f.y}));
+    REQUIRE(Bits(liveness.GetLiveIn(f.head)) == Indices({f.x, f.y}));
+    REQUIRE(Bits(liveness.GetLiveOut(f.head)) == Indices({f.x, f.y, f.t}));
+    REQUIRE(Bits(liveness.GetLiveIn(f.body)) == Indices({f.x, f.y}));
+    REQUIRE(Bits(liveness.GetLiveIn(f.exit)) == Indices({f.y, f.t}));
+    REQUIRE(!liveness.IsLiveOut(f.z, f.exit));
+    REQUIRE(liveness.IsLiveOut(f.x, f.body));
+}
+
+TEST_CASE("Liveness of phi operands", "[dataflow]") {
+    Module module;
+    const Type* i32 = module.Types()->GetInt32();
+    Function* function = module.AddFunction("f", module.Types()->MakeFunctionType());
+    BasicBlock* entry = function->CreateBlock("entry");
+    BasicBlock* left = function->CreateBlock("left");
+    BasicBlock* right = function->CreateBlock("right");
+    BasicBlock* join = function->CreateBlock("join");
+    const Variable* a = function->AllocateVariable(Variable::Metadata("a", i32));
+    const Variable* b = function->AllocateVariable(Variable::Metadata("b", i32));
+    const Variable* p = function->AllocateVariable(Variable::Metadata("p", i32));
+    const Value* c = function->Constants()->GetInteger(1, cast<IntTypeBase>(i32));
+    const Value* condition =
+        function->Constants()->GetInteger(1, cast<IntTypeBase>(module.Types()->GetInt1()));
+
+    entry->Append(function->MakeOperation<BinaryOperation>(function, BinOp::ADD, c, c, a));
+    entry->Append(
+        function->MakeOperation<ConditionalBranchOperation>(function, condition, left, right));
+    left->Append(function->MakeOperation<BranchOperation>(function, join));
+    right->Append(function->MakeOperation<BinaryOperation>(function, BinOp::ADD, c, c, b));
+    right->Append(function->MakeOperation<BranchOperation>(function, join));
+    join->Append(function->MakeOperation<PhiOp>(function, p, join->Predecessors(),
+                                                std::vector<const Value*>{a, b}));
+
+    Liveness liveness(function);
+    REQUIRE(Bits(liveness.GetLiveOut(left)) == Indices({a}));
+    REQUIRE(Bits(liveness.GetLiveOut(right)) == Indices({b}));
+    REQUIRE(Bits(liveness.GetLiveIn(left)) == Indices({a}));
+    REQUIRE(!liveness.GetLiveIn(right).Any());
+    REQUIRE(!liveness.GetLiveIn(join).Any());
+    REQUIRE(!liveness.GetLiveIn(entry).Any());
+
+    // Retargeting phi entries is an edit of the function like any other
+    auto* phi = static_cast<PhiOp*>(*join->GetOperations().begin());
+    const auto version = function->GetVersion();
+    phi->SetIncomingBlock(0, right);
+    phi->SetIncomingBlock(1, left);
+    REQUIRE(function->GetVersion() != version);
+    Liveness swapped(function);
+    REQUIRE(Bits(swapped.GetLiveOut(left)) == Indices({b}));
+    REQUIRE(Bits(swapped.GetLiveOut(right)) == Indices({a}));
+}
+
+TEST_CASE("Reaching definitions over a loop", "[dataflow]") {
+    LoopFunction f;
+    ReachingDefinitions reaching(f.function);
+    using Definitions = std::vector<const Operation*>;
+    REQUIRE(reaching.GetReaching(f.x, f.entry).empty());
+    REQUIRE(reaching.GetReaching(f.x, f.head) == Definitions{f.x_init, f.x_next});
+    REQUIRE(reaching.GetReaching(f.x, f.exit) == Definitions{f.x_init, f.x_next});
+    REQUIRE(reaching.GetReaching(f.y, f.body) == Definitions{f.y_def});
+    REQUIRE(reaching.GetReaching(f.t, f.head) == Definitions{f.t_def});
+    REQUIRE(!reaching.GetReachingOut(f.body).Test(f.x_init->GetIndex()));
+}
+
+TEST_CASE("Available expressions over a loop", "[dataflow]") {
+    LoopFunction f;
+    AvailableExpressions available(f.function);
+    REQUIRE(!available.GetAvailableIn(f.entry).Any());
+    // c + c uses no variables and is never killed
+    REQUIRE(available.IsAvailable(f.x_init, f.head));
+    REQUIRE(available.IsAvailable(f.x_init, f.exit));
+    // x + x is killed on the back edge
+    REQUIRE(!available.IsAvailable(f.y_def, f.head));
+    REQUIRE(!available.IsAvailable(f.x_next, f.body));
+    REQUIRE(available.IsAvailable(f.t_def, f.exit));
+    REQUIRE(available.IsAvailable(f.t_def, f.body));
+    REQUIRE(!available.IsAvailable(f.z_def, f.exit));
+}
+
+TEST_CASE("Dataflow scales to many variables", "[dataflow]") {
+    // A chain of loops, each using the variables defined by the previous one
+    constexpr int kLoops = 500;
+    constexpr int kVariablesPerLoop = 60;
+    Module module;
+    const Type* i32 = module.Types()->GetInt32();
+    Function* function = module.AddFunction("f", module.Types()->MakeFunctionType());
+    const Value* c = function->Constants()->GetInteger(1, cast<IntTypeBase>(i32));
+    const Value* condition =
+        function->Constants()->GetInteger(1, cast<IntTypeBase>(module.Types()->GetInt1()));
+    std::vector<const Variable*> previous;
+    BasicBlock* block = function->CreateBlock();
+    for (int loop = 0; loop < kLoops; ++loop) {
+        std::vector<const Variable*> current;
+        for (int i = 0; i < kVariablesPerLoop; ++i) {
+            const Variable* variable = function->AllocateVariable(
+                Variable::Metadata("v" + std::to_string(loop) + "_" + std::to_string(i), i32));
+            const Value* operand = previous.empty() ? c : previous[i];
+            block->Append(function->MakeOperation<BinaryOperation>(function, BinOp::ADD,
+                                                                   operand, c, variable));
+            current.push_back(variable);
+        }
+        BasicBlock* next = function->CreateBlock();
+        block->Append(
+            function->MakeOperation<ConditionalBranchOperation>(function, condition, block, next));
+        block = next;
+        previous = std::move(current);
+    }
+    REQUIRE(function->ValueIndexBound() >= kLoops * kVariablesPerLoop);
+
+    DataflowSolver<LivenessProblem> liveness(function, LivenessProblem(function));
+    // Every block is visited a constant number of times
+    REQUIRE(liveness.GetVisits() <= 3 * (kLoops + 1));
+    REQUIRE(liveness.GetBlockEntry(function->GetEntryBlock()).Count() == 0);
+    DataflowSolver<AvailableExpressionsProblem> available(function,
+                                                          AvailableExpressionsProblem(function));
+    REQUIRE(available.GetVisits() <= 3 * (kLoops + 1));
+}
+
+}  // namespace bier_tests
@@ -0,0 +1,278 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/analysis/dominator_tree.h>
+#include <bier/core/module.h>
+#include <bier/operations/branch.h>
+#include <random>
+#include <set>
+#include <thread>
+
+using namespace bier;
+
+namespace bier_tests {
+
+namespace {
+
+class CfgBuilder {
+public:
+    CfgBuilder() : function_(module_.AddFunction("f", module_.Types()->MakeFunctionType())) {
+        condition_ = function_->Constants()->GetInteger(
+            1, cast<IntTypeBase>(module_.Types()->GetInt1()));
+    }
+
+    Function* GetFunction() {
+        return function_;
+    }
+    BasicBlock* CreateBlock() {
+        return function_->CreateBlock("b" + std::to_string(blocks_++));
+    }
+    void Branch(BasicBlock* from, BasicBlock* to) {
+        from->Append(function_->MakeOperation<BranchOperation>(function_, to));
+    }
+    void Branch(BasicBlock* from, BasicBlock* left, BasicBlock* right) {
+        from->Append(function_->MakeOperation<ConditionalBranchOperation>(function_, condition_,
+                                                                          left, right));
+    }
+    void RemoveBranch(BasicBlock* from) {
+        from->Remove(from->GetOperations().begin());
+    }
+
+private:
+    Module module_;
+    Function* function_;
+    const Value* condition_;
+    int blocks_ = 0;
+};
+
+// Blocks reachable from the roots of the analysed graph avoiding removed
+template <bool IsPostDom>
+std::set<const BasicBlock*> Reached(const Function* function, const BasicBlock* removed) {
+    std::vector<const BasicBlock*> stack;
+    for (const BasicBlock* block : function->GetBlocks()) {
+        const bool is_root =
+            IsPostDom ? block->Successors().empty() : block == function->GetEntryBlock();
+        if (is_root && block != removed) {
+            stack.push_back(block);
+        }
+    }
+    std::set<const BasicBlock*> reached(stack.begin(), stack.end());
+    while (!stack.empty()) {
+        const BasicBlock* block = stack.back();
+        stack.pop_back();
+        for (const BasicBlock* next : IsPostDom ? block->Predecessors() : block->Successors()) {
+            if (next != removed && reached.insert(next).second) {
+                stack.push_back(next);
+            }
+        }
+    }
+    return reached;
+}
+
+// Dominance by definition: every path from the roots to a reachable b passes through a
+template <bool IsPostDom>
+bool NaiveDominates(const Function* function, const BasicBlock* a, const BasicBlock* b) {
+    return a == b || !Reached<IsPostDom>(function, a).count(b);
+}
+
+template <bool IsPostDom>
+void CheckTree(const Function* function, const DominatorTreeBase<IsPostDom>& tree) {
+    for (const BasicBlock* b : function->GetBlocks()) {
+        const bool reachable = Reached<IsPostDom>(function, nullptr).count(b);
+        REQUIRE(tree.IsReachable(b) == reachable);
+        const BasicBlock* idom = nullptr;
+        std::size_t idom_depth = 0;
+        for (const BasicBlock* a : function->GetBlocks()) {
+            const bool dominates =
+                a == b || (reachable && NaiveDominates<IsPostDom>(function, a, b));
+            REQUIRE(tree.Dominates(a, b) == dominates);
+            if (!dominates || a == b) {
+                continue;
+            }
+            // The immediate dominator is the strict dominator with the most dominators
+            std::size_t depth = 0;
+            for (const BasicBlock* c : function->GetBlocks()) {
+                depth += c != a && NaiveDominates<IsPostDom>(function, c, a);
+            }
+            if (idom == nullptr || depth > idom_depth) {
+                idom = a;
+                idom_depth = depth;
+            }
+        }
+        REQUIRE(tree.GetIDom(b) == idom);
+    }
+}
+
+template <bool IsPostDom>
+void RandomizedCheck(std::uint32_t seed) {
+    std::mt19937 random(seed);
+    CfgBuilder builder;
+    const int size = 2 + random() % 10;
+    std::vector<BasicBlock*> blocks;
+    for (int i = 0; i < size; ++i) {
+        blocks.push_back(builder.CreateBlock());
+    }
+    auto any_block = [&]() { return blocks[random() % blocks.size()]; };
+    for (auto* block : blocks) {
+        switch (random() % 4) {
+            case 0:
+                break;
+            case 1:
+                builder.Branch(block, any_block(), any_block());
+                break;
+            default:
+                builder.Branch(block, any_block());
+        }
+    }
+    const Function* function = builder.GetFunction();
+    DominatorTreeBase<IsPostDom> tree(function);
+    CheckTree(function, tree);
+
+    for (int step = 0; step < 20; ++step) {
+        BasicBlock* block = any_block();
+        if (block->Successors().empty()) {
+            BasicBlock* to = any_block();
+            builder.Branch(block, to);
+            tree.InsertEdge(block, to);
+        } else if (block->Successors().size() == 1) {
+            BasicBlock* to = block->Successors().front();
+            builder.RemoveBranch(block);
+            tree.DeleteEdge(block, to);
+        } else {
+            continue;
+        }
+        CheckTree(function, tree);
+    }
+}
+
+}  // namespace
+
+TEST_CASE("Dominator tree of a diamond", "[dominator_tree]") {
+    CfgBuilder builder;
+    BasicBlock* entry = builder.CreateBlock();
+    BasicBlock* left = builder.CreateBlock();
+    BasicBlock* right = builder.CreateBlock();
+    BasicBlock* exit = builder.CreateBlock();
+    builder.Branch(entry, left, right);
+    builder.Branch(left, exit);
+    builder.Branch(right, exit);
+
+    DominatorTree tree(builder.GetFunction());
+    REQUIRE(tree.GetRoots() == std::vector<const BasicBlock*>{entry});
+    REQUIRE(tree.GetIDom(entry) == nullptr);
+    REQUIRE(tree.GetIDom(exit) == entry);
+    REQUIRE(tree.GetChildren(entry).size() == 3);
+    REQUIRE(tree.StrictlyDominates(entry, exit));
+    REQUIRE_FALSE(tree.Dominates(left, exit));
+    REQUIRE(tree.FindNearestCommonDominator(left, right) == entry);
+
+    PostDominatorTree post_tree(builder.GetFunction());
+    REQUIRE(post_tree.GetRoots() == std::vector<const BasicBlock*>{exit});
+    REQUIRE(post_tree.GetIDom(entry) == exit);
+    REQUIRE(post_tree.Dominates(exit, left));
+    REQUIRE_FALSE(post_tree.Dominates(left, entry));
+
+    builder.RemoveBranch(right);
+    tree.DeleteEdge(right, exit);
+    post_tree.DeleteEdge(right, exit);
+    REQUIRE(tree.GetIDom(exit) == left);
+    REQUIRE(post_tree.GetRoots().size() == 3);
+    REQUIRE(post_tree.GetIDom(entry) == nullptr);
+    REQUIRE(post_tree.GetIDom(left) == exit);
+}
+
+TEST_CASE("Dominator trees match the definition on random CFGs", "[dominator_tree]") {
+    for (std::uint32_t seed = 0; seed < 200; ++seed) {
+        INFO("seed " << seed);
+        RandomizedCheck<false>(seed);
+        RandomizedCheck<true>(seed);
+    }
+}
+
+TEST_CASE("Dominator trees scale to large functions", "[dominator_tree]") {
+    // A chain of loops with diamonds: head -> (left | right), right -> (join | head)
+    constexpr int kLoops = 25000;
+    CfgBuilder builder;
+    std::vector<BasicBlock*> heads;
+    std::vector<BasicBlock*> lefts;
+    std::vector<BasicBlock*> joins;
+    for (int i = 0; i < kLoops; ++i) {
+        heads.push_back(builder.CreateBlock());
+        lefts.push_back(builder.CreateBlock());
+        BasicBlock* right = builder.CreateBlock();
+        joins.push_back(builder.CreateBlock());
+        builder.Branch(heads.back(), lefts.back(), right);
+        builder.Branch(lefts.back(), joins.back());
+        builder.Branch(right, joins.back(), heads.back());
+        if (i > 0) {
+            builder.Branch(joins[i - 1], heads.back());
+        }
+    }
+    REQUIRE(builder.GetFunction()->BlockIndexBound() == 4 * kLoops);
+
+    DominatorTree tree(builder.GetFunction());
+    PostDominatorTree post_tree(builder.GetFunction());
+    for (int i = 0; i < kLoops; ++i) {
+        REQUIRE(tree.GetIDom(joins[i]) == heads[i]);
+        REQUIRE(post_tree.GetIDom(heads[i]) == joins[i]);
+    }
+    REQUIRE(tree.Dominates(heads.front(), joins.back()));
+    REQUIRE(post_tree.Dominates(joins.back(), heads.front()));
+    REQUIRE_FALSE(tree.Dominates(joins.back(), heads.front()));
+
+    for (int i = 0; i < kLoops; i += kLoops / 50) {
+        builder.RemoveBranch(lefts[i]);
+        tree.DeleteEdge(lefts[i], joins[i]);
+        REQUIRE(tree.GetIDom(joins[i]) != heads[i]);
+        REQUIRE(tree.Dominates(heads[i], joins.back()));
+        builder.Branch(lefts[i], joins[i]);
+        tree.InsertEdge(lefts[i], joins[i]);
+        REQUIRE(tree.GetIDom(joins[i]) == heads[i]);
+    }
+}
+
+TEST_CASE("Concurrent queries share the lazy renumbering", "[dominator_tree]") {
+    constexpr int kBlocks = 2000;
+    CfgBuilder builder;
+    std::vector<BasicBlock*> blocks;
+    for (int i = 0; i < kBlocks; ++i) {
+        blocks.push_back(builder.CreateBlock());
+    }
+    for (int i = 0; i + 1 < kBlocks; ++i) {
+        builder.Branch(blocks[i], blocks[i + 1]);
+    }
+    DominatorTree tree(builder.GetFunction());
+
+    // Every thread starts on the slow path and races to renumber
+    std::vector<std::thread> threads;
+    std::vector<int> mismatches(4, 0);
+    for (std::size_t t = 0; t < mismatches.size(); ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i + 1 < kBlocks; ++i) {
+                mismatches[t] += !tree.Dominates(blocks[i], blocks.back());
+                mismatches[t] += tree.Dominates(blocks.back(), blocks[i]);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (int count : mismatches) {
+        REQUIRE(count == 0);
+    }
+}
+
+}  // namespace bier_tests
@@ -0,0 +1,89 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/analysis/analysis_manager.h>
+#include <bier/analysis/live_intervals.h>
+#include "loop_function.h"
+
+using namespace bier;
+
+namespace bier_tests {
+
+namespace {
+
+std::vector<std::pair<std::uint32_t, std::uint32_t>> RangesOf(const LiveInterval& interval) {
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> ranges;
+    for (const auto& range : interval.GetRanges()) {
+        ranges.emplace_back(range.start, range.end);
+    }
+    return ranges;
+}
+
+}  // namespace
+
+TEST_CASE("Live intervals over a loop", "[live_intervals]") {
+    using Ranges = std::vector<std::pair<std::uint32_t, std::uint32_t>>;
+    LoopFunction f;
+    LiveIntervals intervals(f.function);
+    REQUIRE(intervals.GetPosition(f.x_init) == 0);
+    REQUIRE(intervals.GetPosition(f.t_def) == 3);
+    REQUIRE(intervals.GetPosition(f.z_def) == 7);
+    REQUIRE(intervals.GetBlockRange(f.body).start == 5);
+    REQUIRE(intervals.GetBlockRange(f.body).end == 7);
+
+    // Live around the loop, but not in the exit
+    REQUIRE(RangesOf(intervals.GetInterval(f.x)) == Ranges{{0, 7}});
+    REQUIRE(RangesOf(intervals.GetInterval(f.y)) == Ranges{{1, 8}});
+    // Not live in the body, defined again at the loop head
+    REQUIRE(RangesOf(intervals.GetInterval(f.t)) == Ranges{{3, 5}, {7, 8}});
+    REQUIRE(RangesOf(intervals.GetInterval(f.z)) == Ranges{{7, 8}});
+
+    const LiveInterval& t = intervals.GetInterval(f.t);
+    REQUIRE(t.IsLiveAt(4));
+    REQUIRE(!t.IsLiveAt(5));
+    REQUIRE(t.IsLiveAt(7));
+    REQUIRE(t.Overlaps(intervals.GetInterval(f.z)));
+    REQUIRE(!intervals.GetInterval(f.x).Overlaps(intervals.GetInterval(f.z)));
+    REQUIRE(intervals.GetMaxPressure() == 3);
+    REQUIRE(intervals.GetLiveness().IsLiveIn(f.t, f.exit));
+}
+
+TEST_CASE("Live intervals are cached until the function changes", "[live_intervals]") {
+    LoopFunction f;
+    AnalysisManager manager;
+    auto first = manager.GetResult<LiveIntervals>(f.function);
+    REQUIRE(manager.GetResult<LiveIntervals>(f.function) == first);
+
+    const Variable* w = f.function->AllocateVariable(
+        Variable::Metadata("w", f.module.Types()->GetInt32()));
+    auto second = manager.GetResult<LiveIntervals>(f.function);
+    REQUIRE(second != first);
+    // Results handed out earlier stay usable
+    REQUIRE(first->GetInterval(f.t).End() == 8);
+
+    f.exit->Append(f.function->MakeOperation<BinaryOperation>(
+        f.function, BinaryOperation::BinOp::ADD, f.z, f.x, w));
+    auto third = manager.GetResult<LiveIntervals>(f.function);
+    REQUIRE(third != second);
+    REQUIRE(third->GetInterval(f.x).End() == 9);
+
+    const auto version = f.function->GetVersion();
+    const_cast<Operation*>(f.z_def)->SetOperand(0, f.y);
+    REQUIRE(f.function->GetVersion() != version);
+    REQUIRE(manager.GetResult<LiveIntervals>(f.function)->GetInterval(f.t).GetRanges().size() == 1);
+}
+
+}  // namespace bier_tests
@@ -0,0 +1,82 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+#include <bier/core/module.h>
+#include <bier/operations/branch.h>
+
+namespace bier_tests {
+
+class LoopFunction {
+public:
+    using BinOp = bier::BinaryOperation::BinOp;
+
+    // entry: x = c + c; y = x + x; br head
+    // head:  t = x + y; br cond body, exit
+    // body:  x = x + x; br head
+    // exit:  z = t + y
+    LoopFunction() {
+        const bier::Type* i32 = module.Types()->GetInt32();
+        function = module.AddFunction("f", module.Types()->MakeFunctionType());
+        entry = function->CreateBlock("entry");
+        head = function->CreateBlock("head");
+        body = function->CreateBlock("body");
+        exit = function->CreateBlock("exit");
+        x = function->AllocateVariable(bier::Variable::Metadata("x", i32));
+        y = function->AllocateVariable(bier::Variable::Metadata("y", i32));
+        t = function->AllocateVariable(bier::Variable::Metadata("t", i32));
+        z = function->AllocateVariable(bier::Variable::Metadata("z", i32));
+        const bier::Value* c =
+            function->Constants()->GetInteger(1, bier::cast<bier::IntTypeBase>(i32));
+        const bier::Value* condition = function->Constants()->GetInteger(
+            1, bier::cast<bier::IntTypeBase>(module.Types()->GetInt1()));
+
+        x_init = Append(entry, BinOp::ADD, c, c, x);
+        y_def = Append(entry, BinOp::ADD, x, x, y);
+        entry->Append(function->MakeOperation<bier::BranchOperation>(function, head));
+        t_def = Append(head, BinOp::ADD, x, y, t);
+        head->Append(function->MakeOperation<bier::ConditionalBranchOperation>(
+            function, condition, body, exit));
+        x_next = Append(body, BinOp::ADD, x, x, x);
+        body->Append(function->MakeOperation<bier::BranchOperation>(function, head));
+        z_def = Append(exit, BinOp::ADD, t, y, z);
+    }
+
+    bier::Module module;
+    bier::Function* function;
+    bier::BasicBlock* entry;
+    bier::BasicBlock* head;
+    bier::BasicBlock* body;
+    bier::BasicBlock* exit;
+    const bier::Variable* x;
+    const bier::Variable* y;
+    const bier::Variable* t;
+    const bier::Variable* z;
+    const bier::Operation* x_init;
+    const bier::Operation* y_def;
+    const bier::Operation* t_def;
+    const bier::Operation* x_next;
+    const bier::Operation* z_def;
+
+private:
+    const bier::Operation* Append(bier::BasicBlock* block, BinOp op, const bier::Value* left,
+                                  const bier::Value* right, const bier::Variable* result) {
+        block->Append(
+            function->MakeOperation<bier::BinaryOperation>(function, op, left, right, result));
+        return *std::prev(block->GetOperations().end());
+    }
+};
+
+}  // namespace bier_tests
@@ -0,0 +1,149 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/analysis/loop_info.h>
+#include <bier/builder/module_builder.h>
+#include <bier/operations/branch.h>
+#include <bier/pass/ssa_construction_pass.h>
+
+using namespace bier;
+
+namespace bier_tests {
+
+namespace {
+
+using Blocks = std::vector<const BasicBlock*>;
+
+void Branch(Function* function, BasicBlock* from, BasicBlock* to) {
+    from->Append(function->MakeOperation<BranchOperation>(function, to));
+}
+
+void Branch(Function* function, const Value* condition, BasicBlock* from, BasicBlock* left,
+            BasicBlock* right) {
+    from->Append(
+        function->MakeOperation<ConditionalBranchOperation>(function, condition, left, right));
+}
+
+}  // namespace
+
+TEST_CASE("Nested natural loops", "[loop_info]") {
+    Module module;
+    Function* function = module.AddFunction("f", module.Types()->MakeFunctionType());
+    BasicBlock* entry = function->CreateBlock("entry");
+    BasicBlock* outer = function->CreateBlock("outer");
+    BasicBlock* preheader = function->CreateBlock("preheader");
+    BasicBlock* inner = function->CreateBlock("inner");
+    BasicBlock* inner_body = function->CreateBlock("inner_body");
+    BasicBlock* latch = function->CreateBlock("latch");
+    BasicBlock* exit = function->CreateBlock("exit");
+    BasicBlock* dead = function->CreateBlock("dead");
+    const Value* condition =
+        function->Constants()->GetInteger(1, cast<IntTypeBase>(module.Types()->GetInt1()));
+    Branch(function, entry, outer);
+    Branch(function, condition, outer, preheader, exit);
+    Branch(function, preheader, inner);
+    Branch(function, condition, inner, inner_body, latch);
+    Branch(function, condition, inner_body, inner, exit);
+    Branch(function, latch, outer);
+    Branch(function, dead, inner);
+
+    LoopInfo loops(function);
+    REQUIRE(loops.GetLoopCount() == 2);
+    REQUIRE(loops.GetTopLevelLoops().size() == 1);
+    const Loop* outer_loop = loops.GetTopLevelLoops().front();
+    REQUIRE(outer_loop->GetSubLoops().size() == 1);
+    const Loop* inner_loop = outer_loop->GetSubLoops().front();
+    REQUIRE(inner_loop->GetParent() == outer_loop);
+
+    REQUIRE(outer_loop->GetHeader() == outer);
+    REQUIRE(outer_loop->GetBlocks() == Blocks{outer, preheader, inner, latch, inner_body});
+    REQUIRE(outer_loop->GetPreheader() == entry);
+    REQUIRE(outer_loop->GetLatches() == Blocks{latch});
+    REQUIRE(outer_loop->GetExitBlocks() == Blocks{exit});
+    REQUIRE(outer_loop->GetExitingBlocks() == Blocks{outer, inner_body});
+
+    REQUIRE(inner_loop->GetBlocks() == Blocks{inner, inner_body});
+    REQUIRE(inner_loop->GetDepth() == 2);
+    REQUIRE(inner_loop->GetLatches() == Blocks{inner_body});
+    // The unreachable predecessor is not a loop block, but rules out a preheader
+    REQUIRE(inner_loop->GetPreheader() == nullptr);
+    REQUIRE(inner_loop->GetExitBlocks() == Blocks{latch, exit});
+    REQUIRE(outer_loop->Contains(inner_loop));
+    REQUIRE(!inner_loop->Contains(outer_loop));
+    REQUIRE(!inner_loop->Contains(latch));
+
+    REQUIRE(loops.GetLoopFor(inner_body) == inner_loop);
+    REQUIRE(loops.GetLoopFor(latch) == outer_loop);
+    REQUIRE(loops.GetLoopFor(exit) == nullptr);
+    REQUIRE(loops.GetLoopFor(dead) == nullptr);
+    REQUIRE(loops.GetLoopDepth(inner) == 2);
+    REQUIRE(loops.IsLoopHeader(inner));
+    REQUIRE(!loops.IsLoopHeader(inner_body));
+}
+
+TEST_CASE("Trip count candidates of counting loops", "[loop_info]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = builder.CreateFunction("sum", i64, {i64});
+    ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+    n->SetName("n");
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    BasicBlock* header = builder.CreateBlock(function, "header");
+    BasicBlock* body = builder.CreateBlock(function, "body");
+    BasicBlock* exit = builder.CreateBlock(function, "exit");
+
+    builder.AttachTo(entry);
+    const Variable* i = builder.CreateAssign(builder.CreateInt64Const(0), "i", true);
+    const Variable* sum = builder.CreateAssign(builder.CreateInt64Const(0), "sum", true);
+    builder.CreateBranch(header);
+    builder.AttachTo(header);
+    builder.CreateConditionBranch(builder.CreateSLT(i, n), body, exit);
+    builder.AttachTo(body);
+    builder.CreateAdd(sum, i, "sum", true);
+    builder.CreateAdd(i, builder.CreateInt64Const(1), "i", true);
+    builder.CreateBranch(header);
+    builder.AttachTo(exit);
+    builder.CreateReturnValue(sum);
+
+    auto check_candidate = [&](const LoopInfo& loops) {
+        REQUIRE(loops.GetLoopCount() == 1);
+        const Loop* loop = loops.GetLoopFor(body);
+        REQUIRE(loop->GetHeader() == header);
+        REQUIRE(loop->GetPreheader() == entry);
+        REQUIRE(loop->GetTripCountCandidates().size() == 1);
+        const TripCountCandidate& candidate = loop->GetTripCountCandidates().front();
+        REQUIRE(candidate.exiting_block == header);
+        REQUIRE(candidate.bound == n);
+        REQUIRE(candidate.step_op == BinaryOperation::BinOp::ADD);
+        REQUIRE(cast<IntegerConst>(candidate.step)->GetValue() == 1);
+        return candidate.induction;
+    };
+
+    SECTION("Mutable variables") {
+        REQUIRE(check_candidate(LoopInfo(function)) == i);
+    }
+
+    SECTION("SSA form") {
+        SSAConstructionPass pass;
+        pass.Apply(std::move(module));
+        module = pass.GetTransformed();
+        const Variable* induction = check_candidate(LoopInfo(function));
+        REQUIRE(induction->GetDefiningOp()->OpCode() == OpCodes::PHI_OP);
+    }
+}
+
+}  // namespace bier_tests
@@ -0,0 +1,37 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include "synthetic_module.h"
+#include <bier/analysis/live_intervals.h>
+
+using namespace bier;
+
+namespace bier_tests {
+
+TEST_CASE("Live intervals of a 50k functions module", "[benchmark][analysis]") {
+    const SyntheticLoopsParams params{50000, 4};
+    ModulePtr module = BuildSyntheticLoopsModule(params);
+
+    BENCHMARK("live intervals") {
+        std::uint32_t pressure = 0;
+        for (const auto& [signature, function] : module->GetDefinedFunctions()) {
+            pressure = std::max(pressure, LiveIntervals(function.get()).GetMaxPressure());
+        }
+        return pressure;
+    };
+}
+
+}  // namespace bier_tests
@@ -0,0 +1,39 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include "synthetic_module.h"
+
+using namespace bier;
+
+namespace bier_tests {
+
+TEST_CASE("Build and destroy 1M operations module", "[benchmark][build]") {
+    const SyntheticModuleParams params{1000, 1000};
+
+    BENCHMARK("build") {
+        return BuildSyntheticModule(params);
+    };
+
+    BENCHMARK_ADVANCED("teardown")(Catch::Benchmark::Chronometer meter) {
+        std::vector<ModulePtr> modules;
+        for (int i = 0; i < meter.runs(); ++i) {
+            modules.emplace_back(BuildSyntheticModule(params));
+        }
+        meter.measure([&](int i) { modules[i].reset(); });
+    };
+}
+
+}  // namespace bier_tests
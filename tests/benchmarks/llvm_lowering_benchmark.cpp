@@ -0,0 +1,59 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include "synthetic_module.h"
+#include <bier/llvm/llvm_pass.h>
+#include <bier/pass/ssa_construction_pass.h>
+#include <bier/pass/ssa_pass.h>
+#include <memory>
+
+using namespace bier;
+
+namespace bier_tests {
+
+namespace {
+
+template <typename TSSAPass>
+void BenchmarkLowering(const SyntheticLoopsParams& params, Catch::Benchmark::Chronometer meter) {
+    std::vector<ModulePtr> modules;
+    std::vector<std::unique_ptr<llvm::LLVMContext>> contexts;
+    std::vector<std::unique_ptr<llvm::Module>> llvm_modules;
+    for (int i = 0; i < meter.runs(); ++i) {
+        modules.emplace_back(RunPass<TSSAPass>(BuildSyntheticLoopsModule(params)));
+        contexts.emplace_back(std::make_unique<llvm::LLVMContext>());
+        llvm_modules.emplace_back(std::make_unique<llvm::Module>("synthetic", *contexts.back()));
+    }
+    meter.measure([&](int i) {
+        BuildLLVMIRPass pass(contexts[i].get(), llvm_modules[i].get());
+        pass.Apply(std::move(modules[i]));
+    });
+}
+
+}  // namespace
+
+TEST_CASE("LLVM lowering of memory based SSA against phis", "[benchmark][ssa][llvm]") {
+    const SyntheticLoopsParams params{1000, 50};
+
+    BENCHMARK_ADVANCED("lowering after alloc/load/store")(Catch::Benchmark::Chronometer meter) {
+        BenchmarkLowering<SSAPass>(params, meter);
+    };
+
+    BENCHMARK_ADVANCED("lowering after phi construction")(Catch::Benchmark::Chronometer meter) {
+        BenchmarkLowering<SSAConstructionPass>(params, meter);
+    };
+}
+
+}  // namespace bier_tests
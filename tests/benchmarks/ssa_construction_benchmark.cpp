@@ -0,0 +1,73 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include "synthetic_module.h"
+#include <bier/pass/ssa_construction_pass.h>
+#include <bier/pass/ssa_pass.h>
+#include <bier/pass/thread_pool.h>
+
+using namespace bier;
+
+namespace bier_tests {
+
+TEST_CASE("Memory based SSA against phi construction", "[benchmark][ssa]") {
+    const SyntheticLoopsParams params{1000, 50};
+
+    const std::size_t memory_ops =
+        RunPass<SSAPass>(BuildSyntheticLoopsModule(params))->CountOperations();
+    const std::size_t phi_ops =
+        RunPass<SSAConstructionPass>(BuildSyntheticLoopsModule(params))->CountOperations();
+    WARN("operations after SSAPass: " << memory_ops << ", after SSAConstructionPass: " << phi_ops);
+    CHECK(phi_ops < memory_ops);
+
+    BENCHMARK_ADVANCED("alloc/load/store")(Catch::Benchmark::Chronometer meter) {
+        std::vector<ModulePtr> modules;
+        for (int i = 0; i < meter.runs(); ++i) {
+            modules.emplace_back(BuildSyntheticLoopsModule(params));
+        }
+        meter.measure([&](int i) { modules[i] = RunPass<SSAPass>(std::move(modules[i])); });
+    };
+
+    BENCHMARK_ADVANCED("phi construction")(Catch::Benchmark::Chronometer meter) {
+        std::vector<ModulePtr> modules;
+        for (int i = 0; i < meter.runs(); ++i) {
+            modules.emplace_back(BuildSyntheticLoopsModule(params));
+        }
+        meter.measure(
+            [&](int i) { modules[i] = RunPass<SSAConstructionPass>(std::move(modules[i])); });
+    };
+}
+
+TEST_CASE("Parallel function passes", "[benchmark][ssa][parallel]") {
+    const SyntheticLoopsParams params{100000, 5};
+    for (std::size_t threads : {std::size_t(1), ThreadPool::DefaultThreadCount()}) {
+        ThreadPool pool(threads);
+        BENCHMARK_ADVANCED("ssa-memory,ssa on " + std::to_string(threads) + " threads")(
+            Catch::Benchmark::Chronometer meter) {
+            std::vector<ModulePtr> modules;
+            for (int i = 0; i < meter.runs(); ++i) {
+                modules.emplace_back(BuildSyntheticLoopsModule(params));
+            }
+            meter.measure([&](int i) {
+                PassManager manager("ssa-memory,ssa");
+                manager.SetThreadPool(&pool);
+                modules[i] = manager.Run(std::move(modules[i]));
+            });
+        };
+    }
+}
+
+}  // namespace bier_tests
@@ -0,0 +1,74 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "synthetic_module.h"
+#include <bier/builder/module_builder.h>
+
+using namespace bier;
+
+namespace bier_tests {
+
+ModulePtr BuildSyntheticModule(const SyntheticModuleParams& params) {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    for (int i = 0; i < params.functions; ++i) {
+        Function* function = builder.CreateFunction("f" + std::to_string(i), i64, {i64});
+        ArgumentValue* argument = *function->GetSignature()->Arguments().begin();
+        argument->SetName("x");
+        builder.CreateBlock(function, "entry");
+        const Value* value = argument;
+        // The return takes one operation
+        for (int j = 1; j < params.operations_per_function; ++j) {
+            value = builder.CreateAdd(value, builder.CreateInt64Const(j));
+        }
+        builder.CreateReturnValue(value);
+    }
+    return module;
+}
+
+ModulePtr BuildSyntheticLoopsModule(const SyntheticLoopsParams& params) {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    for (int i = 0; i < params.functions; ++i) {
+        Function* function = builder.CreateFunction("f" + std::to_string(i), i64, {i64});
+        ArgumentValue* argument = *function->GetSignature()->Arguments().begin();
+        argument->SetName("x");
+        builder.CreateBlock(function, "entry");
+        const Variable* acc = builder.CreateAssign(argument, "acc", true);
+        for (int j = 0; j < params.loops_per_function; ++j) {
+            BasicBlock* preheader = builder.CurrentBlock();
+            BasicBlock* header = builder.CreateBlock(function, "header", preheader);
+            BasicBlock* body = builder.CreateBlock(function, "body", header);
+            BasicBlock* exit = builder.CreateBlock(function, "exit", body);
+
+            builder.AttachTo(preheader);
+            const Variable* counter = builder.CreateAssign(builder.CreateInt64Const(0), "i", true);
+            builder.CreateBranch(header);
+            builder.AttachTo(header);
+            builder.CreateConditionBranch(builder.CreateSLT(counter, argument), body, exit);
+            builder.AttachTo(body);
+            builder.CreateAdd(acc, counter, "acc", true);
+            builder.CreateAdd(counter, builder.CreateInt64Const(1), "i", true);
+            builder.CreateBranch(header);
+            builder.AttachTo(exit);
+        }
+        builder.CreateReturnValue(acc);
+    }
+    return module;
+}
+
+}  // namespace bier_tests
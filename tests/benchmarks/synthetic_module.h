@@ -0,0 +1,45 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+#include <bier/core/module.h>
+#include <bier/pass/pass_manager.h>
+
+namespace bier_tests {
+
+struct SyntheticModuleParams {
+    int functions = 1000;
+    int operations_per_function = 1000;
+};
+
+// Module of independent functions, each one is a single block with a chain of additions
+bier::ModulePtr BuildSyntheticModule(const SyntheticModuleParams& params);
+
+struct SyntheticLoopsParams {
+    int functions = 1000;
+    int loops_per_function = 50;
+};
+
+// Module of functions with a sequence of counting loops over mutable variables
+bier::ModulePtr BuildSyntheticLoopsModule(const SyntheticLoopsParams& params);
+
+template <typename TPass>
+bier::ModulePtr RunPass(bier::ModulePtr&& module) {
+    TPass pass;
+    pass.Apply(std::move(module));
+    return pass.GetTransformed();
+}
+
+}  // namespace bier_tests
@@ -0,0 +1,96 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/core/module.h>
+
+using namespace bier;
+
+namespace bier_tests {
+
+namespace {
+
+struct TestFunction {
+    Module module;
+    Function* function = nullptr;
+    const Type* i32 = nullptr;
+
+    TestFunction() {
+        i32 = module.Types()->GetInt32();
+        function = module.AddFunction("f", module.Types()->MakeFunctionType());
+    }
+
+    OperationPtr MakeAdd(const Value* left, const std::string& name) {
+        const Variable* result = function->AllocateVariable(Variable::Metadata(name, i32));
+        return function->MakeOperation<BinaryOperation>(function, BinaryOperation::BinOp::ADD,
+                                                        left, left, result);
+    }
+};
+
+std::vector<std::string> Results(const BasicBlock* block) {
+    std::vector<std::string> names;
+    for (const Operation* op : block->GetOperations()) {
+        names.push_back(op->GetReturnValue().value()->GetName());
+    }
+    return names;
+}
+
+}  // namespace
+
+TEST_CASE("Operations know their block", "[basic_block]") {
+    TestFunction test;
+    BasicBlock* block = test.function->CreateBlock("entry");
+    const Variable* x = test.function->AllocateVariable(Variable::Metadata("x", test.i32));
+    block->Append(test.MakeAdd(x, "a"));
+    block->Append(test.MakeAdd(x, "c"));
+    auto inserted = block->InsertAt(--block->GetOperations().end(), test.MakeAdd(x, "b"));
+    REQUIRE(inserted->GetBlock() == block);
+    REQUIRE(Results(block) == std::vector<std::string>{"a", "b", "c"});
+
+    auto next = block->DeleteAt(block->GetOperations().begin());
+    REQUIRE(next == inserted);
+    REQUIRE(Results(block) == std::vector<std::string>{"b", "c"});
+
+    OperationPtr removed = block->Remove(inserted);
+    REQUIRE(removed->GetBlock() == nullptr);
+    block->Append(std::move(removed));
+    REQUIRE(Results(block) == std::vector<std::string>{"c", "b"});
+}
+
+TEST_CASE("Move operations between blocks", "[basic_block]") {
+    TestFunction test;
+    BasicBlock* first = test.function->CreateBlock("first");
+    BasicBlock* second = test.function->CreateBlock("second");
+    const Variable* x = test.function->AllocateVariable(Variable::Metadata("x", test.i32));
+    for (const char* name : {"a", "b", "c"}) {
+        first->Append(test.MakeAdd(x, name));
+    }
+    second->Append(test.MakeAdd(x, "d"));
+
+    auto ops = first->GetOperations();
+    second->Splice(second->GetOperations().begin(), first, std::next(ops.begin()), ops.end());
+    REQUIRE(Results(first) == std::vector<std::string>{"a"});
+    REQUIRE(Results(second) == std::vector<std::string>{"b", "c", "d"});
+    for (const Operation* op : second->GetOperations()) {
+        REQUIRE(op->GetBlock() == second);
+    }
+
+    Operation* last = *--second->GetOperations().end();
+    first->Splice(first->GetOperations().begin(), second, second->GetIterator(last));
+    REQUIRE(Results(first) == std::vector<std::string>{"d", "a"});
+    REQUIRE(last->GetBlock() == first);
+}
+
+}  // namespace bier_tests
@@ -0,0 +1,52 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/core/module.h>
+
+using namespace bier;
+
+namespace bier_tests {
+
+TEST_CASE("Classify types", "[casting]") {
+    Module module;
+    auto types = module.Types();
+    REQUIRE(isa<IntTypeBase>(types->GetInt32()));
+    REQUIRE(!isa<IntTypeBase>(types->GetInt32Ptr()));
+    REQUIRE(cast<TypedPtrType>(types->GetInt32Ptr())->GetUnderlying() == types->GetInt32());
+    REQUIRE(dyn_cast<TypedPtrType>(types->GetPtr()) == nullptr);
+    REQUIRE(isa<PtrType>(types->GetPtr()));
+    REQUIRE(isa<FunctionType>(types->MakeFunctionType()));
+    REQUIRE(dyn_cast_or_null<IntTypeBase>(static_cast<const Type*>(nullptr)) == nullptr);
+}
+
+TEST_CASE("Classify values", "[casting]") {
+    Module module;
+    auto types = module.Types();
+    Function* function = module.AddFunction("f", types->MakeFunctionType());
+    function->CreateBlock("entry");
+    const Variable* x = function->AllocateVariable(Variable::Metadata("x", types->GetInt32()));
+    const Value* one = module.Constants()->GetInteger(1, cast<IntTypeBase>(types->GetInt32()));
+
+    REQUIRE(isa<Variable>(x));
+    REQUIRE(!isa<ConstValue>(x));
+    REQUIRE(isa<ConstValue>(one));
+    REQUIRE(cast<IntegerConst>(one)->GetValue() == 1);
+    REQUIRE(dyn_cast<Function>(static_cast<const Value*>(function)) == function);
+    REQUIRE(dyn_cast<FunctionSignature>(static_cast<const Value*>(function)) == nullptr);
+    REQUIRE(isa<FunctionSignature>(function->GetSignature()));
+}
+
+}  // namespace bier_tests
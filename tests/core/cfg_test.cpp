@@ -0,0 +1,100 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/core/module.h>
+#include <bier/operations/branch.h>
+
+using namespace bier;
+
+namespace bier_tests {
+
+namespace {
+
+std::vector<std::string> Labels(const std::vector<BasicBlock*>& blocks) {
+    std::vector<std::string> labels;
+    for (const BasicBlock* block : blocks) {
+        labels.push_back(block->GetLabel());
+    }
+    return labels;
+}
+
+std::vector<std::string> Labels(const Function* function) {
+    std::vector<std::string> labels;
+    for (const BasicBlock* block : function->GetBlocks()) {
+        labels.push_back(block->GetLabel());
+    }
+    return labels;
+}
+
+}  // namespace
+
+TEST_CASE("Branches maintain block edges", "[cfg]") {
+    Module module;
+    Function* function = module.AddFunction("f", module.Types()->MakeFunctionType());
+    BasicBlock* entry = function->CreateBlock("entry");
+    BasicBlock* left = function->CreateBlock("left");
+    BasicBlock* right = function->CreateBlock("right");
+    BasicBlock* exit = function->CreateBlock("exit");
+    const Value* condition = function->Constants()->GetInteger(
+        1, cast<IntTypeBase>(module.Types()->GetInt1()));
+
+    entry->Append(function->MakeOperation<ConditionalBranchOperation>(function, condition, left,
+                                                                      right));
+    left->Append(function->MakeOperation<BranchOperation>(function, exit));
+    right->Append(function->MakeOperation<BranchOperation>(function, exit));
+
+    REQUIRE(function->GetEntryBlock() == entry);
+    REQUIRE(Labels(entry->Successors()) == std::vector<std::string>{"left", "right"});
+    REQUIRE(Labels(exit->Predecessors()) == std::vector<std::string>{"left", "right"});
+    REQUIRE(Labels(left->Predecessors()) == std::vector<std::string>{"entry"});
+    REQUIRE(exit->Successors().empty());
+
+    SECTION("Retargeting a branch moves the edge") {
+        Operation* branch = *entry->GetOperations().begin();
+        branch->SetSuccessor(1, exit);
+        REQUIRE(right->Predecessors().empty());
+        REQUIRE(Labels(exit->Predecessors()) == std::vector<std::string>{"left", "right", "entry"});
+
+        function->EraseBlock(right);
+        REQUIRE(Labels(function) == std::vector<std::string>{"entry", "left", "exit"});
+        REQUIRE(Labels(exit->Predecessors()) == std::vector<std::string>{"left", "entry"});
+    }
+
+    SECTION("Removing a branch drops its edges") {
+        OperationPtr branch = left->Remove(left->GetOperations().begin());
+        REQUIRE(left->Successors().empty());
+        REQUIRE(Labels(exit->Predecessors()) == std::vector<std::string>{"right"});
+        right->Splice(right->GetOperations().begin(), left, left->GetOperations().begin(),
+                      left->GetOperations().end());
+        right->InsertAt(right->GetOperations().end(), std::move(branch));
+        REQUIRE(Labels(right->Successors()) == std::vector<std::string>{"exit", "exit"});
+    }
+
+    SECTION("Blocks still branched to are not erased") {
+        REQUIRE_THROWS_AS(function->EraseBlock(exit), IRException);
+    }
+
+    SECTION("Blocks are moved in constant time") {
+        function->MoveBlock(exit, nullptr);
+        REQUIRE(Labels(function) == std::vector<std::string>{"exit", "entry", "left", "right"});
+        function->MoveBlock(exit, right);
+        function->MoveBlock(left, right);
+        REQUIRE(Labels(function) == std::vector<std::string>{"entry", "right", "left", "exit"});
+        REQUIRE(function->GetEntryBlock() == entry);
+    }
+}
+
+}  // namespace bier_tests
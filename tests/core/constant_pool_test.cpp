@@ -0,0 +1,47 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/core/module.h>
+
+using namespace bier;
+
+namespace bier_tests {
+
+TEST_CASE("Constants are uniqued per module", "[constant_pool]") {
+    Module module;
+    auto i32 = cast<IntTypeBase>(module.Types()->GetInt32());
+    auto i64 = cast<IntTypeBase>(module.Types()->GetInt64());
+    ConstantPool* pool = module.Constants();
+
+    const IntegerConst* one = pool->GetInteger(1, i32);
+    REQUIRE(pool->GetInteger(1, i32) == one);
+    REQUIRE(pool->GetInteger(1, i64) != one);
+    REQUIRE(pool->GetInteger(2, i32) != one);
+    REQUIRE(pool->Size() == 3);
+
+    Function* function = module.AddFunction("f", module.Types()->MakeFunctionType());
+    REQUIRE(function->Constants()->GetInteger(1, i32) == one);
+    REQUIRE_THROWS_AS(pool->GetInteger(1ull << 40, i32), IRException);
+    REQUIRE(pool->Size() == 3);
+
+    const UndefConst* undef = pool->GetUndef(i32);
+    REQUIRE(pool->GetUndef(i32) == undef);
+    REQUIRE(pool->GetUndef(i64) != undef);
+    REQUIRE(isa<ConstValue>(undef));
+    REQUIRE(pool->Size() == 5);
+}
+
+}  // namespace bier_tests
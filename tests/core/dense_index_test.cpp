@@ -0,0 +1,68 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/core/module.h>
+
+using namespace bier;
+
+namespace bier_tests {
+
+TEST_CASE("Values and operations are numbered densely per function", "[dense_index]") {
+    Module module;
+    const Type* i32 = module.Types()->GetInt32();
+    std::vector<const Type*> args = {i32, i32};
+    Function* function = module.AddFunction("f", module.Types()->MakeFunctionType(i32, args));
+    std::uint32_t index = 0;
+    for (auto* arg : function->GetSignature()->Arguments()) {
+        REQUIRE(arg->GetIndex() == index++);
+        arg->SetName("arg" + std::to_string(index));
+    }
+    REQUIRE(function->ValueIndexBound() == 2);
+    // Allocates variables for the arguments, numbered 2 and 3
+    BasicBlock* block = function->CreateBlock("entry");
+    const Variable* x = function->AllocateVariable(Variable::Metadata("x", i32));
+    const Variable* lost = function->AllocateVariable(Variable::Metadata("lost", i32));
+    const Variable* y = function->AllocateVariable(Variable::Metadata("y", i32));
+    REQUIRE(x->GetIndex() == 4);
+    REQUIRE(lost->GetIndex() == 5);
+    REQUIRE(y->GetIndex() == 6);
+    REQUIRE(function->ValueIndexBound() == 7);
+
+    block->Append(function->MakeOperation<BinaryOperation>(function, BinaryOperation::BinOp::ADD,
+                                                           x, x, y));
+    block->Append(function->MakeOperation<BinaryOperation>(function, BinaryOperation::BinOp::ADD,
+                                                           y, y, x));
+    Operation* first = *block->GetOperations().begin();
+    Operation* second = *std::next(block->GetOperations().begin());
+    REQUIRE(first->GetIndex() == 0);
+    REQUIRE(second->GetIndex() == 1);
+    REQUIRE(function->OperationIndexBound() == 2);
+    REQUIRE(block->GetIndex() == 0);
+    REQUIRE(function->BlockIndexBound() == 1);
+
+    SECTION("Renumber closes gaps") {
+        function->Normalize();
+        function->Renumber();
+        REQUIRE(function->ValueIndexBound() == 4);
+        REQUIRE(std::min(x->GetIndex(), y->GetIndex()) == 2);
+        REQUIRE(std::max(x->GetIndex(), y->GetIndex()) == 3);
+        REQUIRE(first->GetIndex() == 0);
+        REQUIRE(second->GetIndex() == 1);
+        REQUIRE(block->GetIndex() == 0);
+    }
+}
+
+}  // namespace bier_tests
@@ -127,4 +127,22 @@ TEST_CASE("Retrive declared func", "[functions_declaration]") {
     REQUIRE_THROWS_AS(module.GetFunction("non-existen"), IRException);
 }
 
+TEST_CASE("Names are interned module-wide", "[functions_declaration]") {
+    Module module;
+    const Type* i32 = module.Types()->GetInt32();
+    Function* first = module.AddFunction("first", module.Types()->MakeFunctionType());
+    Function* second = module.AddFunction("second", module.Types()->MakeFunctionType());
+    first->CreateBlock("entry");
+    second->CreateBlock("entry");
+    const Variable* x = first->AllocateVariable(Variable::Metadata("x", i32));
+    const Variable* other_x = second->AllocateVariable(Variable::Metadata("x", i32));
+
+    REQUIRE(x != other_x);
+    REQUIRE(x->GetSymbol() == other_x->GetSymbol());
+    REQUIRE(module.Symbols()->Find("first") == first->GetSignature()->GetSymbol());
+    REQUIRE(module.GetFunction("second") == second);
+    REQUIRE(!module.HasFunction("third"));
+    REQUIRE(!module.Symbols()->Find("third").has_value());
+}
+
 }  // namespace bier_tests
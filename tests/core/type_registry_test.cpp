@@ -16,6 +16,7 @@
 #include <catch2/catch.hpp>
 #include <bier/core/types_registry.h>
 #include <stdexcept>
+#include <thread>
 
 using namespace bier;
 
@@ -52,4 +53,35 @@ TEST_CASE("Same Function types", "[type_registry]") {
     }
 }
 
+TEST_CASE("Types are interned once across threads", "[type_registry]") {
+    DefaultTypesRegistry registry;
+    constexpr int kThreads = 4;
+    constexpr int kDepth = 200;
+    // Every thread builds the same chains of pointer types and function types
+    std::vector<std::vector<const Type*>> seen(kThreads);
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < kThreads; ++thread) {
+        threads.emplace_back([&, thread] {
+            const Type* type = registry.GetInt32();
+            for (int depth = 0; depth < kDepth; ++depth) {
+                type = registry.GetPtrTo(type);
+                seen[thread].push_back(type);
+                seen[thread].push_back(registry.MakeFunctionType(type, {type, registry.GetInt8()}));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (int thread = 1; thread < kThreads; ++thread) {
+        REQUIRE(seen[thread] == seen[0]);
+    }
+    for (const Type* type : seen[0]) {
+        REQUIRE(registry.Has(type));
+        REQUIRE(registry.IsPtr(type));
+    }
+    REQUIRE(registry.GetPtrTo(registry.GetInt32()) == registry.GetInt32Ptr());
+    REQUIRE(registry.IsPtrCompatibleWith(seen[0][0], registry.GetInt32()));
+}
+
 }  // namespace bier_tests
@@ -0,0 +1,157 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/core/module.h>
+#include <bier/utils/casting.h>
+#include <thread>
+#include <vector>
+
+using namespace bier;
+
+namespace bier_tests {
+
+namespace {
+
+std::size_t CountUses(const Value* value) {
+    auto uses = value->Uses();
+    return std::distance(uses.begin(), uses.end());
+}
+
+}  // namespace
+
+TEST_CASE("Operations register their operands and results", "[use]") {
+    Module module;
+    const Type* i32 = module.Types()->GetInt32();
+    Function* function = module.AddFunction("f", module.Types()->MakeFunctionType());
+    BasicBlock* block = function->CreateBlock("entry");
+    const Variable* x = function->AllocateVariable(Variable::Metadata("x", i32));
+    const Variable* y = function->AllocateVariable(Variable::Metadata("y", i32));
+    const Variable* sum = function->AllocateVariable(Variable::Metadata("sum", i32));
+    const Variable* twice = function->AllocateVariable(Variable::Metadata("twice", i32));
+
+    block->Append(function->MakeOperation<BinaryOperation>(function, BinaryOperation::BinOp::ADD,
+                                                           x, y, sum));
+    block->Append(function->MakeOperation<BinaryOperation>(function, BinaryOperation::BinOp::ADD,
+                                                           sum, sum, twice));
+    Operation* add = *block->GetOperations().begin();
+    Operation* doubled = *std::next(block->GetOperations().begin());
+
+    REQUIRE(x->HasUses());
+    REQUIRE(CountUses(sum) == 2);
+    REQUIRE(sum->GetDefiningOp() == add);
+    REQUIRE(twice->GetDefiningOp() == doubled);
+    REQUIRE(!twice->HasUses());
+    REQUIRE(x->GetDefiningOp() == nullptr);
+    for (const Use* use : sum->Uses()) {
+        REQUIRE(use->GetUser() == doubled);
+    }
+
+    SECTION("Replace all uses") {
+        sum->ReplaceAllUsesWith(x);
+        REQUIRE(!sum->HasUses());
+        REQUIRE(CountUses(x) == 3);
+        REQUIRE(doubled->GetArguments()[0] == x);
+        REQUIRE(doubled->GetArguments()[1] == x);
+    }
+
+    SECTION("Substitution relinks operands") {
+        doubled->SubstituteArguments({y, sum});
+        doubled->SubstituteReturnValue(x);
+        REQUIRE(CountUses(sum) == 1);
+        REQUIRE(CountUses(y) == 2);
+        REQUIRE(twice->GetDefiningOp() == nullptr);
+        REQUIRE(x->GetDefiningOp() == doubled);
+    }
+
+    SECTION("Deleted operations drop their uses") {
+        block->DeleteAt(block->GetIterator(doubled));
+        REQUIRE(!sum->HasUses());
+        REQUIRE(twice->Definitions().Empty());
+        function->Normalize();
+        REQUIRE(function->GetVariables().Size() == 3);
+    }
+}
+
+TEST_CASE("Normalize drops variables that lost their last reference", "[use]") {
+    Module module;
+    const Type* i32 = module.Types()->GetInt32();
+    Function* function = module.AddFunction("f", module.Types()->MakeFunctionType());
+    BasicBlock* block = function->CreateBlock("entry");
+    const Variable* x = function->AllocateVariable(Variable::Metadata("x", i32));
+    const Variable* y = function->AllocateVariable(Variable::Metadata("y", i32));
+    const Variable* sum = function->AllocateVariable(Variable::Metadata("sum", i32));
+    function->AllocateVariable(Variable::Metadata("unused", i32));
+
+    block->Append(function->MakeOperation<BinaryOperation>(function, BinaryOperation::BinOp::ADD,
+                                                           x, y, sum));
+    Operation* add = *block->GetOperations().begin();
+    REQUIRE(x->GetReferenceCount() == 1);
+    REQUIRE(sum->GetReferenceCount() == 1);
+    function->Normalize();
+    REQUIRE(function->GetVariables().Size() == 3);
+
+    // Loses its last reference and gets it back before normalization
+    add->SubstituteArguments({y, y});
+    add->SubstituteArguments({x, x});
+    REQUIRE(x->GetReferenceCount() == 2);
+    REQUIRE(y->GetReferenceCount() == 0);
+    function->Normalize();
+    REQUIRE(function->GetVariables().Size() == 2);
+}
+
+TEST_CASE("Use lists of constants survive concurrent edits of functions", "[use]") {
+    Module module;
+    const auto* i32 = cast<IntTypeBase>(module.Types()->GetInt32());
+    const Value* one = module.Constants()->GetInteger(1, i32);
+    const Value* two = module.Constants()->GetInteger(2, i32);
+    constexpr std::size_t kFunctions = 4;
+    constexpr std::size_t kOperations = 1000;
+
+    std::vector<Function*> functions;
+    for (std::size_t i = 0; i < kFunctions; ++i) {
+        functions.push_back(
+            module.AddFunction("f" + std::to_string(i), module.Types()->MakeFunctionType()));
+    }
+    std::vector<std::vector<OperationPtr>> operations(kFunctions);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < kFunctions; ++i) {
+        threads.emplace_back([&, i] {
+            ConcurrentEditScope scope(&module);
+            Function* function = functions[i];
+            const Variable* sum = function->AllocateVariable(Variable::Metadata("sum", i32));
+            for (std::size_t j = 0; j < kOperations; ++j) {
+                operations[i].push_back(function->MakeOperation<BinaryOperation>(
+                    function, BinaryOperation::BinOp::ADD, one, sum, sum));
+            }
+        });
+    }
+    threads.emplace_back([&] {
+        ConcurrentEditScope scope(&module);
+        for (std::size_t j = 0; j < kOperations; ++j) {
+            one->ReplaceAllUsesWith(two);
+            two->ReplaceAllUsesWith(one);
+        }
+    });
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(CountUses(one) == one->GetReferenceCount());
+    REQUIRE(CountUses(two) == two->GetReferenceCount());
+    REQUIRE(CountUses(one) + CountUses(two) == kFunctions * kOperations);
+}
+
+}  // namespace bier_tests
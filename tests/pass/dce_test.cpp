@@ -0,0 +1,283 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/builder/module_builder.h>
+#include <bier/builder/verifier.h>
+#include <bier/operations/ops.h>
+#include <bier/pass/dce_pass.h>
+#include <bier/pass/pass_manager.h>
+
+using namespace bier;
+
+namespace bier_tests {
+
+namespace {
+
+using Mode = DeadCodeEliminationPass::Mode;
+
+ModulePtr Eliminate(ModulePtr&& module, Mode mode) {
+    DeadCodeEliminationPass pass(mode);
+    pass.Apply(std::move(module));
+    return pass.GetTransformed();
+}
+
+std::size_t CountOps(const Function* function, int opcode) {
+    std::size_t count = 0;
+    for (const BasicBlock* block : function->GetBlocks()) {
+        for (const Operation* op : block->GetOperations()) {
+            count += op->OpCode() == opcode;
+        }
+    }
+    return count;
+}
+
+std::size_t CountOps(const BasicBlock* block) {
+    return block->GetOperations().Size();
+}
+
+struct Diamond {
+    ModulePtr module = std::make_unique<Module>();
+    Function* function = nullptr;
+    BasicBlock* entry = nullptr;
+    BasicBlock* left = nullptr;
+    BasicBlock* right = nullptr;
+    BasicBlock* join = nullptr;
+    const Variable* left_value = nullptr;
+    const Variable* right_value = nullptr;
+
+    // entry: br n < 0, left, right
+    // left:  l = n + 1; br join
+    // right: r = n + 2; br join
+    // join:  ...
+    Diamond() {
+        ModuleBuilder builder(module.get());
+        const Type* i64 = module->Types()->GetInt64();
+        function = builder.CreateFunction("f", i64, {i64});
+        ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+        n->SetName("n");
+        entry = builder.CreateBlock(function, "entry");
+        left = builder.CreateBlock(function, "left");
+        right = builder.CreateBlock(function, "right");
+        join = builder.CreateBlock(function, "join");
+        builder.AttachTo(entry);
+        builder.CreateConditionBranch(builder.CreateSLT(n, builder.CreateInt64Const(0)), left,
+                                      right);
+        builder.AttachTo(left);
+        left_value = builder.CreateAdd(n, builder.CreateInt64Const(1), "l");
+        builder.CreateBranch(join);
+        builder.AttachTo(right);
+        right_value = builder.CreateAdd(n, builder.CreateInt64Const(2), "r");
+        builder.CreateBranch(join);
+        builder.AttachTo(join);
+    }
+};
+
+}  // namespace
+
+TEST_CASE("Unused pure operations are removed", "[dce]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = builder.CreateFunction("f", i64, {i64});
+    ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+    n->SetName("n");
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    builder.AttachTo(entry);
+    const Variable* a = builder.CreateMul(n, n, "a");
+    const Variable* b = builder.CreateAdd(a, n, "b");
+    builder.CreateSDiv(b, n, "unused");
+    const Variable* counter = builder.CreateAssign(builder.CreateInt64Const(0), "counter", true);
+    builder.CreateAdd(counter, builder.CreateInt64Const(1), "counter", true);
+    builder.CreateReturnValue(builder.CreateSub(n, builder.CreateInt64Const(1), "result"));
+
+    module = Eliminate(std::move(module), Mode::USES);
+    // The mutable counter feeds itself, only the aggressive mode sees through that
+    REQUIRE(CountOps(entry) == 4);
+    REQUIRE(CountOps(function, OpCodes::SUB_OP) == 1);
+    REQUIRE(CountOps(function, OpCodes::RETVALUE_OP) == 1);
+    REQUIRE(function->GetVariables().Size() == 2);
+}
+
+TEST_CASE("Memory of local allocations", "[dce]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = builder.CreateFunction("f", i64, {i64});
+    ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+    n->SetName("n");
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    builder.AttachTo(entry);
+    // Loaded and returned
+    const Value* used = builder.CreateAlloc(i64, "used");
+    builder.CreateStore(used, n);
+    // Only stored to, the load is unused
+    const Value* written = builder.CreateAlloc(i64, "written");
+    builder.CreateStore(written, n);
+    builder.CreateLoad(written, i64, "ignored");
+    // Escapes through another allocation
+    const Value* escaping = builder.CreateAlloc(i64, "escaping");
+    builder.CreateStore(escaping, n);
+    const Value* holder = builder.CreateAlloc(module->Types()->GetInt64Ptr(), "holder");
+    builder.CreateStore(holder, escaping);
+    builder.CreateReturnValue(builder.CreateLoad(used, i64, "loaded"));
+
+    module = Eliminate(std::move(module), Mode::USES);
+    // written, its store and its load are gone, holder is never read but escaping is stored
+    REQUIRE(CountOps(function, OpCodes::ALLOC_OP) == 2);
+    REQUIRE(CountOps(function, OpCodes::STORE_OP) == 2);
+    REQUIRE(CountOps(function, OpCodes::LOAD_OP) == 1);
+}
+
+TEST_CASE("Memory noise of SSAPass", "[dce][adce]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = builder.CreateFunction("f", i64, {i64});
+    ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+    n->SetName("n");
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    builder.AttachTo(entry);
+    const Variable* x = builder.CreateAssign(n, "x", true);
+    builder.CreateAdd(x, n, "x", true);
+    const Variable* unused = builder.CreateAssign(n, "unused", true);
+    builder.CreateAdd(unused, n, "unused", true);
+    builder.CreateReturnValue(x);
+
+    // unused is loaded only to be stored back
+    PassManager manager("ssa-memory,dce,adce");
+    module = manager.Run(std::move(module));
+    REQUIRE(manager.GetStatistics()[1].OperationsDelta() == 0);
+    REQUIRE(manager.GetStatistics()[2].OperationsDelta() < 0);
+    // Only x keeps its memory
+    REQUIRE(CountOps(function, OpCodes::ALLOC_OP) == 1);
+}
+
+TEST_CASE("Aggressive mode removes dead branches", "[dce][adce]") {
+    Diamond usual;
+    usual.join->Append(usual.function->MakeOperation<ReturnValueOp>(
+        usual.function, *usual.function->GetSignature()->Arguments().begin()));
+    usual.module = Eliminate(std::move(usual.module), Mode::USES);
+    // The comparison is used by the branch
+    REQUIRE(CountOps(usual.entry) == 2);
+    REQUIRE(CountOps(usual.left) == 1);
+
+    Diamond aggressive;
+    aggressive.join->Append(aggressive.function->MakeOperation<ReturnValueOp>(
+        aggressive.function, *aggressive.function->GetSignature()->Arguments().begin()));
+    aggressive.module = Eliminate(std::move(aggressive.module), Mode::AGGRESSIVE);
+    REQUIRE(CountOps(aggressive.entry) == 1);
+    REQUIRE(aggressive.entry->Successors() == std::vector<BasicBlock*>{aggressive.join});
+    REQUIRE(CountOps(aggressive.left) == 1);
+    REQUIRE(CountOps(aggressive.right) == 1);
+    REQUIRE(aggressive.join->Predecessors().size() == 3);
+}
+
+TEST_CASE("Aggressive mode keeps branches live phis depend on", "[dce][adce]") {
+    Diamond diamond;
+    const Variable* joined =
+        diamond.function->AllocateVariable(Variable::Metadata("p", diamond.left_value->GetType()));
+    diamond.join->Append(diamond.function->MakeOperation<PhiOp>(
+        diamond.function, joined, std::vector<BasicBlock*>{diamond.left, diamond.right},
+        std::vector<const Value*>{diamond.left_value, diamond.right_value}));
+    diamond.join->Append(diamond.function->MakeOperation<ReturnValueOp>(diamond.function, joined));
+
+    diamond.module = Eliminate(std::move(diamond.module), Mode::AGGRESSIVE);
+    REQUIRE(CountOps(diamond.entry) == 2);
+    REQUIRE(CountOps(diamond.left) == 2);
+    REQUIRE(CountOps(diamond.right) == 2);
+    REQUIRE(CountOps(diamond.join) == 2);
+}
+
+TEST_CASE("Aggressive mode removes self-feeding variables and keeps infinite loops",
+          "[dce][adce]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = builder.CreateFunction("f", i64, {i64});
+    ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+    n->SetName("n");
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    BasicBlock* header = builder.CreateBlock(function, "header");
+    BasicBlock* body = builder.CreateBlock(function, "body");
+    BasicBlock* exit = builder.CreateBlock(function, "exit");
+    BasicBlock* spin = builder.CreateBlock(function, "spin");
+    BasicBlock* spin_body = builder.CreateBlock(function, "spin_body");
+    BasicBlock* done = builder.CreateBlock(function, "done");
+
+    // A counting loop whose counter is never read outside of it
+    builder.AttachTo(entry);
+    const Variable* i = builder.CreateAssign(builder.CreateInt64Const(0), "i", true);
+    builder.CreateBranch(header);
+    builder.AttachTo(header);
+    builder.CreateConditionBranch(builder.CreateSLT(i, n), body, exit);
+    builder.AttachTo(body);
+    builder.CreateAdd(i, builder.CreateInt64Const(1), "i", true);
+    builder.CreateBranch(header);
+    // exit either returns or never terminates
+    builder.AttachTo(exit);
+    const Variable* negative = builder.CreateSLT(n, builder.CreateInt64Const(0));
+    builder.CreateConditionBranch(negative, spin, done);
+    builder.AttachTo(spin);
+    builder.CreateConditionBranch(builder.CreateSLT(n, builder.CreateInt64Const(-1)), spin_body,
+                                  spin);
+    builder.AttachTo(spin_body);
+    builder.CreateBranch(spin);
+    builder.AttachTo(done);
+    builder.CreateReturnValue(n);
+
+    module = Eliminate(std::move(module), Mode::AGGRESSIVE);
+    REQUIRE(CountOps(function, OpCodes::ASSIGN_OP) == 0);
+    REQUIRE(CountOps(function, OpCodes::ADD_OP) == 0);
+    // The loop header branch is gone, the ones leading to and inside the infinite loop stay
+    REQUIRE(header->Successors() == std::vector<BasicBlock*>{exit});
+    REQUIRE(CountOps(function, OpCodes::COND_BRANCH_OP) == 2);
+    REQUIRE(CountOps(function, OpCodes::LT_OP) == 2);
+}
+
+TEST_CASE("Aggressive mode keeps live loops", "[dce][adce]") {
+    for (const char* pipeline : {"ssa-memory,adce", "ssa,adce"}) {
+        auto module = std::make_unique<Module>();
+        ModuleBuilder builder(module.get());
+        const Type* i64 = module->Types()->GetInt64();
+        Function* function = builder.CreateFunction("sum", i64, {i64});
+        ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+        n->SetName("n");
+        BasicBlock* entry = builder.CreateBlock(function, "entry");
+        BasicBlock* header = builder.CreateBlock(function, "header");
+        BasicBlock* body = builder.CreateBlock(function, "body");
+        BasicBlock* exit = builder.CreateBlock(function, "exit");
+        builder.AttachTo(entry);
+        const Variable* i = builder.CreateAssign(builder.CreateInt64Const(0), "i", true);
+        const Variable* sum = builder.CreateAssign(builder.CreateInt64Const(0), "sum", true);
+        builder.CreateBranch(header);
+        builder.AttachTo(header);
+        builder.CreateConditionBranch(builder.CreateSLT(i, n), body, exit);
+        builder.AttachTo(body);
+        builder.CreateAdd(sum, i, "sum", true);
+        builder.CreateAdd(i, builder.CreateInt64Const(1), "i", true);
+        builder.CreateBranch(header);
+        builder.AttachTo(exit);
+        builder.CreateReturnValue(sum);
+
+        PassManager manager(pipeline);
+        module = manager.Run(std::move(module));
+        REQUIRE(manager.GetStatistics()[1].OperationsDelta() == 0);
+        Verifier verifier(module->Types());
+        REQUIRE_NOTHROW(verifier.Verify(function));
+    }
+}
+
+}  // namespace bier_tests
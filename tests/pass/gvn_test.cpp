@@ -0,0 +1,187 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/builder/module_builder.h>
+#include <bier/builder/verifier.h>
+#include <bier/operations/ops.h>
+#include <bier/pass/gvn_pass.h>
+#include <bier/pass/pass_manager.h>
+
+using namespace bier;
+
+namespace bier_tests {
+
+namespace {
+
+ModulePtr Number(ModulePtr&& module,
+                 std::uint32_t budget = GlobalValueNumberingPass::kNoBudget) {
+    GlobalValueNumberingPass pass(budget);
+    pass.Apply(std::move(module));
+    return pass.GetTransformed();
+}
+
+std::size_t CountOps(const Function* function, int opcode) {
+    std::size_t count = 0;
+    for (const BasicBlock* block : function->GetBlocks()) {
+        for (const Operation* op : block->GetOperations()) {
+            count += op->OpCode() == opcode;
+        }
+    }
+    return count;
+}
+
+const Operation* Last(const BasicBlock* block) {
+    return *std::prev(block->GetOperations().end());
+}
+
+}  // namespace
+
+TEST_CASE("Redundant expressions in a block", "[gvn]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = builder.CreateFunction("f", i64, {i64, i64});
+    auto arguments = function->GetSignature()->Arguments().begin();
+    ArgumentValue* n = *arguments;
+    ++arguments;
+    ArgumentValue* m = *arguments;
+    n->SetName("n");
+    m->SetName("m");
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    builder.AttachTo(entry);
+    const Variable* x = builder.CreateAdd(n, m, "x");
+    const Variable* y = builder.CreateAdd(m, n, "y");
+    const Variable* d = builder.CreateSub(n, m, "d");
+    const Variable* e = builder.CreateSub(m, n, "e");
+    const Variable* product = builder.CreateMul(x, y, "product");
+    builder.CreateReturnValue(builder.CreateAdd(product, builder.CreateMul(d, e, "de"), "r"));
+
+    module = Number(std::move(module));
+    // Subtraction does not commute
+    REQUIRE(CountOps(function, OpCodes::ADD_OP) == 2);
+    REQUIRE(CountOps(function, OpCodes::SUB_OP) == 2);
+    REQUIRE(x->GetReferenceCount() == 3);
+    REQUIRE(y->GetReferenceCount() == 0);
+    REQUIRE(product->GetDefiningOp()->GetArguments()[1] == x);
+    Verifier verifier(module->Types());
+    REQUIRE_NOTHROW(verifier.Verify(function));
+}
+
+TEST_CASE("Expressions of dominating blocks are reused", "[gvn]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = builder.CreateFunction("f", i64, {i64});
+    ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+    n->SetName("n");
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    BasicBlock* left = builder.CreateBlock(function, "left");
+    BasicBlock* right = builder.CreateBlock(function, "right");
+    BasicBlock* join = builder.CreateBlock(function, "join");
+    builder.AttachTo(entry);
+    const Variable* one = builder.CreateAdd(n, builder.CreateInt64Const(1), "one");
+    builder.CreateConditionBranch(builder.CreateSLT(n, builder.CreateInt64Const(0)), left,
+                                  right);
+    builder.AttachTo(left);
+    builder.CreateReturnValue(builder.CreateAdd(n, builder.CreateInt64Const(1), "left_one"));
+    builder.AttachTo(right);
+    const Variable* two = builder.CreateAdd(n, builder.CreateInt64Const(2), "two");
+    builder.CreateBranch(join);
+    builder.AttachTo(join);
+    const Variable* join_two = builder.CreateAdd(n, builder.CreateInt64Const(2), "join_two");
+    const Variable* join_one = builder.CreateAdd(n, builder.CreateInt64Const(1), "join_one");
+    builder.CreateReturnValue(builder.CreateMul(builder.CreateMul(two, join_two, "a"), join_one,
+                                                "b"));
+
+    module = Number(std::move(module));
+    REQUIRE(Last(left)->GetArguments()[0] == one);
+    // right dominates join, entry does as well
+    REQUIRE(join_two->GetReferenceCount() == 0);
+    REQUIRE(join_one->GetReferenceCount() == 0);
+    REQUIRE(CountOps(function, OpCodes::ADD_OP) == 2);
+    REQUIRE(right->GetOperations().Size() == 2);
+    Verifier verifier(module->Types());
+    REQUIRE_NOTHROW(verifier.Verify(function));
+}
+
+TEST_CASE("Siblings in the dominator tree do not share expressions", "[gvn]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = builder.CreateFunction("f", i64, {i64});
+    ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+    n->SetName("n");
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    BasicBlock* left = builder.CreateBlock(function, "left");
+    BasicBlock* right = builder.CreateBlock(function, "right");
+    builder.AttachTo(entry);
+    builder.CreateConditionBranch(builder.CreateSLT(n, builder.CreateInt64Const(0)), left,
+                                  right);
+    builder.AttachTo(left);
+    builder.CreateReturnValue(builder.CreateMul(n, n, "left_square"));
+    builder.AttachTo(right);
+    builder.CreateReturnValue(builder.CreateMul(n, n, "right_square"));
+
+    module = Number(std::move(module));
+    REQUIRE(CountOps(function, OpCodes::MULT_OP) == 2);
+}
+
+TEST_CASE("Mutable variables are not numbered", "[gvn]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = builder.CreateFunction("f", i64, {i64});
+    ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+    n->SetName("n");
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    builder.AttachTo(entry);
+    const Variable* counter = builder.CreateAssign(n, "counter", true);
+    const Variable* before = builder.CreateAdd(counter, builder.CreateInt64Const(1), "before");
+    builder.CreateAssign(builder.CreateInt64Const(5), counter);
+    const Variable* after = builder.CreateAdd(counter, builder.CreateInt64Const(1), "after");
+    builder.CreateReturnValue(builder.CreateSub(before, after, "r"));
+
+    module = Number(std::move(module));
+    REQUIRE(CountOps(function, OpCodes::ADD_OP) == 2);
+}
+
+TEST_CASE("Budget caps numbered operations", "[gvn]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = builder.CreateFunction("f", i64, {i64});
+    ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+    n->SetName("n");
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    builder.AttachTo(entry);
+    const Variable* a = builder.CreateMul(n, n, "a");
+    const Variable* b = builder.CreateMul(n, n, "b");
+    const Variable* c = builder.CreateMul(n, n, "c");
+    builder.CreateReturnValue(builder.CreateAdd(builder.CreateAdd(a, b, "ab"), c, "abc"));
+
+    SECTION("Limited") {
+        module = Number(std::move(module), 2);
+        REQUIRE(CountOps(function, OpCodes::MULT_OP) == 2);
+    }
+    SECTION("Pipeline") {
+        PassManager manager("gvn-budget");
+        module = manager.Run(std::move(module));
+        REQUIRE(CountOps(function, OpCodes::MULT_OP) == 1);
+        REQUIRE(manager.GetStatistics()[0].OperationsDelta() == -2);
+    }
+}
+
+}  // namespace bier_tests
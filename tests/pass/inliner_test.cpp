@@ -0,0 +1,247 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/builder/module_builder.h>
+#include <bier/builder/verifier.h>
+#include <bier/operations/ops.h>
+#include <bier/pass/inliner_pass.h>
+#include <bier/pass/pass_manager.h>
+#include <algorithm>
+
+using namespace bier;
+
+namespace bier_tests {
+
+namespace {
+
+ModulePtr Inline(ModulePtr&& module, std::size_t expected_inlined) {
+    InlinerPass pass;
+    pass.Apply(std::move(module));
+    REQUIRE(pass.GetInlinedCount() == expected_inlined);
+    return pass.GetTransformed();
+}
+
+std::size_t CountOps(const Function* function, int opcode) {
+    std::size_t count = 0;
+    for (const BasicBlock* block : function->GetBlocks()) {
+        for (const Operation* op : block->GetOperations()) {
+            count += op->OpCode() == opcode;
+        }
+    }
+    return count;
+}
+
+const Operation* Last(const BasicBlock* block) {
+    return *std::prev(block->GetOperations().end());
+}
+
+const Operation* ReturnOf(const Function* function) {
+    for (const BasicBlock* block : function->GetBlocks()) {
+        if (block->GetOperations().Size() != 0 && Last(block)->OpCode() == OpCodes::RETVALUE_OP) {
+            return Last(block);
+        }
+    }
+    return nullptr;
+}
+
+Function* MakeFunction(ModuleBuilder* builder, const std::string& name, const Type* type) {
+    Function* function = builder->CreateFunction(name, type, {type});
+    (*function->GetSignature()->Arguments().begin())->SetName("n");
+    return function;
+}
+
+const Value* ArgumentOf(const Function* function) {
+    return *function->GetSignature()->Arguments().begin();
+}
+
+void Verify(const Module* module, const Function* function) {
+    Verifier verifier(module->Types());
+    REQUIRE_NOTHROW(verifier.Verify(function));
+}
+
+}  // namespace
+
+TEST_CASE("Tiny accessors are inlined", "[inline]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* get = MakeFunction(&builder, "get", i64);
+    builder.AttachTo(builder.CreateBlock(get, "entry"));
+    builder.CreateReturnValue(
+        builder.CreateAdd(ArgumentOf(get), builder.CreateInt64Const(1), "incremented"));
+
+    Function* f = MakeFunction(&builder, "f", i64);
+    builder.AttachTo(builder.CreateBlock(f, "entry"));
+    const Value* a = builder.CreateCall(get, {ArgumentOf(f)}, "a").value();
+    const Value* b = builder.CreateCall(get, {builder.CreateInt64Const(5)}, "b").value();
+    builder.CreateReturnValue(builder.CreateMul(a, b, "product"));
+
+    module = Inline(std::move(module), 2);
+    REQUIRE(CountOps(f, OpCodes::CALL_OP) == 0);
+    REQUIRE(CountOps(f, OpCodes::ADD_OP) == 2);
+    const Operation* product = ReturnOf(f)->GetArguments()[0]->GetDefiningOp();
+    const Operation* left = product->GetArguments()[0]->GetDefiningOp();
+    const Operation* right = product->GetArguments()[1]->GetDefiningOp();
+    REQUIRE(left->GetArguments()[0] == ArgumentOf(f));
+    REQUIRE(right->GetArguments()[0] == builder.CreateInt64Const(5));
+    // The callee is left intact
+    REQUIRE(get->GetBlocks().Size() == 1);
+    REQUIRE(ReturnOf(get)->GetArguments()[0]->GetDefiningOp()->GetArguments()[0] ==
+            ArgumentOf(get));
+    Verify(module.get(), f);
+}
+
+TEST_CASE("Several returns meet in a phi", "[inline]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* abs = MakeFunction(&builder, "abs", i64);
+    BasicBlock* entry = builder.CreateBlock(abs, "entry");
+    BasicBlock* negative = builder.CreateBlock(abs, "negative");
+    BasicBlock* positive = builder.CreateBlock(abs, "positive");
+    builder.AttachTo(entry);
+    const Value* n = ArgumentOf(abs);
+    builder.CreateConditionBranch(builder.CreateSLT(n, builder.CreateInt64Const(0)), negative,
+                                  positive);
+    builder.AttachTo(negative);
+    builder.CreateReturnValue(builder.CreateSub(builder.CreateInt64Const(0), n, "negated"));
+    builder.AttachTo(positive);
+    builder.CreateReturnValue(n);
+
+    // f(n) = abs(n) < 10 ? n : abs(n) + 1
+    Function* f = MakeFunction(&builder, "f", i64);
+    BasicBlock* f_entry = builder.CreateBlock(f, "entry");
+    BasicBlock* other = builder.CreateBlock(f, "other");
+    BasicBlock* join = builder.CreateBlock(f, "join");
+    builder.AttachTo(f_entry);
+    const Variable* magnitude = builder.CreateCall(abs, {ArgumentOf(f)}, "magnitude").value();
+    builder.CreateConditionBranch(builder.CreateSLT(magnitude, builder.CreateInt64Const(10)),
+                                  join, other);
+    builder.AttachTo(other);
+    const Variable* incremented =
+        builder.CreateAdd(magnitude, builder.CreateInt64Const(1), "incremented");
+    builder.CreateBranch(join);
+    const Variable* joined = f->AllocateVariable(Variable::Metadata("joined", i64));
+    join->Append(f->MakeOperation<PhiOp>(f, joined, std::vector<BasicBlock*>{f_entry, other},
+                                         std::vector<const Value*>{ArgumentOf(f), incremented}));
+    join->Append(f->MakeOperation<ReturnValueOp>(f, joined));
+
+    module = Inline(std::move(module), 1);
+    REQUIRE(CountOps(f, OpCodes::CALL_OP) == 0);
+    const auto* merge = static_cast<const PhiOp*>(magnitude->GetDefiningOp());
+    REQUIRE(magnitude->GetDefiningOp()->OpCode() == OpCodes::PHI_OP);
+    REQUIRE(merge->IncomingCount() == 2);
+    REQUIRE(merge->GetBlock()->Predecessors().size() == 2);
+
+    const auto* phi = static_cast<const PhiOp*>(*join->GetOperations().begin());
+    const auto& predecessors = join->Predecessors();
+    for (std::size_t i = 0; i < phi->IncomingCount(); ++i) {
+        REQUIRE(std::find(predecessors.begin(), predecessors.end(), phi->IncomingBlock(i)) !=
+                predecessors.end());
+    }
+    REQUIRE(phi->IncomingBlock(0) == merge->GetBlock());
+    Verify(module.get(), f);
+}
+
+TEST_CASE("Cost model", "[inline]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    // 29 operations, over the threshold unless a bonus applies
+    Function* big = MakeFunction(&builder, "big", i64);
+    builder.AttachTo(builder.CreateBlock(big, "entry"));
+    const Value* sum = ArgumentOf(big);
+    for (int i = 0; i < 28; ++i) {
+        sum = builder.CreateAdd(sum, ArgumentOf(big));
+    }
+    builder.CreateReturnValue(sum);
+
+    Function* cold = MakeFunction(&builder, "cold", i64);
+    builder.AttachTo(builder.CreateBlock(cold, "entry"));
+    builder.CreateReturnValue(builder.CreateCall(big, {ArgumentOf(cold)}).value());
+
+    Function* constant = MakeFunction(&builder, "constant", i64);
+    builder.AttachTo(builder.CreateBlock(constant, "entry"));
+    builder.CreateReturnValue(builder.CreateCall(big, {builder.CreateInt64Const(7)}).value());
+
+    Function* hot = MakeFunction(&builder, "hot", i64);
+    BasicBlock* entry = builder.CreateBlock(hot, "entry");
+    BasicBlock* loop = builder.CreateBlock(hot, "loop");
+    BasicBlock* exit = builder.CreateBlock(hot, "exit");
+    builder.AttachTo(entry);
+    builder.CreateBranch(loop);
+    builder.AttachTo(loop);
+    const Variable* value = builder.CreateCall(big, {ArgumentOf(hot)}, "value").value();
+    builder.CreateConditionBranch(builder.CreateSLT(value, builder.CreateInt64Const(0)), loop,
+                                  exit);
+    builder.AttachTo(exit);
+    builder.CreateReturnValue(value);
+
+    module = Inline(std::move(module), 2);
+    REQUIRE(CountOps(cold, OpCodes::CALL_OP) == 1);
+    REQUIRE(CountOps(constant, OpCodes::CALL_OP) == 0);
+    REQUIRE(CountOps(hot, OpCodes::CALL_OP) == 0);
+    Verify(module.get(), hot);
+}
+
+TEST_CASE("Calls within a cycle are kept", "[inline]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    // countdown(n) = n == 0 ? 0 : countdown(n - 1)
+    Function* countdown = MakeFunction(&builder, "countdown", i64);
+    BasicBlock* entry = builder.CreateBlock(countdown, "entry");
+    BasicBlock* done = builder.CreateBlock(countdown, "done");
+    BasicBlock* again = builder.CreateBlock(countdown, "again");
+    builder.AttachTo(entry);
+    const Value* n = ArgumentOf(countdown);
+    builder.CreateConditionBranch(builder.CreateEQ(n, builder.CreateInt64Const(0)), done, again);
+    builder.AttachTo(done);
+    builder.CreateReturnValue(builder.CreateInt64Const(0));
+    builder.AttachTo(again);
+    builder.CreateReturnValue(
+        builder.CreateCall(countdown, {builder.CreateSub(n, builder.CreateInt64Const(1))})
+            .value());
+
+    Function* f = MakeFunction(&builder, "f", i64);
+    builder.AttachTo(builder.CreateBlock(f, "entry"));
+    builder.CreateReturnValue(builder.CreateCall(countdown, {ArgumentOf(f)}).value());
+
+    module = Inline(std::move(module), 1);
+    REQUIRE(CountOps(countdown, OpCodes::CALL_OP) == 1);
+    REQUIRE(CountOps(f, OpCodes::CALL_OP) == 1);
+    Verify(module.get(), f);
+}
+
+TEST_CASE("Inlined constant arguments fold", "[inline]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* triple = MakeFunction(&builder, "triple", i64);
+    builder.AttachTo(builder.CreateBlock(triple, "entry"));
+    builder.CreateReturnValue(builder.CreateMul(ArgumentOf(triple), builder.CreateInt64Const(3)));
+
+    Function* f = MakeFunction(&builder, "f", i64);
+    builder.AttachTo(builder.CreateBlock(f, "entry"));
+    builder.CreateReturnValue(builder.CreateCall(triple, {builder.CreateInt64Const(2)}).value());
+
+    PassManager manager("inline,sccp");
+    module = manager.Run(std::move(module));
+    REQUIRE(ReturnOf(f)->GetArguments()[0] == builder.CreateInt64Const(6));
+    Verify(module.get(), f);
+}
+
+}  // namespace bier_tests
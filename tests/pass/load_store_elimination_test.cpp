@@ -0,0 +1,191 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/builder/module_builder.h>
+#include <bier/builder/verifier.h>
+#include <bier/operations/ops.h>
+#include <bier/pass/load_store_elimination_pass.h>
+#include <bier/pass/pass_manager.h>
+
+using namespace bier;
+
+namespace bier_tests {
+
+namespace {
+
+ModulePtr Eliminate(ModulePtr&& module) {
+    LoadStoreEliminationPass pass;
+    pass.Apply(std::move(module));
+    return pass.GetTransformed();
+}
+
+std::size_t CountOps(const Function* function, int opcode) {
+    std::size_t count = 0;
+    for (const BasicBlock* block : function->GetBlocks()) {
+        for (const Operation* op : block->GetOperations()) {
+            count += op->OpCode() == opcode;
+        }
+    }
+    return count;
+}
+
+const Operation* Last(const BasicBlock* block) {
+    return *std::prev(block->GetOperations().end());
+}
+
+}  // namespace
+
+TEST_CASE("Memory form of mutable variables", "[lse]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = builder.CreateFunction("f", i64, {i64});
+    ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+    n->SetName("n");
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    builder.AttachTo(entry);
+    const Variable* x = builder.CreateAssign(n, "x", true);
+    builder.CreateAdd(x, builder.CreateInt64Const(1), "x", true);
+    builder.CreateMul(x, x, "x", true);
+    builder.CreateReturnValue(x);
+
+    PassManager manager("ssa-memory,lse");
+    module = manager.Run(std::move(module));
+    REQUIRE(CountOps(function, OpCodes::LOAD_OP) == 0);
+    REQUIRE(CountOps(function, OpCodes::STORE_OP) == 0);
+    const Operation* square = Last(entry)->GetArguments()[0]->GetDefiningOp();
+    REQUIRE(square->OpCode() == OpCodes::MULT_OP);
+    const Value* incremented = square->GetArguments()[0];
+    REQUIRE(square->GetArguments()[1] == incremented);
+    const Operation* assign = incremented->GetDefiningOp()->GetArguments()[0]->GetDefiningOp();
+    REQUIRE(assign->OpCode() == OpCodes::ASSIGN_OP);
+    REQUIRE(assign->GetArguments()[0] == n);
+    Verifier verifier(module->Types());
+    REQUIRE_NOTHROW(verifier.Verify(function));
+}
+
+TEST_CASE("Values meet across blocks", "[lse]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = builder.CreateFunction("f", i64, {i64});
+    ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+    n->SetName("n");
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    BasicBlock* left = builder.CreateBlock(function, "left");
+    BasicBlock* right = builder.CreateBlock(function, "right");
+    BasicBlock* join = builder.CreateBlock(function, "join");
+    builder.AttachTo(entry);
+    const Value* p = builder.CreateAlloc(i64, "p");
+    const Value* q = builder.CreateAlloc(i64, "q");
+    builder.CreateStore(p, n);
+    builder.CreateStore(q, n);
+    builder.CreateConditionBranch(builder.CreateSLT(n, builder.CreateInt64Const(0)), left,
+                                  right);
+    builder.AttachTo(left);
+    builder.CreateStore(q, builder.CreateInt64Const(1));
+    builder.CreateBranch(join);
+    builder.AttachTo(right);
+    builder.CreateBranch(join);
+    builder.AttachTo(join);
+    const Variable* a = builder.CreateLoad(p, i64, "a");
+    const Variable* b = builder.CreateLoad(q, i64, "b");
+    const Variable* sum = builder.CreateAdd(a, b, "sum");
+    builder.CreateReturnValue(sum);
+
+    module = Eliminate(std::move(module));
+    REQUIRE(sum->GetDefiningOp()->GetArguments()[0] == n);
+    REQUIRE(sum->GetDefiningOp()->GetArguments()[1] == b);
+    REQUIRE(CountOps(function, OpCodes::LOAD_OP) == 1);
+    // Nothing loads from p anymore
+    REQUIRE(CountOps(function, OpCodes::STORE_OP) == 2);
+    Verifier verifier(module->Types());
+    REQUIRE_NOTHROW(verifier.Verify(function));
+}
+
+TEST_CASE("Stores read around a loop stay", "[lse]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = builder.CreateFunction("f", i64, {i64});
+    ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+    n->SetName("n");
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    BasicBlock* header = builder.CreateBlock(function, "header");
+    BasicBlock* body = builder.CreateBlock(function, "body");
+    BasicBlock* exit = builder.CreateBlock(function, "exit");
+    builder.AttachTo(entry);
+    const Value* p = builder.CreateAlloc(i64, "p");
+    builder.CreateStore(p, builder.CreateInt64Const(0));
+    builder.CreateBranch(header);
+    builder.AttachTo(header);
+    const Variable* i = builder.CreateLoad(p, i64, "i");
+    builder.CreateConditionBranch(builder.CreateSLT(i, n), body, exit);
+    builder.AttachTo(body);
+    builder.CreateStore(p, builder.CreateAdd(i, builder.CreateInt64Const(1), "next"));
+    builder.CreateBranch(header);
+    builder.AttachTo(exit);
+    builder.CreateReturnValue(i);
+
+    module = Eliminate(std::move(module));
+    REQUIRE(CountOps(function, OpCodes::LOAD_OP) == 1);
+    REQUIRE(CountOps(function, OpCodes::STORE_OP) == 2);
+}
+
+TEST_CASE("Escaping allocations are left alone", "[lse]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = builder.CreateFunction("f", i64, {i64});
+    ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+    n->SetName("n");
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    builder.AttachTo(entry);
+    const Value* p = builder.CreateAlloc(i64, "p");
+    const Value* holder = builder.CreateAlloc(module->Types()->GetPtrTo(i64), "holder");
+    builder.CreateStore(p, n);
+    builder.CreateStore(holder, p);
+    builder.CreateReturnValue(builder.CreateLoad(p, i64, "x"));
+
+    module = Eliminate(std::move(module));
+    REQUIRE(CountOps(function, OpCodes::LOAD_OP) == 1);
+    // The holder itself is never read
+    REQUIRE(CountOps(function, OpCodes::STORE_OP) == 1);
+    REQUIRE(Last(entry)->GetArguments()[0]->GetDefiningOp()->OpCode() == OpCodes::LOAD_OP);
+}
+
+TEST_CASE("Narrower stores keep wider ones", "[lse]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = builder.CreateFunction("f", i64, {i64});
+    ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+    n->SetName("n");
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    builder.AttachTo(entry);
+    const Value* p = builder.CreateAlloc(module->AddAnnonymousLayout({i64}), "p");
+    builder.CreateStore(p, n);
+    // Overwrites the lowest byte only
+    builder.CreateStore(p, builder.CreateInt8Const(1));
+    builder.CreateReturnValue(builder.CreateLoad(p, i64, "x"));
+
+    module = Eliminate(std::move(module));
+    REQUIRE(CountOps(function, OpCodes::LOAD_OP) == 1);
+    REQUIRE(CountOps(function, OpCodes::STORE_OP) == 2);
+    REQUIRE(Last(entry)->GetArguments()[0]->GetDefiningOp()->OpCode() == OpCodes::LOAD_OP);
+}
+
+}  // namespace bier_tests
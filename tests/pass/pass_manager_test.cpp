@@ -0,0 +1,172 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/analysis/dominator_tree.h>
+#include <bier/builder/module_builder.h>
+#include <bier/core/exceptions.h>
+#include <bier/pass/pass_manager.h>
+#include <bier/pass/thread_pool.h>
+#include <sstream>
+
+using namespace bier;
+
+namespace bier_tests {
+
+namespace {
+
+// sum(n): i = 0; sum = 0; while (i < n) { sum += i; i += 1 } return sum
+// Copies after the first one are named sum1, sum2, ...
+ModulePtr BuildSumModule(int functions = 1) {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    for (int copy = 0; copy < functions; ++copy) {
+        const std::string name = copy == 0 ? "sum" : "sum" + std::to_string(copy);
+        Function* function = builder.CreateFunction(name, i64, {i64});
+        ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+        n->SetName("n");
+        BasicBlock* entry = builder.CreateBlock(function, "entry");
+        BasicBlock* header = builder.CreateBlock(function, "header");
+        BasicBlock* body = builder.CreateBlock(function, "body");
+        BasicBlock* exit = builder.CreateBlock(function, "exit");
+
+        builder.AttachTo(entry);
+        const Variable* i = builder.CreateAssign(builder.CreateInt64Const(0), "i", true);
+        const Variable* sum = builder.CreateAssign(builder.CreateInt64Const(0), "sum", true);
+        builder.CreateBranch(header);
+        builder.AttachTo(header);
+        builder.CreateConditionBranch(builder.CreateSLT(i, n), body, exit);
+        builder.AttachTo(body);
+        builder.CreateAdd(sum, i, "sum", true);
+        builder.CreateAdd(i, builder.CreateInt64Const(1), "i", true);
+        builder.CreateBranch(header);
+        builder.AttachTo(exit);
+        builder.CreateReturnValue(sum);
+    }
+    return module;
+}
+
+class RecordingPass : public TransformPass {
+public:
+    explicit RecordingPass(std::vector<std::string>* log, std::string name)
+        : log_(log), name_(std::move(name)) {}
+
+    void Apply(ModulePtr&& module) override {
+        log_->push_back(name_);
+        module_ = std::move(module);
+    }
+    ModulePtr GetTransformed() override {
+        return std::move(module_);
+    }
+    PreservedAnalyses GetPreservedAnalyses() const override {
+        return PreservedAnalyses::All();
+    }
+
+private:
+    std::vector<std::string>* log_;
+    std::string name_;
+    ModulePtr module_;
+};
+
+}  // namespace
+
+TEST_CASE("Pipelines are parsed from pass names", "[pass_manager]") {
+    std::vector<std::string> log;
+    PassRegistry registry;
+    registry.Register("a", [&] { return std::make_unique<RecordingPass>(&log, "a"); });
+    registry.Register("b", [&] { return std::make_unique<RecordingPass>(&log, "b"); });
+    REQUIRE_THROWS_AS(registry.Register("a", nullptr), IRException);
+
+    PassManager manager(" a, b ,a", registry);
+    REQUIRE(manager.GetPassCount() == 3);
+    auto module = manager.Run(BuildSumModule());
+    REQUIRE(module != nullptr);
+    REQUIRE(log == std::vector<std::string>{"a", "b", "a"});
+    REQUIRE(manager.GetStatistics().size() == 3);
+    REQUIRE(manager.GetStatistics()[1].name == "b");
+
+    REQUIRE(PassManager("", registry).GetPassCount() == 0);
+    REQUIRE_THROWS_AS(PassManager("a,c", registry), IRException);
+    REQUIRE_THROWS_AS(PassManager("a,,b", registry), IRException);
+    REQUIRE_THROWS_AS(PassManager("a,", registry), IRException);
+}
+
+TEST_CASE("Pass statistics and report", "[pass_manager]") {
+    PassManager manager("ssa-memory,ssa");
+    auto module = manager.Run(BuildSumModule());
+    const auto& statistics = manager.GetStatistics();
+    REQUIRE(statistics.size() == 2);
+    REQUIRE(statistics[0].name == "ssa-memory");
+    REQUIRE(statistics[0].operations_before == BuildSumModule()->CountOperations());
+    // Loads and stores replace the mutable variables
+    REQUIRE(statistics[0].OperationsDelta() > 0);
+    REQUIRE(statistics[0].allocated_bytes > 0);
+    REQUIRE(statistics[1].operations_before == statistics[0].operations_after);
+    REQUIRE(statistics[1].operations_after == module->CountOperations());
+
+    std::ostringstream report;
+    manager.PrintReport(report);
+    REQUIRE(report.str().find("ssa-memory") != std::string::npos);
+    REQUIRE(report.str().find("total") != std::string::npos);
+}
+
+TEST_CASE("Passes share the analysis manager", "[pass_manager]") {
+    PassManager manager("ssa");
+    auto module = BuildSumModule();
+    const Function* function = module->GetFunction("sum");
+    auto domtree = manager.GetAnalysisManager().GetResult<DominatorTree>(function);
+    module = manager.Run(std::move(module));
+    // SSA construction inserts phis but keeps the CFG
+    REQUIRE(manager.GetStatistics()[0].OperationsDelta() == 2);
+    REQUIRE(manager.GetAnalysisManager().GetCachedResult<DominatorTree>(function) == domtree);
+}
+
+TEST_CASE("Function passes run in parallel", "[pass_manager]") {
+    const int functions = 200;
+    PassManager serial("ssa-memory,lse,dce,ssa,gvn,gvn");
+    auto expected = serial.Run(BuildSumModule(functions));
+
+    ThreadPool pool(4);
+    PassManager parallel("ssa-memory,lse,dce,ssa,gvn,gvn");
+    parallel.SetThreadPool(&pool);
+    auto module = parallel.Run(BuildSumModule(functions));
+
+    REQUIRE(module->CountOperations() == expected->CountOperations());
+    REQUIRE(module->Constants()->Size() == expected->Constants()->Size());
+    for (int copy = 0; copy < functions; ++copy) {
+        const std::string name = copy == 0 ? "sum" : "sum" + std::to_string(copy);
+        auto blocks = module->GetFunction(name)->GetBlocks();
+        auto expected_blocks = expected->GetFunction(name)->GetBlocks();
+        REQUIRE(blocks.Size() == expected_blocks.Size());
+        for (auto it = blocks.begin(), expected_it = expected_blocks.begin(); it != blocks.end();
+             ++it, ++expected_it) {
+            REQUIRE((*it)->GetOperations().Size() == (*expected_it)->GetOperations().Size());
+        }
+    }
+    // Counters of the clones are merged back
+    for (std::size_t i = 0; i < serial.GetPassCount(); ++i) {
+        REQUIRE(parallel.GetStatistics()[i].counters == serial.GetStatistics()[i].counters);
+    }
+    REQUIRE(serial.GetStatistics()[1].counters.at("forwarded loads") > 0);
+    std::ostringstream report;
+    parallel.PrintReport(report);
+    REQUIRE(report.str().find("forwarded loads: ") != std::string::npos);
+    // Clones share the analysis manager, the second GVN reuses the dominator trees
+    REQUIRE(serial.GetAnalysisManager().GetComputedCount() == functions);
+    REQUIRE(parallel.GetAnalysisManager().GetComputedCount() == functions);
+}
+
+}  // namespace bier_tests
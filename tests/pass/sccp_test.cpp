@@ -0,0 +1,271 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/builder/module_builder.h>
+#include <bier/builder/verifier.h>
+#include <bier/operations/ops.h>
+#include <bier/pass/pass_manager.h>
+#include <bier/pass/sccp_pass.h>
+
+using namespace bier;
+
+namespace bier_tests {
+
+namespace {
+
+ModulePtr Propagate(ModulePtr&& module) {
+    SparseConditionalConstantPropagationPass pass;
+    pass.Apply(std::move(module));
+    return pass.GetTransformed();
+}
+
+const Operation* Last(const BasicBlock* block) {
+    return *std::prev(block->GetOperations().end());
+}
+
+PhiOp* AppendPhi(Function* function, BasicBlock* block, const std::string& name,
+                 const Type* type, const std::vector<BasicBlock*>& incoming) {
+    const Variable* result = function->AllocateVariable(Variable::Metadata(name, type));
+    auto phi = function->MakeOperation<PhiOp>(function, result, incoming);
+    auto* raw = static_cast<PhiOp*>(phi.get());
+    block->Append(std::move(phi));
+    return raw;
+}
+
+}  // namespace
+
+TEST_CASE("Constants flow along taken branches", "[sccp]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = builder.CreateFunction("f", i64, {i64});
+    ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+    n->SetName("n");
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    BasicBlock* left = builder.CreateBlock(function, "left");
+    BasicBlock* right = builder.CreateBlock(function, "right");
+    BasicBlock* join = builder.CreateBlock(function, "join");
+    builder.AttachTo(entry);
+    const Variable* k =
+        builder.CreateAdd(builder.CreateInt64Const(3), builder.CreateInt64Const(4), "k");
+    builder.CreateConditionBranch(builder.CreateSGT(k, builder.CreateInt64Const(5), "flag"), left,
+                                  right);
+    builder.AttachTo(left);
+    const Variable* l = builder.CreateMul(k, builder.CreateInt64Const(2), "l");
+    builder.CreateBranch(join);
+    builder.AttachTo(right);
+    const Variable* r = builder.CreateAdd(n, builder.CreateInt64Const(1), "r");
+    builder.CreateBranch(join);
+    PhiOp* phi = AppendPhi(function, join, "p", i64, {left, right});
+    phi->SetIncomingValue(0, l);
+    phi->SetIncomingValue(1, r);
+    join->Append(function->MakeOperation<ReturnValueOp>(function, phi->GetReturnValue().value()));
+
+    module = Propagate(std::move(module));
+    REQUIRE(function->GetBlocks().Size() == 3);
+    REQUIRE(entry->GetOperations().Size() == 1);
+    REQUIRE(Last(entry)->OpCode() == OpCodes::BRANCH_OP);
+    REQUIRE(entry->Successors() == std::vector<BasicBlock*>{left});
+    REQUIRE(join->GetOperations().Size() == 1);
+    REQUIRE(Last(join)->GetArguments()[0] == builder.CreateInt64Const(14));
+    Verifier verifier(module->Types());
+    REQUIRE_NOTHROW(verifier.Verify(function));
+}
+
+TEST_CASE("Loop invariant phis fold", "[sccp]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = builder.CreateFunction("f", i64, {i64});
+    ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+    n->SetName("n");
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    BasicBlock* header = builder.CreateBlock(function, "header");
+    BasicBlock* body = builder.CreateBlock(function, "body");
+    BasicBlock* exit = builder.CreateBlock(function, "exit");
+    builder.AttachTo(entry);
+    builder.CreateBranch(header);
+    PhiOp* i = AppendPhi(function, header, "i", i64, {entry, body});
+    PhiOp* x = AppendPhi(function, header, "x", i64, {entry, body});
+    const Variable* i_value = i->GetReturnValue().value();
+    const Variable* x_value = x->GetReturnValue().value();
+    builder.AttachTo(header);
+    builder.CreateConditionBranch(builder.CreateSLT(i_value, n, "more"), body, exit);
+    builder.AttachTo(body);
+    const Variable* next = builder.CreateAdd(i_value, builder.CreateInt64Const(1), "next");
+    builder.CreateBranch(header);
+    builder.AttachTo(exit);
+    builder.CreateReturnValue(x_value);
+    i->SetIncomingValue(0, builder.CreateInt64Const(0));
+    i->SetIncomingValue(1, next);
+    x->SetIncomingValue(0, builder.CreateInt64Const(5));
+    x->SetIncomingValue(1, x_value);
+
+    module = Propagate(std::move(module));
+    REQUIRE(function->GetBlocks().Size() == 4);
+    REQUIRE(header->GetOperations().Size() == 3);
+    REQUIRE(Last(exit)->GetArguments()[0] == builder.CreateInt64Const(5));
+    REQUIRE(next->GetDefiningOp() != nullptr);
+    Verifier verifier(module->Types());
+    REQUIRE_NOTHROW(verifier.Verify(function));
+}
+
+TEST_CASE("Phi entries of edges never taken are dropped", "[sccp]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = builder.CreateFunction("f", i64, {i64});
+    ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+    n->SetName("n");
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    BasicBlock* other = builder.CreateBlock(function, "other");
+    BasicBlock* join = builder.CreateBlock(function, "join");
+    builder.AttachTo(entry);
+    builder.CreateConditionBranch(
+        builder.CreateEQ(builder.CreateInt64Const(1), builder.CreateInt64Const(1), "always"), join,
+        other);
+    builder.AttachTo(other);
+    const Variable* incremented = builder.CreateAdd(n, builder.CreateInt64Const(1), "incremented");
+    builder.CreateBranch(join);
+    PhiOp* phi = AppendPhi(function, join, "p", i64, {entry, other});
+    phi->SetIncomingValue(0, n);
+    phi->SetIncomingValue(1, incremented);
+    join->Append(function->MakeOperation<ReturnValueOp>(function, phi->GetReturnValue().value()));
+
+    module = Propagate(std::move(module));
+    REQUIRE(function->GetBlocks().Size() == 2);
+    REQUIRE(phi->IncomingCount() == 1);
+    REQUIRE(phi->IncomingBlock(0) == entry);
+    REQUIRE(phi->IncomingValue(0) == n);
+    REQUIRE(!incremented->HasUses());
+    Verifier verifier(module->Types());
+    REQUIRE_NOTHROW(verifier.Verify(function));
+}
+
+TEST_CASE("Operations that cannot be evaluated stay", "[sccp]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = builder.CreateFunction("f", i64, {i64});
+    ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+    n->SetName("n");
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    builder.AttachTo(entry);
+    const Variable* zero = builder.CreateSub(n, n, "zero");
+    const Variable* quotient = builder.CreateSDiv(builder.CreateInt64Const(1),
+                                                  builder.CreateInt64Const(0), "quotient");
+    const Variable* sum = builder.CreateAdd(quotient, builder.CreateInt64Const(1), "sum");
+    builder.CreateReturnValue(builder.CreateAdd(sum, zero, "r"));
+
+    module = Propagate(std::move(module));
+    REQUIRE(entry->GetOperations().Size() == 5);
+}
+
+TEST_CASE("Constant propagation after SSA construction", "[sccp]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = builder.CreateFunction("f", i64, {i64});
+    ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+    n->SetName("n");
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    BasicBlock* fast = builder.CreateBlock(function, "fast");
+    BasicBlock* slow = builder.CreateBlock(function, "slow");
+    BasicBlock* exit = builder.CreateBlock(function, "exit");
+    builder.AttachTo(entry);
+    const Variable* mode = builder.CreateAssign(builder.CreateInt64Const(1), "mode", true);
+    const Variable* result = builder.CreateAssign(n, "result", true);
+    builder.CreateConditionBranch(builder.CreateEQ(mode, builder.CreateInt64Const(1), "is_fast"),
+                                  fast, slow);
+    builder.AttachTo(fast);
+    builder.CreateAssign(builder.CreateInt64Const(0), result);
+    builder.CreateBranch(exit);
+    builder.AttachTo(slow);
+    builder.CreateAssign(builder.CreateMul(n, n, "square"), result);
+    builder.CreateBranch(exit);
+    builder.AttachTo(exit);
+    builder.CreateReturnValue(result);
+
+    PassManager manager("ssa,sccp");
+    module = manager.Run(std::move(module));
+    REQUIRE(function->GetBlocks().Size() == 3);
+    REQUIRE(Last(exit)->GetArguments()[0] == builder.CreateInt64Const(0));
+    Verifier verifier(module->Types());
+    REQUIRE_NOTHROW(verifier.Verify(function));
+}
+
+TEST_CASE("Branches on values defined only on dead paths keep both successors", "[sccp]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = builder.CreateFunction("f", i64, {i64});
+    ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+    n->SetName("n");
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    BasicBlock* never = builder.CreateBlock(function, "never");
+    BasicBlock* join = builder.CreateBlock(function, "join");
+    BasicBlock* left = builder.CreateBlock(function, "left");
+    BasicBlock* right = builder.CreateBlock(function, "right");
+    builder.AttachTo(entry);
+    builder.CreateConditionBranch(builder.CreateInt1Const(false), never, join);
+    builder.AttachTo(never);
+    const Variable* flag = builder.CreateSLT(n, builder.CreateInt64Const(0), "flag");
+    builder.CreateBranch(join);
+    builder.AttachTo(join);
+    builder.CreateConditionBranch(flag, left, right);
+    builder.AttachTo(left);
+    builder.CreateReturnValue(builder.CreateInt64Const(1));
+    builder.AttachTo(right);
+    builder.CreateReturnValue(builder.CreateInt64Const(2));
+
+    module = Propagate(std::move(module));
+    REQUIRE(function->GetBlocks().Size() == 4);
+    REQUIRE(entry->Successors() == std::vector<BasicBlock*>{join});
+    REQUIRE(join->Successors() == std::vector<BasicBlock*>{left, right});
+    REQUIRE(left->Predecessors().size() == 1);
+    REQUIRE(right->Predecessors().size() == 1);
+}
+
+TEST_CASE("Dead blocks drop a phi entry per edge", "[sccp]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = builder.CreateFunction("f", i64, {i64});
+    ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+    n->SetName("n");
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    BasicBlock* dead = builder.CreateBlock(function, "dead");
+    BasicBlock* join = builder.CreateBlock(function, "join");
+    builder.AttachTo(entry);
+    builder.CreateConditionBranch(builder.CreateInt1Const(true), join, dead);
+    builder.AttachTo(dead);
+    // Both edges lead to the join
+    builder.CreateConditionBranch(builder.CreateSLT(n, builder.CreateInt64Const(0)), join, join);
+    PhiOp* phi = AppendPhi(function, join, "p", i64, {entry, dead, dead});
+    phi->SetIncomingValue(0, builder.CreateInt64Const(1));
+    phi->SetIncomingValue(1, builder.CreateInt64Const(2));
+    phi->SetIncomingValue(2, n);
+    join->Append(function->MakeOperation<ReturnValueOp>(function, phi->GetReturnValue().value()));
+
+    module = Propagate(std::move(module));
+    REQUIRE(function->GetBlocks().Size() == 2);
+    REQUIRE(join->GetOperations().Size() == 1);
+    REQUIRE(Last(join)->GetArguments()[0] == builder.CreateInt64Const(1));
+    Verifier verifier(module->Types());
+    REQUIRE_NOTHROW(verifier.Verify(function));
+}
+
+}  // namespace bier_tests
@@ -0,0 +1,218 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/builder/module_builder.h>
+#include <bier/builder/verifier.h>
+#include <bier/operations/ops.h>
+#include <bier/pass/pass_manager.h>
+#include <bier/pass/simplify_cfg_pass.h>
+
+using namespace bier;
+
+namespace bier_tests {
+
+namespace {
+
+ModulePtr Simplify(ModulePtr&& module) {
+    SimplifyCFGPass pass;
+    pass.Apply(std::move(module));
+    return pass.GetTransformed();
+}
+
+const Operation* Last(const BasicBlock* block) {
+    return *std::prev(block->GetOperations().end());
+}
+
+Function* MakeFunction(ModuleBuilder* builder, const Type* type) {
+    Function* function = builder->CreateFunction("f", type, {type});
+    (*function->GetSignature()->Arguments().begin())->SetName("n");
+    return function;
+}
+
+const PhiOp* AppendPhi(Function* function, BasicBlock* block, const std::string& name,
+                       const std::vector<BasicBlock*>& incoming,
+                       const std::vector<const Value*>& values) {
+    const Variable* result =
+        function->AllocateVariable(Variable::Metadata(name, values.front()->GetType()));
+    auto phi = function->MakeOperation<PhiOp>(function, result, incoming, values);
+    const auto* raw = static_cast<const PhiOp*>(phi.get());
+    block->Append(std::move(phi));
+    block->Append(function->MakeOperation<ReturnValueOp>(function, result));
+    return raw;
+}
+
+void Verify(const Module* module, const Function* function) {
+    Verifier verifier(module->Types());
+    REQUIRE_NOTHROW(verifier.Verify(function));
+}
+
+}  // namespace
+
+TEST_CASE("Chains of jumps collapse", "[simplifycfg]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = MakeFunction(&builder, i64);
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    BasicBlock* first = builder.CreateBlock(function, "first");
+    BasicBlock* second = builder.CreateBlock(function, "second");
+    BasicBlock* last = builder.CreateBlock(function, "last");
+    const Value* n = *function->GetSignature()->Arguments().begin();
+    builder.AttachTo(entry);
+    builder.CreateBranch(first);
+    builder.AttachTo(first);
+    const Variable* a = builder.CreateAdd(n, builder.CreateInt64Const(1), "a");
+    builder.CreateBranch(second);
+    builder.AttachTo(second);
+    builder.CreateBranch(last);
+    builder.AttachTo(last);
+    const Variable* b = builder.CreateMul(a, n, "b");
+    builder.CreateReturnValue(b);
+
+    module = Simplify(std::move(module));
+    REQUIRE(function->GetBlocks().Size() == 1);
+    REQUIRE(*function->GetBlocks().begin() == entry);
+    REQUIRE(entry->GetOperations().Size() == 3);
+    REQUIRE(a->GetDefiningOp()->GetBlock() == entry);
+    REQUIRE(Last(entry)->GetArguments()[0] == b);
+    Verify(module.get(), function);
+}
+
+TEST_CASE("Constant branches fold and unreachable blocks go", "[simplifycfg]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = MakeFunction(&builder, i64);
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    BasicBlock* left = builder.CreateBlock(function, "left");
+    BasicBlock* right = builder.CreateBlock(function, "right");
+    BasicBlock* join = builder.CreateBlock(function, "join");
+    BasicBlock* orphan = builder.CreateBlock(function, "orphan");
+    const Value* n = *function->GetSignature()->Arguments().begin();
+    builder.AttachTo(entry);
+    builder.CreateConditionBranch(builder.CreateInt1Const(true), left, right);
+    builder.AttachTo(left);
+    const Variable* x = builder.CreateAdd(n, builder.CreateInt64Const(1), "x");
+    builder.CreateBranch(join);
+    builder.AttachTo(right);
+    const Variable* y = builder.CreateAdd(n, builder.CreateInt64Const(2), "y");
+    builder.CreateBranch(join);
+    builder.AttachTo(orphan);
+    builder.CreateBranch(orphan);
+    AppendPhi(function, join, "p", {left, right}, {x, y});
+
+    module = Simplify(std::move(module));
+    REQUIRE(function->GetBlocks().Size() == 1);
+    REQUIRE(entry->GetOperations().Size() == 2);
+    REQUIRE(Last(entry)->OpCode() == OpCodes::RETVALUE_OP);
+    REQUIRE(Last(entry)->GetArguments()[0] == x);
+    Verify(module.get(), function);
+}
+
+TEST_CASE("Branches to a single target become jumps", "[simplifycfg]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = MakeFunction(&builder, i64);
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    BasicBlock* exit = builder.CreateBlock(function, "exit");
+    const Value* n = *function->GetSignature()->Arguments().begin();
+    builder.AttachTo(entry);
+    builder.CreateConditionBranch(builder.CreateSLT(n, builder.CreateInt64Const(0)), exit, exit);
+    builder.AttachTo(exit);
+    builder.CreateReturnValue(n);
+
+    module = Simplify(std::move(module));
+    REQUIRE(function->GetBlocks().Size() == 1);
+    REQUIRE(Last(entry)->OpCode() == OpCodes::RETVALUE_OP);
+    REQUIRE(entry->Successors().empty());
+    Verify(module.get(), function);
+}
+
+TEST_CASE("Empty blocks are bypassed", "[simplifycfg]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = MakeFunction(&builder, i64);
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    BasicBlock* negative = builder.CreateBlock(function, "negative");
+    BasicBlock* positive = builder.CreateBlock(function, "positive");
+    BasicBlock* join = builder.CreateBlock(function, "join");
+    const Value* n = *function->GetSignature()->Arguments().begin();
+    builder.AttachTo(entry);
+    builder.CreateConditionBranch(builder.CreateSLT(n, builder.CreateInt64Const(0)), negative,
+                                  positive);
+    builder.AttachTo(negative);
+    const Variable* negated = builder.CreateSub(builder.CreateInt64Const(0), n, "negated");
+    builder.CreateBranch(join);
+    builder.AttachTo(positive);
+    builder.CreateBranch(join);
+    const PhiOp* phi = AppendPhi(function, join, "abs", {negative, positive}, {negated, n});
+    const Variable* result = phi->GetReturnValue().value();
+
+    module = Simplify(std::move(module));
+    REQUIRE(function->GetBlocks().Size() == 3);
+    REQUIRE(Last(entry)->GetSuccessors()[1] == join);
+    const auto* rebuilt = static_cast<const PhiOp*>(result->GetDefiningOp());
+    REQUIRE(rebuilt->IncomingCount() == 2);
+    REQUIRE(rebuilt->IncomingBlock(0) == negative);
+    REQUIRE(rebuilt->IncomingValue(0) == negated);
+    REQUIRE(rebuilt->IncomingBlock(1) == entry);
+    REQUIRE(rebuilt->IncomingValue(1) == n);
+    REQUIRE(join->Predecessors().size() == 2);
+    Verify(module.get(), function);
+}
+
+TEST_CASE("Empty blocks selecting phi values stay", "[simplifycfg]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = MakeFunction(&builder, i64);
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    BasicBlock* forward = builder.CreateBlock(function, "forward");
+    BasicBlock* join = builder.CreateBlock(function, "join");
+    const Value* n = *function->GetSignature()->Arguments().begin();
+    builder.AttachTo(entry);
+    builder.CreateConditionBranch(builder.CreateSLT(n, builder.CreateInt64Const(0)), forward,
+                                  join);
+    builder.AttachTo(forward);
+    builder.CreateBranch(join);
+    AppendPhi(function, join, "p", {forward, entry}, {builder.CreateInt64Const(0), n});
+
+    module = Simplify(std::move(module));
+    REQUIRE(function->GetBlocks().Size() == 3);
+    REQUIRE(join->Predecessors().size() == 2);
+    Verify(module.get(), function);
+}
+
+TEST_CASE("Entry blocks added by SSA construction are merged", "[simplifycfg]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = MakeFunction(&builder, i64);
+    builder.AttachTo(builder.CreateBlock(function, "entry"));
+    builder.CreateReturnValue(builder.CreateAdd(*function->GetSignature()->Arguments().begin(),
+                                                builder.CreateInt64Const(1), "incremented"));
+
+    module = PassManager("ssa-memory").Run(std::move(module));
+    const std::size_t blocks = function->GetBlocks().Size();
+    REQUIRE(blocks == 2);
+    module = PassManager("simplifycfg").Run(std::move(module));
+    REQUIRE(function->GetBlocks().Size() == 1);
+    Verify(module.get(), function);
+}
+
+}  // namespace bier_tests
@@ -0,0 +1,150 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/builder/module_builder.h>
+#include <bier/pass/ssa_construction_pass.h>
+
+using namespace bier;
+
+namespace bier_tests {
+
+namespace {
+
+std::vector<const PhiOp*> Phis(const BasicBlock* block) {
+    std::vector<const PhiOp*> phis;
+    for (const Operation* op : block->GetOperations()) {
+        if (op->OpCode() == OpCodes::PHI_OP) {
+            phis.push_back(static_cast<const PhiOp*>(op));
+        }
+    }
+    return phis;
+}
+
+bool HasMutableVariables(const Function* function) {
+    for (const auto& [name, variable] : function->GetVariables()) {
+        if (variable->IsMutable()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+ModulePtr Construct(ModulePtr&& module) {
+    SSAConstructionPass pass;
+    pass.Apply(std::move(module));
+    return pass.GetTransformed();
+}
+
+}  // namespace
+
+TEST_CASE("Loop counters become phis", "[ssa_construction]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = builder.CreateFunction("sum", i64, {i64});
+    ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+    n->SetName("n");
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    BasicBlock* header = builder.CreateBlock(function, "header");
+    BasicBlock* body = builder.CreateBlock(function, "body");
+    BasicBlock* exit = builder.CreateBlock(function, "exit");
+
+    builder.AttachTo(entry);
+    const Variable* i = builder.CreateAssign(builder.CreateInt64Const(0), "i", true);
+    const Variable* sum = builder.CreateAssign(builder.CreateInt64Const(0), "sum", true);
+    builder.CreateBranch(header);
+    builder.AttachTo(header);
+    builder.CreateConditionBranch(builder.CreateSLT(i, n), body, exit);
+    builder.AttachTo(body);
+    builder.CreateAdd(sum, i, "sum", true);
+    builder.CreateAdd(i, builder.CreateInt64Const(1), "i", true);
+    builder.CreateBranch(header);
+    builder.AttachTo(exit);
+    builder.CreateReturnValue(sum);
+
+    module = Construct(std::move(module));
+
+    REQUIRE(!HasMutableVariables(function));
+    REQUIRE(Phis(entry).empty());
+    REQUIRE(Phis(body).empty());
+    REQUIRE(Phis(exit).empty());
+    auto phis = Phis(header);
+    REQUIRE(phis.size() == 2);
+    for (const PhiOp* phi : phis) {
+        REQUIRE(phi->IncomingCount() == 2);
+        REQUIRE(phi->IncomingBlock(0) == entry);
+        REQUIRE(phi->IncomingBlock(1) == body);
+        REQUIRE(phi->IncomingValue(0)->GetDefiningOp()->GetBlock() == entry);
+        REQUIRE(phi->IncomingValue(1)->GetDefiningOp()->GetBlock() == body);
+    }
+    // The return reads the sum phi
+    const Operation* ret = *exit->GetOperations().begin();
+    const Value* returned = ret->GetArguments()[0];
+    REQUIRE(returned->GetDefiningOp()->OpCode() == OpCodes::PHI_OP);
+    REQUIRE(returned->GetDefiningOp()->GetBlock() == header);
+}
+
+TEST_CASE("Only joins of different definitions get phis", "[ssa_construction]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = builder.CreateFunction("select", i64, {i64});
+    ArgumentValue* n = *function->GetSignature()->Arguments().begin();
+    n->SetName("n");
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    BasicBlock* left = builder.CreateBlock(function, "left");
+    BasicBlock* right = builder.CreateBlock(function, "right");
+    BasicBlock* join = builder.CreateBlock(function, "join");
+
+    builder.AttachTo(entry);
+    const Variable* x = builder.CreateAssign(n, "x", true);
+    const Variable* y = builder.CreateAssign(n, "y", true);
+    builder.CreateConditionBranch(builder.CreateSLT(n, builder.CreateInt64Const(0)), left, right);
+    builder.AttachTo(left);
+    builder.CreateAssign(builder.CreateInt64Const(1), x);
+    builder.CreateBranch(join);
+    builder.AttachTo(right);
+    builder.CreateBranch(join);
+    builder.AttachTo(join);
+    builder.CreateReturnValue(builder.CreateAdd(x, y));
+
+    module = Construct(std::move(module));
+
+    REQUIRE(!HasMutableVariables(function));
+    auto phis = Phis(join);
+    REQUIRE(phis.size() == 1);
+    REQUIRE(phis[0]->IncomingValue(0)->GetDefiningOp()->GetBlock() == left);
+    REQUIRE(phis[0]->IncomingValue(1)->GetDefiningOp()->GetBlock() == entry);
+}
+
+TEST_CASE("Reads before any assignment are undefined", "[ssa_construction]") {
+    auto module = std::make_unique<Module>();
+    ModuleBuilder builder(module.get());
+    const Type* i64 = module->Types()->GetInt64();
+    Function* function = builder.CreateFunction("undefined", i64);
+    BasicBlock* entry = builder.CreateBlock(function, "entry");
+    builder.AttachTo(entry);
+    const Variable* x = function->AllocateVariable(Variable::Metadata("x", i64, true));
+    builder.CreateReturnValue(x);
+
+    module = Construct(std::move(module));
+
+    const Operation* ret = *entry->GetOperations().begin();
+    REQUIRE(isa<UndefConst>(ret->GetArguments()[0]));
+    REQUIRE(function->GetVariables().Size() == 0);
+}
+
+}  // namespace bier_tests
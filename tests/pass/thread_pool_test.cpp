@@ -0,0 +1,78 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/pass/thread_pool.h>
+#include <stdexcept>
+
+using namespace bier;
+
+namespace bier_tests {
+
+TEST_CASE("Every index runs once", "[thread_pool]") {
+    for (std::size_t threads : {1, 2, 4, 7}) {
+        ThreadPool pool(threads);
+        REQUIRE(pool.Size() == threads);
+        for (std::size_t count : {0, 1, 3, 1000}) {
+            std::vector<std::atomic<int>> runs(count);
+            std::vector<std::atomic<int>> by_participant(threads);
+            pool.ParallelFor(count, [&](std::size_t index, std::size_t participant) {
+                runs[index].fetch_add(1);
+                by_participant[participant].fetch_add(1);
+            });
+            for (const auto& run : runs) {
+                REQUIRE(run == 1);
+            }
+            int total = 0;
+            for (const auto& count_by_participant : by_participant) {
+                total += count_by_participant;
+            }
+            REQUIRE(total == static_cast<int>(count));
+        }
+    }
+}
+
+TEST_CASE("Idle threads steal work", "[thread_pool]") {
+    ThreadPool pool(4);
+    // The first slice is slow, the other participants have to steal from it
+    std::atomic<int> done{0};
+    pool.ParallelFor(400, [&](std::size_t index, std::size_t) {
+        if (index < 100) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        done.fetch_add(1);
+    });
+    REQUIRE(done == 400);
+}
+
+TEST_CASE("Exceptions reach the caller", "[thread_pool]") {
+    ThreadPool pool(3);
+    std::atomic<int> runs{0};
+    REQUIRE_THROWS_AS(pool.ParallelFor(100,
+                                       [&](std::size_t index, std::size_t) {
+                                           runs.fetch_add(1);
+                                           if (index == 10) {
+                                               throw std::runtime_error("failed");
+                                           }
+                                       }),
+                      std::runtime_error);
+    REQUIRE(runs <= 100);
+    // The pool stays usable
+    runs = 0;
+    pool.ParallelFor(100, [&](std::size_t, std::size_t) { runs.fetch_add(1); });
+    REQUIRE(runs == 100);
+}
+
+}  // namespace bier_tests
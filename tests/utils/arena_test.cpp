@@ -0,0 +1,72 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/utils/arena.h>
+#include <cstdint>
+
+using namespace bier;
+
+namespace bier_tests {
+
+namespace {
+
+struct Tracked {
+    explicit Tracked(int* counter) : destroyed(counter) {
+    }
+    ~Tracked() {
+        ++*destroyed;
+    }
+
+    int* destroyed;
+};
+
+}  // namespace
+
+TEST_CASE("Aligned allocations", "[arena]") {
+    Arena arena(256);
+    for (std::size_t alignment : {1, 2, 4, 8, 16, 32}) {
+        for (int i = 0; i < 10; ++i) {
+            void* ptr = arena.Allocate(3, alignment);
+            REQUIRE(reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0);
+        }
+    }
+    REQUIRE(arena.AllocatedBytes() == 6 * 10 * 3);
+}
+
+TEST_CASE("Large allocations get own chunk", "[arena]") {
+    Arena arena(256);
+    char* small = static_cast<char*>(arena.Allocate(8, 8));
+    char* large = static_cast<char*>(arena.Allocate(4096, 8));
+    char* next_small = static_cast<char*>(arena.Allocate(8, 8));
+    REQUIRE(next_small == small + 8);
+    large[4095] = 1;
+    REQUIRE(arena.ReservedBytes() >= 256 + 4096);
+}
+
+TEST_CASE("Arena pointers run destructors", "[arena]") {
+    int destroyed = 0;
+    Arena arena;
+    {
+        ArenaPtr<Tracked> first = arena.Make<Tracked>(&destroyed);
+        ArenaPtr<Tracked> second = arena.Make<Tracked>(&destroyed);
+        REQUIRE(first.get() != second.get());
+        first.reset();
+        REQUIRE(destroyed == 1);
+    }
+    REQUIRE(destroyed == 2);
+}
+
+}  // namespace bier_tests
@@ -0,0 +1,73 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/utils/bit_vector.h>
+
+using namespace bier;
+
+namespace bier_tests {
+
+TEST_CASE("Bitvector operations", "[bit_vector]") {
+    DenseBitVector a(130);
+    DenseBitVector b(130, true);
+    REQUIRE(!a.Any());
+    REQUIRE(b.Count() == 130);
+
+    a.Set(0);
+    a.Set(64);
+    a.Set(129);
+    REQUIRE(a.Test(64));
+    REQUIRE(!a.Test(63));
+    REQUIRE(a.Count() == 3);
+    REQUIRE(a.FindNext(0) == 0);
+    REQUIRE(a.FindNext(1) == 64);
+    REQUIRE(a.FindNext(65) == 129);
+    REQUIRE(a.FindNext(130) == DenseBitVector::kNoBit);
+
+    std::vector<std::size_t> bits;
+    a.ForEach([&](std::size_t bit) { bits.push_back(bit); });
+    REQUIRE(bits == std::vector<std::size_t>{0, 64, 129});
+
+    REQUIRE(!b.UnionWith(a));
+    REQUIRE(b.Subtract(a));
+    REQUIRE(b.Count() == 127);
+    REQUIRE(!b.Subtract(a));
+    REQUIRE(b.IntersectWith(a) == true);
+    REQUIRE(!b.Any());
+
+    // gen | (in & ~kill)
+    DenseBitVector gen(130);
+    DenseBitVector in(130, true);
+    DenseBitVector kill(130);
+    gen.Set(5);
+    kill.Set(5);
+    kill.Set(6);
+    DenseBitVector out(130);
+    REQUIRE(out.AssignTransfer(gen, in, kill));
+    REQUIRE(out.Count() == 129);
+    REQUIRE(out.Test(5));
+    REQUIRE(!out.Test(6));
+    REQUIRE(!out.AssignTransfer(gen, in, kill));
+
+    out.Resize(200);
+    REQUIRE(out.Count() == 129);
+    out.SetAll();
+    REQUIRE(out.Count() == 200);
+    out.Resize(3);
+    REQUIRE(out == DenseBitVector(3, true));
+}
+
+}  // namespace bier_tests
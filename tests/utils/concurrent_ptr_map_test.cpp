@@ -0,0 +1,84 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/utils/concurrent_ptr_map.h>
+#include <atomic>
+#include <thread>
+
+using namespace bier;
+
+namespace bier_tests {
+
+namespace {
+
+std::size_t HashOf(const int* key) {
+    return reinterpret_cast<std::uintptr_t>(key);
+}
+
+}  // namespace
+
+TEST_CASE("Lookups after growth", "[concurrent_ptr_map]") {
+    std::vector<int> keys(1000);
+    std::vector<int> values(keys.size());
+    ConcurrentPtrMap<const int*, const int*> map;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        REQUIRE(map.Find(HashOf(&keys[i]), &keys[i]) == nullptr);
+        map.Insert(HashOf(&keys[i]), &keys[i], &values[i]);
+    }
+    REQUIRE(map.Size() == keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        REQUIRE(map.Find(HashOf(&keys[i]), &keys[i]) == &values[i]);
+    }
+    // Colliding hashes are told apart by the predicate
+    ConcurrentPtrMap<const int*, const int*> colliding;
+    for (std::size_t i = 0; i < 100; ++i) {
+        colliding.Insert(7, &keys[i], &values[i]);
+    }
+    for (std::size_t i = 0; i < 100; ++i) {
+        REQUIRE(colliding.FindIf(7, [&](const int* key) { return key == &keys[i]; }) ==
+                &values[i]);
+    }
+}
+
+TEST_CASE("Lookups race with insertions", "[concurrent_ptr_map]") {
+    std::vector<int> keys(20000);
+    ConcurrentPtrMap<const int*, const int*> map;
+    std::atomic<std::size_t> inserted{0};
+    std::atomic<bool> failed{false};
+    std::vector<std::thread> readers;
+    for (int reader = 0; reader < 3; ++reader) {
+        readers.emplace_back([&] {
+            while (inserted.load() < keys.size()) {
+                const std::size_t known = inserted.load();
+                for (std::size_t i = 0; i < known; i += 97) {
+                    if (map.Find(HashOf(&keys[i]), &keys[i]) != &keys[i]) {
+                        failed = true;
+                    }
+                }
+            }
+        });
+    }
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        map.Insert(HashOf(&keys[i]), &keys[i], &keys[i]);
+        inserted.store(i + 1);
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    REQUIRE(!failed);
+}
+
+}  // namespace bier_tests
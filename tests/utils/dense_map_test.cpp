@@ -0,0 +1,71 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/utils/dense_map.h>
+
+using namespace bier;
+
+namespace bier_tests {
+
+namespace {
+
+struct Indexed {
+    std::uint32_t index = kNoDenseIndex;
+
+    std::uint32_t GetIndex() const {
+        return index;
+    }
+};
+
+}  // namespace
+
+TEST_CASE("Dense maps", "[dense_map]") {
+    const Indexed first{0};
+    const Indexed second{5};
+    const Indexed unnumbered;
+
+    DenseIndexMap<Indexed, int> values;
+    REQUIRE(values.Insert(&first, 1));
+    REQUIRE(!values.Insert(&first, 2));
+    values[&second] = 3;
+    REQUIRE(values.Has(&first));
+    REQUIRE(!values.Has(&unnumbered));
+    REQUIRE(values.At(&first) == 1);
+    REQUIRE(values.At(&second) == 3);
+    REQUIRE(values.Size() == 2);
+    values.Erase(&first);
+    REQUIRE(!values.Has(&first));
+    REQUIRE(values.Size() == 1);
+    values.Clear();
+    REQUIRE(!values.Has(&second));
+    REQUIRE(values.Size() == 0);
+}
+
+TEST_CASE("Dense sets", "[dense_map]") {
+    const Indexed first{0};
+    const Indexed second{5};
+    const Indexed unnumbered;
+
+    DenseIndexSet<Indexed> set;
+    set.Insert(&second);
+    REQUIRE(set.Has(&second));
+    REQUIRE(!set.Has(&first));
+    REQUIRE(!set.Has(&unnumbered));
+    set.Erase(&second);
+    REQUIRE(!set.Has(&second));
+}
+
+}  // namespace bier_tests
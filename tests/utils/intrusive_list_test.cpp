@@ -0,0 +1,93 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/utils/intrusive_list.h>
+#include <vector>
+
+using namespace bier;
+
+namespace bier_tests {
+
+namespace {
+
+struct Node : public IntrusiveDListNode<Node> {
+    explicit Node(int _value) : value(_value) {
+    }
+
+    int value;
+};
+
+using List = IntrusiveDList<Node>;
+
+std::vector<int> Values(const List& list) {
+    std::vector<int> values;
+    for (const Node* node : list) {
+        values.push_back(node->value);
+    }
+    return values;
+}
+
+}  // namespace
+
+TEST_CASE("Insert and erase", "[intrusive_list]") {
+    List list;
+    list.PushBack(std::make_unique<Node>(1));
+    list.PushBack(std::make_unique<Node>(3));
+    list.Insert(std::next(list.begin()), std::make_unique<Node>(2));
+    list.PushFront(std::make_unique<Node>(0));
+    REQUIRE(Values(list) == std::vector<int>{0, 1, 2, 3});
+    REQUIRE(list.size() == 4);
+
+    auto next = list.Erase(std::next(list.begin()));
+    REQUIRE(next->value == 2);
+    REQUIRE(Values(list) == std::vector<int>{0, 2, 3});
+    REQUIRE((*--list.end())->value == 3);
+
+    auto removed = list.Remove(list.begin());
+    REQUIRE(removed->value == 0);
+    REQUIRE(removed->Next() == nullptr);
+    REQUIRE(Values(list) == std::vector<int>{2, 3});
+}
+
+TEST_CASE("Splice between lists", "[intrusive_list]") {
+    List first;
+    List second;
+    for (int i = 0; i < 4; ++i) {
+        first.PushBack(std::make_unique<Node>(i));
+        second.PushBack(std::make_unique<Node>(10 + i));
+    }
+    second.Splice(std::next(second.begin()), first, std::next(first.begin()), --first.end());
+    REQUIRE(Values(first) == std::vector<int>{0, 3});
+    REQUIRE(Values(second) == std::vector<int>{10, 1, 2, 11, 12, 13});
+    REQUIRE(first.size() == 2);
+    REQUIRE(second.size() == 6);
+
+    second.Splice(second.end(), first, first.begin(), first.end());
+    REQUIRE(first.empty());
+    REQUIRE(first.size() == 0);
+    REQUIRE(Values(second) == std::vector<int>{10, 1, 2, 11, 12, 13, 0, 3});
+    REQUIRE(second.back()->value == 3);
+    REQUIRE(second.size() == 8);
+
+    // Sizes stay right when lists change between a splice and the next size() call
+    first.Splice(first.end(), second, second.begin(), std::next(second.begin(), 3));
+    first.PushBack(std::make_unique<Node>(4));
+    second.Erase(second.begin());
+    REQUIRE(first.size() == 4);
+    REQUIRE(second.size() == 4);
+}
+
+}  // namespace bier_tests
@@ -0,0 +1,40 @@
+/*
+   Copyright 2019 Igor Kholopov
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <catch2/catch.hpp>
+#include <bier/utils/symbol_table.h>
+
+using namespace bier;
+
+namespace bier_tests {
+
+TEST_CASE("Interning", "[symbol_table]") {
+    SymbolTable table;
+    Symbol foo = table.Intern("foo");
+    Symbol bar = table.Intern(std::string("bar"));
+    REQUIRE(foo != bar);
+    REQUIRE(table.Intern("foo") == foo);
+    REQUIRE(foo.Str() == "foo");
+    REQUIRE(Symbol::Hash()(foo) != Symbol::Hash()(bar));
+
+    REQUIRE(table.Find("bar") == bar);
+    REQUIRE(!table.Find("baz").has_value());
+    REQUIRE(table.Size() == 2);
+
+    REQUIRE(table.Intern("") == Symbol());
+    REQUIRE(Symbol().Str().empty());
+}
+
+}  // namespace bier_tests